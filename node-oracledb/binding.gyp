@@ -23,6 +23,7 @@
              "src/njsSodaDocument.c",
              "src/njsSodaOperation.c",
              "src/njsSubscription.c",
+             "src/njsThreadPool.c",
              "src/njsUtils.c",
              "src/njsVariable.c",
              "odpi/src/dpiConn.c",
@@ -55,6 +56,7 @@
              "odpi/src/dpiSodaDocCursor.c",
              "odpi/src/dpiStmt.c",
              "odpi/src/dpiSubscr.c",
+             "odpi/src/dpiTrace.c",
              "odpi/src/dpiUtils.c",
              "odpi/src/dpiVar.c"
     ],
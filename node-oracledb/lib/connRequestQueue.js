@@ -0,0 +1,369 @@
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved
+
+//-----------------------------------------------------------------------------
+//
+// You may not use the identified files except in compliance with the Apache
+// License, Version 2.0 (the "License.")
+//
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-----------------------------------------------------------------------------
+
+'use strict';
+
+//-----------------------------------------------------------------------------
+// RequestHeap
+//   Binary min-heap of requests ordered by the given comparison function. The
+// position of each request in the heap is stored on the request itself under
+// the given property name so that it can be removed without searching.
+//-----------------------------------------------------------------------------
+class RequestHeap {
+
+  constructor(compare, indexName) {
+    this._compare = compare;
+    this._indexName = indexName;
+    this._items = [];
+  }
+
+  get length() {
+    return this._items.length;
+  }
+
+  peek() {
+    return this._items[0];
+  }
+
+  push(request) {
+    this._items.push(request);
+    this._moveUp(this._items.length - 1);
+  }
+
+  remove(request) {
+    const index = request[this._indexName];
+    const last = this._items.pop();
+    if (index < this._items.length) {
+      this._set(index, last);
+      this._moveUp(index);
+      this._moveDown(last[this._indexName]);
+    }
+    request[this._indexName] = undefined;
+  }
+
+  _moveDown(index) {
+    const items = this._items;
+    const request = items[index];
+    let child;
+    while ((child = 2 * index + 1) < items.length) {
+      if (child + 1 < items.length &&
+          this._compare(items[child + 1], items[child]) < 0)
+        child += 1;
+      if (this._compare(items[child], request) >= 0)
+        break;
+      this._set(index, items[child]);
+      index = child;
+    }
+    this._set(index, request);
+  }
+
+  _moveUp(index) {
+    const items = this._items;
+    const request = items[index];
+    while (index > 0) {
+      const parent = (index - 1) >> 1;
+      if (this._compare(request, items[parent]) >= 0)
+        break;
+      this._set(index, items[parent]);
+      index = parent;
+    }
+    this._set(index, request);
+  }
+
+  _set(index, request) {
+    this._items[index] = request;
+    request[this._indexName] = index;
+  }
+
+}
+
+//-----------------------------------------------------------------------------
+// ConnRequestQueue
+//   Queue of requests waiting for a connection from a pool. Requests with a
+// higher priority are served first. Within a priority, requests with a
+// deadline are served earliest deadline first, ahead of requests without a
+// deadline, which are served in the order in which they were added. Each
+// priority in use has its own class containing a linked list of the requests
+// without a deadline and a heap of the requests with one, so that requests
+// which do not use a deadline are added and removed without scanning or
+// shifting an array, just as requests with a timeout are linked into a list
+// ordered by the time at which they expire. Requests with a deadline are kept
+// in a heap ordered by the earlier of their deadline and their timeout
+// instead. A single timer is used for all of the requests, armed for the
+// request that expires first; expired requests are also removed whenever a
+// request is taken from the queue so that a connection is never handed to a
+// request that can no longer use it.
+//-----------------------------------------------------------------------------
+class ConnRequestQueue {
+
+  constructor(onTimeout) {
+    this.length = 0;
+    this._classes = [];
+    this._classesByPriority = new Map();
+    this._expiryHead = null;
+    this._expiryTail = null;
+    this._deadlineExpiries = new RequestHeap((a, b) => a._expiry - b._expiry,
+      '_expiryIndex');
+    this._seqNum = 0;
+    this._onTimeout = onTimeout;
+    this._timer = null;
+    this._timerDeadline = 0;
+  }
+
+  //---------------------------------------------------------------------------
+  // push()
+  //   Adds the request to the queue. The request may specify a priority
+  // (defaulting to 0) and a deadline (milliseconds since the epoch). If a
+  // timeout (in milliseconds) is specified or the request has a deadline, the
+  // request is removed from the queue and passed to the timeout handler once
+  // the earlier of the two expires, along with a flag indicating whether it
+  // was the deadline that expired.
+  //---------------------------------------------------------------------------
+  push(request, timeout) {
+    const requestClass = this._getClass(request.priority || 0);
+    request._class = requestClass;
+    requestClass.length += 1;
+    this.length += 1;
+    if (request.deadline === undefined) {
+      request._prev = requestClass.tail;
+      request._next = null;
+      if (requestClass.tail) {
+        requestClass.tail._next = request;
+      } else {
+        requestClass.head = request;
+      }
+      requestClass.tail = request;
+      if (timeout > 0) {
+        request._expiry = Date.now() + timeout;
+        this._addExpiry(request);
+      }
+    } else {
+      request._seqNum = this._seqNum++;
+      requestClass.deadlines.push(request);
+      const expiry = (timeout > 0) ? Date.now() + timeout : Infinity;
+      request._deadlineExpiry = (request.deadline <= expiry);
+      request._expiry = Math.min(request.deadline, expiry);
+      this._deadlineExpiries.push(request);
+    }
+    if (request._expiry !== undefined &&
+        (!this._timer || request._expiry < this._timerDeadline)) {
+      this._armTimer(request._expiry);
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // remove()
+  //   Removes the request from the queue.
+  //---------------------------------------------------------------------------
+  remove(request) {
+    const requestClass = request._class;
+    if (request.deadline === undefined) {
+      if (request._prev) {
+        request._prev._next = request._next;
+      } else {
+        requestClass.head = request._next;
+      }
+      if (request._next) {
+        request._next._prev = request._prev;
+      } else {
+        requestClass.tail = request._prev;
+      }
+      request._prev = request._next = null;
+      if (request._expiry !== undefined) {
+        this._removeExpiry(request);
+      }
+    } else {
+      requestClass.deadlines.remove(request);
+      this._deadlineExpiries.remove(request);
+    }
+    request._class = null;
+    requestClass.length -= 1;
+    if (requestClass.length === 0) {
+      this._classes.splice(this._classes.indexOf(requestClass), 1);
+      this._classesByPriority.delete(requestClass.priority);
+    }
+    this.length -= 1;
+    if (this.length === 0 && this._timer) {
+      clearTimeout(this._timer);
+      this._timer = null;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // shift()
+  //   Removes the request that should be served next from the queue and
+  // returns it. Any requests that have already expired are first passed to
+  // the timeout handler, even if the timer has not yet fired.
+  //---------------------------------------------------------------------------
+  shift() {
+    if (this._expiryHead || this._deadlineExpiries.length > 0) {
+      this._expireRequests(Date.now());
+    }
+    if (this.length === 0) {
+      return undefined;
+    }
+    const requestClass = this._classes[0];
+    const request = requestClass.deadlines.peek() || requestClass.head;
+    this.remove(request);
+    return request;
+  }
+
+  //---------------------------------------------------------------------------
+  // _addExpiry()
+  //   Adds a request without a deadline to the list ordered by the time at
+  // which it expires. Requests are normally added with an expiry later than
+  // all of the others, so the list is scanned backwards from the end.
+  //---------------------------------------------------------------------------
+  _addExpiry(request) {
+    let prev = this._expiryTail;
+    while (prev && prev._expiry > request._expiry) {
+      prev = prev._expiryPrev;
+    }
+    request._expiryPrev = prev;
+    request._expiryNext = (prev) ? prev._expiryNext : this._expiryHead;
+    if (request._expiryNext) {
+      request._expiryNext._expiryPrev = request;
+    } else {
+      this._expiryTail = request;
+    }
+    if (prev) {
+      prev._expiryNext = request;
+    } else {
+      this._expiryHead = request;
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // _armTimer()
+  //   Arms the timer to expire at the given time. The timer is otherwise left
+  // alone when requests are removed; when it fires, it expires whatever
+  // requests are due and is then armed for the next one. Delays larger than a
+  // 32-bit signed integer are not supported by setTimeout(), which would fire
+  // after 1ms instead, so a distant expiry is reached by firing early and
+  // re-arming from _expire().
+  //---------------------------------------------------------------------------
+  _armTimer(expiry) {
+    if (this._timer) {
+      clearTimeout(this._timer);
+    }
+    this._timerDeadline = expiry;
+    this._timer = setTimeout(() => {
+      this._timer = null;
+      this._expire();
+    }, Math.min(Math.max(expiry - Date.now(), 1), 2 ** 31 - 1));
+  }
+
+  //---------------------------------------------------------------------------
+  // _expire()
+  //   Expires all requests that are due and arms the timer for the next
+  // request to expire.
+  //---------------------------------------------------------------------------
+  _expire() {
+    this._expireRequests(Date.now());
+    const request = this._getNextExpiry();
+    if (request && !this._timer) {
+      this._armTimer(request._expiry);
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // _expireRequests()
+  //   Removes all requests that expire at or before the given time and passes
+  // them to the timeout handler.
+  //---------------------------------------------------------------------------
+  _expireRequests(now) {
+    let request;
+    while ((request = this._getNextExpiry()) && request._expiry <= now) {
+      this.remove(request);
+      this._onTimeout(request, request._deadlineExpiry === true);
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // _getClass()
+  //   Returns the class for the given priority, creating it if no requests of
+  // that priority are currently queued. The classes are kept in order of
+  // descending priority.
+  //---------------------------------------------------------------------------
+  _getClass(priority) {
+    let requestClass = this._classesByPriority.get(priority);
+    if (!requestClass) {
+      requestClass = {
+        priority: priority,
+        length: 0,
+        head: null,
+        tail: null,
+        deadlines: new RequestHeap(ConnRequestQueue._compareDeadlines,
+          '_requestIndex')
+      };
+      let pos = this._classes.length;
+      while (pos > 0 && this._classes[pos - 1].priority < priority) {
+        pos -= 1;
+      }
+      this._classes.splice(pos, 0, requestClass);
+      this._classesByPriority.set(priority, requestClass);
+    }
+    return requestClass;
+  }
+
+  //---------------------------------------------------------------------------
+  // _getNextExpiry()
+  //   Returns the request that expires first, if any requests expire at all.
+  //---------------------------------------------------------------------------
+  _getNextExpiry() {
+    const request = this._deadlineExpiries.peek();
+    if (!request || (this._expiryHead &&
+        this._expiryHead._expiry <= request._expiry)) {
+      return this._expiryHead;
+    }
+    return request;
+  }
+
+  //---------------------------------------------------------------------------
+  // _removeExpiry()
+  //   Removes a request without a deadline from the list ordered by the time
+  // at which it expires.
+  //---------------------------------------------------------------------------
+  _removeExpiry(request) {
+    if (request._expiryPrev) {
+      request._expiryPrev._expiryNext = request._expiryNext;
+    } else {
+      this._expiryHead = request._expiryNext;
+    }
+    if (request._expiryNext) {
+      request._expiryNext._expiryPrev = request._expiryPrev;
+    } else {
+      this._expiryTail = request._expiryPrev;
+    }
+    request._expiryPrev = request._expiryNext = null;
+  }
+
+  //---------------------------------------------------------------------------
+  // _compareDeadlines()
+  //   Determines the order in which requests with a deadline in the same class
+  // are served: earliest deadline first and then in the order in which they
+  // were added.
+  //---------------------------------------------------------------------------
+  static _compareDeadlines(a, b) {
+    return (a.deadline - b.deadline) || (a._seqNum - b._seqNum);
+  }
+
+}
+
+module.exports = ConnRequestQueue;
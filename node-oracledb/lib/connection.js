@@ -52,9 +52,17 @@ async function execute(sql, a2, a3) {
   const result = await this._execute(sql, binds, executeOpts);
 
   // process queries; if a result set is not desired, fetch all of the rows
-  // from the result set and then destroy the result set
+  // from the result set and then destroy the result set; the first batch of
+  // rows may already have been fetched during execute, in which case the
+  // result set is only returned if more rows remain to be fetched; if any
+  // column had its strings interned, the statistics are returned as well
   if (result.resultSet && !executeOpts.resultSet) {
-    result.rows = await result.resultSet._getAllRows(executeOpts, result);
+    result.rows = await result.resultSet._getAllRows(executeOpts, result,
+      false, result.rows);
+    const internStatistics = result.resultSet.internStatistics;
+    if (internStatistics) {
+      result.internStatistics = internStatistics;
+    }
     delete result.resultSet;
   }
 
@@ -323,6 +331,7 @@ class Connection extends EventEmitter {
     this._dbObjectClasses = {};
     this._requestQueue = [];
     this._inProgress = false;
+    this._fetchAheads = new Map();
   }
 
   // extend class with promisified functions
@@ -388,6 +397,18 @@ class Connection extends EventEmitter {
     }
   }
 
+  // waits for the fetches ahead of time started by result sets on the
+  // connection, other than the one making the request, to complete; this is
+  // called once the lock has been acquired so no new fetches can be started
+  // by any other result set in the meantime
+  async _waitForFetchAheads(requester) {
+    for (const [resultSet, promise] of this._fetchAheads) {
+      if (resultSet !== requester) {
+        await promise.catch(() => {});
+      }
+    }
+  }
+
   // To obtain a SodaDatabase object (high-level SODA object associated with
   // current connection)
   getSodaDatabase() {
@@ -415,7 +436,7 @@ class Connection extends EventEmitter {
 
     options.resultSet = true;
 
-    const stream = new QueryStream();
+    const stream = new QueryStream(null, options, 3);
 
     // calling execute() via nextTick to ensure that handlers are registered
     // prior to the events being emitted
@@ -96,6 +96,7 @@ class OracleDb {
     this.queueTimeout = 60000;
     this.queueMax     = 500;
     this.errorOnConcurrentExecute = false;
+    this.fetchMemoryLimit = 64 * 1024 * 1024;
   }
 
   // extend class with promisified functions
@@ -19,6 +19,7 @@
 
 'use strict';
 
+const ConnRequestQueue = require('./connRequestQueue.js');
 const EventEmitter = require('events');
 const nodbUtil = require('./util.js');
 const util = require('util');
@@ -27,44 +28,94 @@ const util = require('util');
 // _checkRequestQueue()
 //   When a connection is returned to the pool, this method is called (via an
 // event handler) to determine when requests for connections should be
-// completed and cancels any timeout that may have been associated with the
-// request. This method is also called from reconfigure() so that waiting
-// connection-requests can be processed.
+// completed. The connection is handed to the waiter that should be served
+// next (see ConnRequestQueue) by counting it as out on the waiter's behalf, so
+// that a request made in the meantime cannot take it first. This method is
+// also called from reconfigure() so that waiting connection-requests can be
+// processed.
 //-----------------------------------------------------------------------------
 function _checkRequestQueue() {
   while (this._connRequestQueue.length > 0 &&
       this._connectionsOut < this.poolMax) {
     // process the payload
     const payload = this._connRequestQueue.shift();
+    if (!payload) {
+      break;
+    }
     if (this._enableStatistics) {
       this._totalRequestsDequeued += 1;
+      this._getPriorityStatistics(payload.priority).requestsDequeued += 1;
       this._updateWaitStatistics(payload);
     }
-    if (payload.timeoutHandle) {
-      clearTimeout(payload.timeoutHandle);
-    }
     // inform the waiter that processing can continue
+    this._connectionsOut += 1;
     payload.resolve();
   }
 }
 
 
+//-----------------------------------------------------------------------------
+// _onRequestTimeout()
+//   Called by the request queue when a request has waited for longer than the
+// queue timeout in effect when it was queued, or when its deadline has
+// passed.
+//-----------------------------------------------------------------------------
+function _onRequestTimeout(payload, deadlinePassed) {
+  if (this._enableStatistics) {
+    const classStats = this._getPriorityStatistics(payload.priority);
+    if (deadlinePassed) {
+      this._totalRequestsExpired += 1;
+      classStats.requestsExpired += 1;
+    } else {
+      this._totalRequestTimeouts += 1;
+      classStats.requestTimeouts += 1;
+    }
+    this._updateWaitStatistics(payload);
+  }
+  if (deadlinePassed) {
+    payload.reject(new Error(nodbUtil.getErrorMessage('NJS-086')));
+  } else {
+    payload.reject(new Error(nodbUtil.getErrorMessage('NJS-040',
+      payload.queueTimeout)));
+  }
+}
+
+
 //-----------------------------------------------------------------------------
 // getConnection()
 //   Gets a connection from the pool and returns it to the caller. If there are
 // fewer connections out than the poolMax setting, then the request will
 // return immediately; otherwise, the request will be queued for up to
-// queueTimeout milliseconds.
+// queueTimeout milliseconds or until its deadline passes, whichever comes
+// first. Queued requests with a higher priority are served first.
 //-----------------------------------------------------------------------------
 async function getConnection(a1) {
+  let deadline;
   let poolMax;
   let options = {};
+  let priority = 0;
 
   // check arguments
   nodbUtil.checkArgCount(arguments, 0, 1);
   if (arguments.length == 1) {
     nodbUtil.assert(nodbUtil.isObject(a1), 'NJS-005', 1);
     options = a1;
+    if (options.priority !== undefined) {
+      if (!Number.isSafeInteger(options.priority)) {
+        throw new Error(nodbUtil.getErrorMessage('NJS-007', 'priority', 1));
+      }
+      priority = options.priority;
+    }
+    if (options.deadline !== undefined) {
+      if (this._isDate(options.deadline)) {
+        deadline = options.deadline.getTime();
+      } else {
+        deadline = options.deadline;
+      }
+      if (!Number.isFinite(deadline)) {
+        throw new Error(nodbUtil.getErrorMessage('NJS-007', 'deadline', 1));
+      }
+    }
   }
 
   // if pool is draining/closed, throw an appropriate error
@@ -73,6 +124,17 @@ async function getConnection(a1) {
   // manage stats, if applicable
   if (this._enableStatistics) {
     this._totalConnectionRequests += 1;
+    this._getPriorityStatistics(priority).connectionRequests += 1;
+  }
+
+  // a request whose deadline has already passed is rejected without
+  // consuming a connection
+  if (deadline !== undefined && deadline <= Date.now()) {
+    if (this._enableStatistics) {
+      this._totalRequestsExpired += 1;
+      this._getPriorityStatistics(priority).requestsExpired += 1;
+    }
+    throw new Error(nodbUtil.getErrorMessage('NJS-086'));
   }
 
   // getting the poolMax setting on the pool may fail if the pool is no longer
@@ -94,56 +156,58 @@ async function getConnection(a1) {
         this._queueMax >= 0) {
       if (this._enableStatistics) {
         this._totalRequestsRejected += 1;
+        this._getPriorityStatistics(priority).rejectedRequests += 1;
       }
       throw new Error(nodbUtil.getErrorMessage('NJS-076', this._queueMax));
     }
 
     // if too many connections are out, wait until room is made available or the
-    // queue timeout expires
+    // queue timeout or deadline expires; if using a queue timeout or a
+    // deadline, the payload will be removed from the queue and an exception
+    // thrown when it expires
     await new Promise((resolve, reject) => {
 
-      // set up a payload which will be added to the queue for processing
-      const payload = { resolve: resolve, reject: reject };
-
-      // if using a queue timeout, establish the timeout so that when it
-      // expires the payload will be removed from the queue and an exception
-      // thrown
-      if (this._queueTimeout !== 0) {
-        payload.timeoutHandle = setTimeout(() => {
-          const ix = this._connRequestQueue.indexOf(payload);
-          if (ix >= 0) {
-            this._connRequestQueue.splice(ix, 1);
-          }
-          if (this._enableStatistics) {
-            this._totalRequestTimeouts += 1;
-            this._updateWaitStatistics(payload);
-          }
-          reject(new Error(nodbUtil.getErrorMessage('NJS-040',
-            this._queueTimeout)));
-        }, this._queueTimeout);
-      }
-
-      // add payload to the queue
-      this._connRequestQueue.push(payload);
+      // set up a payload and add it to the queue for processing
+      const payload = { resolve: resolve, reject: reject,
+        queueTimeout: this._queueTimeout, priority: priority,
+        deadline: deadline };
       if (this._enableStatistics) {
         payload.enqueuedTime = Date.now();
+      }
+      this._connRequestQueue.push(payload, this._queueTimeout);
+      if (this._enableStatistics) {
         this._totalRequestsEnqueued += 1;
+        this._getPriorityStatistics(priority).requestsEnqueued += 1;
         this._maximumQueueLength = Math.max(this._maximumQueueLength,
           this._connRequestQueue.length);
       }
 
     });
 
-    // check if pool is draining/closed after delay has
-    // completed and throw an appropriate error
-    this._checkPoolOpen(true);
+    // the connection has already been counted as out on behalf of this
+    // request; check if pool is draining/closed after delay has completed and
+    // throw an appropriate error, returning the connection so that another
+    // request can use it or a pending close can complete
+    try {
+      this._checkPoolOpen(true);
+    } catch (err) {
+      this._connectionsOut -= 1;
+      this.emit('_checkRequestQueue');
+      if (this._connectionsOut == 0) {
+        this.emit('_allCheckedIn');
+      }
+      throw err;
+    }
+
+  } else {
+
+    // room is available in the queue, so proceed to acquire a connection from
+    // the pool; adjust the connections out immediately in order to ensure that
+    // another attempt doesn't proceed while this one is underway
+    this._connectionsOut += 1;
 
   }
 
-  // room is available in the queue, so proceed to acquire a connection from
-  // the pool; adjust the connections out immediately in order to ensure that
-  // another attempt doesn't proceed while this one is underway
-  this._connectionsOut += 1;
   try {
 
     // acquire connection from the pool
@@ -294,6 +358,18 @@ async function close(a1) {
   // (whichever comes first)
   if (drainTime > 0) {
     this._status = this._oracledb.POOL_STATUS_DRAINING;
+
+    // requests waiting for a connection can no longer be served, so they are
+    // rejected immediately instead of waiting for the drain to complete
+    let payload;
+    while ((payload = this._connRequestQueue.shift())) {
+      if (this._enableStatistics) {
+        this._totalFailedRequests += 1;
+        this._updateWaitStatistics(payload);
+      }
+      payload.reject(new Error(nodbUtil.getErrorMessage('NJS-064')));
+    }
+
     await new Promise(resolve => {
       const timeout = setTimeout(() => {
         this.removeAllListeners('_allCheckedIn');
@@ -337,6 +413,7 @@ function logStatistics() {
   console.log('...requests failed:', stats.failedRequests);
   console.log('...requests exceeding queueMax:', stats.rejectedRequests);
   console.log('...requests exceeding queueTimeout:', stats.requestTimeouts);
+  console.log('...requests exceeding deadline:', stats.requestsExpired);
   console.log('...current queue length:', stats.currentQueueLength);
   console.log('...maximum queue length:', stats.maximumQueueLength);
   console.log('...sum of time in queue (milliseconds):', stats.timeInQueue);
@@ -348,6 +425,25 @@ function logStatistics() {
     stats.averageTimeInQueue);
   console.log('...pool connections in use:', stats.connectionsInUse);
   console.log('...pool connections open:', stats.connectionsOpen);
+  for (const classStats of stats.priorityClasses) {
+    console.log(`Priority ${classStats.priority} statistics:`);
+    console.log('...connection requests:', classStats.connectionRequests);
+    console.log('...requests enqueued:', classStats.requestsEnqueued);
+    console.log('...requests dequeued:', classStats.requestsDequeued);
+    console.log('...requests exceeding queueMax:',
+      classStats.rejectedRequests);
+    console.log('...requests exceeding queueTimeout:',
+      classStats.requestTimeouts);
+    console.log('...requests exceeding deadline:', classStats.requestsExpired);
+    console.log('...sum of time in queue (milliseconds):',
+      classStats.timeInQueue);
+    console.log('...minimum time in queue (milliseconds):',
+      classStats.minimumTimeInQueue);
+    console.log('...maximum time in queue (milliseconds):',
+      classStats.maximumTimeInQueue);
+    console.log('...average time in queue (milliseconds):',
+      classStats.averageTimeInQueue);
+  }
   console.log('Pool attributes:');
   console.log('...poolAlias:', stats.poolAlias);
   console.log('...queueMax:', stats.queueMax);
@@ -398,6 +494,7 @@ function getStatistics() {
   stats.failedRequests = this._totalFailedRequests;
   stats.rejectedRequests = this._totalRequestsRejected;
   stats.requestTimeouts = this._totalRequestTimeouts;
+  stats.requestsExpired = this._totalRequestsExpired;
   stats.maximumQueueLength = this._maximumQueueLength;
   stats.currentQueueLength = this._connRequestQueue.length;
   stats.timeInQueue = this._totalTimeInQueue;
@@ -406,6 +503,17 @@ function getStatistics() {
   stats.averageTimeInQueue = averageTimeInQueue;
   stats.connectionsInUse = this.connectionsInUse;
   stats.connectionsOpen = this.connectionsOpen;
+  stats.priorityClasses = [];
+  const priorities = Array.from(this._priorityStatistics.keys());
+  priorities.sort((a, b) => b - a);
+  for (const priority of priorities) {
+    const classStats = this._priorityStatistics.get(priority);
+    stats.priorityClasses.push({
+      ...classStats,
+      averageTimeInQueue: (classStats.requestsEnqueued === 0) ? 0 :
+        Math.round(classStats.timeInQueue / classStats.requestsEnqueued)
+    });
+  }
   stats.poolAlias = this.poolAlias;
   stats.queueMax = this.queueMax;
   stats.queueTimeout = this.queueTimeout;
@@ -500,7 +608,7 @@ function _setup(poolAttrs, poolAlias, oracledb) {
         writable: true
       },
       _connRequestQueue: {
-        value: [],
+        value: new ConnRequestQueue(_onRequestTimeout.bind(this)),
         writable: true
       },
       _status: {  // open/closing/closed
@@ -588,6 +696,8 @@ class Pool extends EventEmitter {
     this._totalFailedRequests = 0;
     this._totalRequestsRejected = 0;
     this._totalRequestTimeouts = 0;
+    this._totalRequestsExpired = 0;
+    this._priorityStatistics = new Map();
     this._maximumQueueLength = this._connRequestQueue.length;
     this._totalTimeInQueue = 0;
     this._minTimeInQueue = 0;
@@ -595,17 +705,54 @@ class Pool extends EventEmitter {
   }
 
 
+  // return the statistics for the given priority class, creating them if
+  // this is the first request of that priority since the statistics were
+  // reset
+  _getPriorityStatistics(priority) {
+    let classStats = this._priorityStatistics.get(priority);
+    if (!classStats) {
+      classStats = {
+        priority: priority,
+        connectionRequests: 0,
+        requestsEnqueued: 0,
+        requestsDequeued: 0,
+        rejectedRequests: 0,
+        requestTimeouts: 0,
+        requestsExpired: 0,
+        timeInQueue: 0,
+        minimumTimeInQueue: 0,
+        maximumTimeInQueue: 0
+      };
+      this._priorityStatistics.set(priority, classStats);
+    }
+    return classStats;
+  }
+
+
   // update pool wait statistics after a connect request has spent some time in
-  // the queue
+  // the queue; requests enqueued before statistics were enabled are ignored
   _updateWaitStatistics(payload) {
+    if (payload.enqueuedTime === undefined) {
+      return;
+    }
     const waitTime = Date.now() - payload.enqueuedTime;
+    const classStats = this._getPriorityStatistics(payload.priority);
     this._totalTimeInQueue += waitTime;
+    classStats.timeInQueue += waitTime;
     if (this._minTimeInQueue === 0) {
       this._minTimeInQueue = waitTime;
     } else {
       this._minTimeInQueue = Math.min(this._minTimeInQueue, waitTime);
     }
+    if (classStats.minimumTimeInQueue === 0) {
+      classStats.minimumTimeInQueue = waitTime;
+    } else {
+      classStats.minimumTimeInQueue = Math.min(classStats.minimumTimeInQueue,
+        waitTime);
+    }
     this._maxTimeInQueue = Math.max(this._maxTimeInQueue, waitTime);
+    classStats.maximumTimeInQueue = Math.max(classStats.maximumTimeInQueue,
+      waitTime);
   }
 
 }
@@ -1,4 +1,4 @@
-// Copyright (c) 2015, 2020, Oracle and/or its affiliates. All rights reserved
+// Copyright (c) 2015, 2021, Oracle and/or its affiliates. All rights reserved
 
 //-----------------------------------------------------------------------------
 //
@@ -20,13 +20,32 @@
 'use strict';
 
 const { Readable } = require('stream');
+const nodbUtil = require('./util.js');
 
 class QueryStream extends Readable {
 
-  constructor(rs) {
-    super({ objectMode: true });
+  // the options highWaterMark and emitBatches are validated here; the
+  // parameter number is used when reporting an invalid value
+  constructor(rs, options, paramNum) {
+    options = options || {};
+    const highWaterMark = options.highWaterMark;
+    if (highWaterMark !== undefined && (!Number.isInteger(highWaterMark) ||
+        highWaterMark < 0)) {
+      throw new Error(nodbUtil.getErrorMessage('NJS-007', 'highWaterMark',
+        paramNum));
+    }
+    const emitBatches = options.emitBatches;
+    if (emitBatches !== undefined && typeof emitBatches !== 'boolean') {
+      throw new Error(nodbUtil.getErrorMessage('NJS-007', 'emitBatches',
+        paramNum));
+    }
+    super({ objectMode: true, highWaterMark: highWaterMark });
     this._fetching = false;
-    this._numRows = 0;
+    this._emitBatches = (emitBatches === true);
+    this._jsonTextStarted = false;
+    this._rows = null;
+    this._rowIndex = 0;
+    this._allRowsFetched = false;
 
     // calling open via process.nextTick to allow event handlers to be
     // registered prior to the events being emitted
@@ -48,6 +67,7 @@ class QueryStream extends Readable {
           this.once('_doneFetching', resolve));
       }
       try {
+        await rs._waitForFetchAhead();
         await rs._close();
       } catch (closeErr) {
         cb(closeErr);
@@ -71,8 +91,47 @@ class QueryStream extends Readable {
     this.emit('metadata', rs.metaData);
   }
 
+  // pushes the text of a batch of rows fetched with outFormat OUT_FORMAT_JSON
+  // or OUT_FORMAT_NDJSON as Buffer chunks; for OUT_FORMAT_JSON the chunks of
+  // the stream together form a single JSON array
+  _pushJsonText(parts, isArray, isLast) {
+    for (let i = 0; i < parts.length; i++) {
+      if (isArray)
+        this.push(Buffer.from((this._jsonTextStarted) ? ',' : '['));
+      this._jsonTextStarted = true;
+      this.push(parts[i]);
+    }
+    if (isArray && isLast) {
+      if (!this._jsonTextStarted)
+        this.push(Buffer.from('['));
+      this.push(Buffer.from(']'));
+    }
+  }
+
+  // pushes the rows of the last batch fetched that have not been pushed yet
+  // as separate chunks, stopping as soon as the internal queue is full;
+  // returns true if all of them have been pushed
+  _pushRows() {
+    const rows = this._rows;
+    while (this._rowIndex < rows.length) {
+      if (!this.push(rows[this._rowIndex++]))
+        break;
+    }
+    if (this._rowIndex < rows.length)
+      return false;
+    this._rows = null;
+    return true;
+  }
+
   // called by readable.read() and pushes rows to the internal queue maintained
-  // by the stream implementation (never called directly) appropriate
+  // by the stream implementation (never called directly); each call fetches a
+  // batch of fetchArraySize rows and pushes each of the rows as a separate
+  // chunk until the internal queue is full, so that highWaterMark counts rows
+  // (the remaining rows are pushed by the next calls before another batch is
+  // fetched), or, if emitBatches is set, pushes the array of rows as a single
+  // chunk, so that highWaterMark counts batches instead; rows fetched as JSON
+  // text are pushed as Buffers that can be written directly to a socket or
+  // file
   async _read() {
 
     // still waiting on the result set to be added via _open() so add an event
@@ -82,24 +141,66 @@ class QueryStream extends Readable {
       return;
     }
 
-    // using the JS getRow() to leverage the JS row cache; the result set's
-    // _allowGetRowCall is set to true to allow the call for query streams
-    // created via ResultSet.toQueryStream()
+    // push any rows left over from the last batch fetched first; another
+    // batch is only fetched by a later call, once all of them have been
+    // pushed
+    if (this._rows) {
+      if (this._pushRows() && this._allRowsFetched)
+        this.push(null);
+      return;
+    }
+
+    // using the JS getRows() to leverage the JS row cache (and any rows
+    // fetched ahead of time); the result set's _allowGetRowsCall is set to
+    // true to allow the call for query streams created via
+    // ResultSet.toQueryStream(); fewer rows than requested are only returned
+    // once all rows have been fetched, so the end of the stream can be
+    // signalled without another fetch
     try {
+      const rs = this._resultSet;
+      if (rs._outFormat === rs._oracledb.OUT_FORMAT_COLUMNS) {
+        throw new Error(nodbUtil.getErrorMessage('NJS-084'));
+      }
+      const numRows = rs._fetchArraySize;
+      const jsonText = rs._isJsonText();
+      let rows, numRowsFetched;
       this._fetching = true;
-      this._resultSet._allowGetRowCall = true;
-      const row = await this._resultSet.getRow();
+      if (jsonText) {
+        const result = await rs._fetchJsonText(numRows, false);
+        rows = result.parts;
+        numRowsFetched = result.numRows;
+      } else {
+        rs._allowGetRowsCall = true;
+        rows = await rs.getRows(numRows);
+        numRowsFetched = rows.length;
+      }
       this._fetching = false;
       if (!this._resultSet) {
         this.emit('_doneFetching');
         return;
       }
-      if (row) {
-        this.push(row);
-      } else {
+      if (jsonText) {
+        this._pushJsonText(rows,
+          rs._outFormat === rs._oracledb.OUT_FORMAT_JSON,
+          numRowsFetched < numRows);
+      } else if (rows.length > 0) {
+        if (this._emitBatches) {
+          this.push(rows);
+        } else {
+          this._rows = rows;
+          this._rowIndex = 0;
+          if (!this._pushRows()) {
+            this._allRowsFetched = (numRowsFetched < numRows);
+            return;
+          }
+        }
+      }
+      if (numRowsFetched < numRows) {
         this.push(null);
       }
     } catch (err) {
+      this._fetching = false;
+      this.emit('_doneFetching');
       this.destroy(err);
     }
   }
@@ -21,6 +21,213 @@
 
 const QueryStream = require('./queryStream.js');
 const nodbUtil = require('./util.js');
+const util = require('util');
+
+//-----------------------------------------------------------------------------
+// getNumColumnRows()
+//   Returns the number of rows contained in an array of columns fetched with
+// outFormat OUT_FORMAT_COLUMNS.
+//-----------------------------------------------------------------------------
+function getNumColumnRows(columns) {
+  const column = columns[0];
+  return (column.offsets) ? column.offsets.length - 1 : column.values.length;
+}
+
+
+//-----------------------------------------------------------------------------
+// concatColumns()
+//   Concatenates arrays of columns fetched with outFormat OUT_FORMAT_COLUMNS
+// into a single array of columns. The null bitmaps are shifted as needed when
+// the number of rows preceding a batch is not a multiple of 8.
+//-----------------------------------------------------------------------------
+function concatColumns(batches) {
+  if (batches.length === 1)
+    return batches[0];
+  const numRows = batches.map(getNumColumnRows);
+  const totalRows = numRows.reduce((a, b) => a + b, 0);
+  const columns = [];
+  for (let col = 0; col < batches[0].length; col++) {
+    const parts = batches.map(batch => batch[col]);
+    const nulls = new Uint8Array((totalRows + 7) >> 3);
+    let rowOffset = 0;
+    for (let i = 0; i < parts.length; i++) {
+      const src = parts[i].nulls;
+      const shift = rowOffset & 7;
+      const base = rowOffset >> 3;
+      if (shift === 0) {
+        nulls.set(src, base);
+      } else {
+        for (let j = 0; j < src.length; j++) {
+          nulls[base + j] |= (src[j] << shift) & 0xff;
+          if (base + j + 1 < nulls.length)
+            nulls[base + j + 1] |= src[j] >> (8 - shift);
+        }
+      }
+      rowOffset += numRows[i];
+    }
+    const column = { nulls: nulls };
+    if (parts[0].offsets) {
+      column.data = Buffer.concat(parts.map(part => part.data));
+      column.offsets = new Uint32Array(totalRows + 1);
+      let pos = 0, dataOffset = 0;
+      for (let i = 0; i < parts.length; i++) {
+        const offsets = parts[i].offsets;
+        for (let j = 1; j < offsets.length; j++)
+          column.offsets[++pos] = dataOffset + offsets[j];
+        dataOffset += parts[i].data.length;
+      }
+    } else if (parts[0].values instanceof Float64Array) {
+      column.values = new Float64Array(totalRows);
+      let pos = 0;
+      for (let i = 0; i < parts.length; i++) {
+        column.values.set(parts[i].values, pos);
+        pos += numRows[i];
+      }
+    } else {
+      column.values = [];
+      for (let i = 0; i < parts.length; i++)
+        column.values = column.values.concat(parts[i].values);
+    }
+    columns.push(column);
+  }
+  return columns;
+}
+
+
+//-----------------------------------------------------------------------------
+// joinJsonText()
+//   Joins the text of the rows fetched as JSON text in one or more calls into
+// a single Buffer. For outFormat OUT_FORMAT_JSON each part contains objects
+// separated by commas and the parts are joined into a JSON array; for
+// OUT_FORMAT_NDJSON each part already contains one line for each row.
+//-----------------------------------------------------------------------------
+function joinJsonText(parts, isArray) {
+  if (!isArray)
+    return (parts.length === 1) ? parts[0] : Buffer.concat(parts);
+  const buffers = [Buffer.from('[')];
+  for (let i = 0; i < parts.length; i++) {
+    if (i > 0)
+      buffers.push(Buffer.from(','));
+    buffers.push(parts[i]);
+  }
+  buffers.push(Buffer.from(']'));
+  return Buffer.concat(buffers);
+}
+
+
+//-----------------------------------------------------------------------------
+// getRowConstructor()
+//   Returns a constructor for rows fetched with outFormat OUT_FORMAT_OBJECT
+// that assigns each of the column values in order. All rows created by the
+// same constructor share the same hidden class, which avoids the dictionary
+// transitions that occur when properties are added one at a time. The
+// constructors are cached by column names so that nested cursors and repeated
+// queries do not need to compile a new function each time; the cache is
+// cleared when it becomes too large to avoid growing without bound.
+//-----------------------------------------------------------------------------
+const rowConstructors = new Map();
+const maxRowConstructors = 256;
+function getRowConstructor(names) {
+  const key = JSON.stringify(names);
+  let ctor = rowConstructors.get(key);
+  if (!ctor) {
+    const args = names.map((name, i) => "v" + i);
+    const body = names.map((name, i) =>
+      "this[" + JSON.stringify(name) + "] = v" + i + ";").join("\n");
+    ctor = new Function(...args, body);
+    ctor.prototype = Object.prototype;
+    if (rowConstructors.size >= maxRowConstructors)
+      rowConstructors.clear();
+    rowConstructors.set(key, ctor);
+  }
+  return ctor;
+}
+
+
+//-----------------------------------------------------------------------------
+// LazyRow
+//   Base class for rows fetched with the execute() option lazyRows. Each row
+// refers to the batch of buffered rows it was fetched with and a column value
+// is only converted when it is first accessed; it is then retained by the
+// row. The batch (and the memory retained for it) is freed once all of its
+// rows are no longer referenced. The state of the row is kept in a single
+// non-enumerable property so that it is not seen by Object.keys(), spread
+// syntax, for...in loops or deep comparisons; since the columns are accessors
+// on the prototype, the row has no own enumerable properties at all.
+//-----------------------------------------------------------------------------
+class LazyRow {
+
+  constructor(batch, index) {
+    Object.defineProperty(this, '_state', {
+      value: { batch: batch, index: index, values: undefined }
+    });
+  }
+
+  _getValue(col) {
+    const state = this._state;
+    if (state.values === undefined)
+      state.values = new Array(state.batch.names.length);
+    let value = state.values[col];
+    if (value === undefined) {
+      value = state.batch.rs._getLazyValue(state.batch.handle, state.index,
+        col);
+      state.values[col] = value;
+    }
+    return value;
+  }
+
+  // returns the row as a plain array or object containing all of the values
+  toObject() {
+    const batch = this._state.batch;
+    const values = batch.names.map((name, col) => this._getValue(col));
+    if (!batch.isObject)
+      return values;
+    const RowConstructor = getRowConstructor(batch.names);
+    return new RowConstructor(...values);
+  }
+
+  toJSON() {
+    return this.toObject();
+  }
+
+  // console.log() and util.inspect() show the values of the columns
+  [util.inspect.custom](depth, options) {
+    return util.inspect(this.toObject(), options);
+  }
+
+}
+
+
+//-----------------------------------------------------------------------------
+// getLazyRowClass()
+//   Returns a class for lazy rows with an accessor on its prototype for each
+// column, named after the column for outFormat OUT_FORMAT_OBJECT and after
+// the column index (together with a length property) for OUT_FORMAT_ARRAY.
+// The classes are cached by column names in the same way as the row
+// constructors.
+//-----------------------------------------------------------------------------
+const lazyRowClasses = new Map();
+function getLazyRowClass(names, isObject) {
+  const key = JSON.stringify([isObject, names]);
+  let cls = lazyRowClasses.get(key);
+  if (!cls) {
+    cls = class extends LazyRow {};
+    for (let col = 0; col < names.length; col++) {
+      Object.defineProperty(cls.prototype, (isObject) ? names[col] : col, {
+        get() { return this._getValue(col); },
+        enumerable: true
+      });
+    }
+    if (!isObject) {
+      Object.defineProperty(cls.prototype, 'length', { value: names.length });
+    }
+    if (lazyRowClasses.size >= maxRowConstructors)
+      lazyRowClasses.clear();
+    lazyRowClasses.set(key, cls);
+  }
+  return cls;
+}
+
 
 //-----------------------------------------------------------------------------
 // close()
@@ -34,6 +241,7 @@ async function close() {
   }
 
   this._processingStarted = true;
+  await this._waitForFetchAhead();
   await this._close();
 }
 
@@ -47,13 +255,26 @@ async function close() {
 async function getRow() {
   nodbUtil.checkArgCount(arguments, 0, 0);
 
-  if (this._convertedToStream && !this._allowGetRowCall) {
+  if (this._convertedToStream) {
     throw new Error(nodbUtil.getErrorMessage('NJS-042'));
   }
 
-  this._allowGetRowCall = false;
+  if (this._outFormat === this._oracledb.OUT_FORMAT_COLUMNS ||
+      this._isJsonText()) {
+    throw new Error(nodbUtil.getErrorMessage('NJS-084'));
+  }
+
   this._processingStarted = true;
 
+  if (this._fetchAhead > 0) {
+    if (this._rowCache.length == 0) {
+      await this._fetchRowsIntoCache(1);
+    }
+    const row = this._rowCache.shift();
+    this._startFetchAhead();
+    return row;
+  }
+
   if (this._rowCache.length == 0) {
     this._rowCache = await this._getRows(this._fetchArraySize, false, false);
   }
@@ -81,21 +302,66 @@ async function getRows(numRows) {
     nodbUtil.assert(numRows >= 0, 'NJS-005', 1);
   }
 
-  if (this._convertedToStream) {
+  if (this._convertedToStream && !this._allowGetRowsCall) {
     throw new Error(nodbUtil.getErrorMessage('NJS-042'));
   }
 
+  this._allowGetRowsCall = false;
   this._processingStarted = true;
 
+  // when fetching columns, batches of rows are concatenated column by column;
+  // no rows are ever cached since getRow() cannot be used
+  if (this._outFormat === this._oracledb.OUT_FORMAT_COLUMNS) {
+    if (numRows > 0) {
+      return await this._getRows(numRows, false, false);
+    }
+    const batches = [];
+    while (true) {  // eslint-disable-line
+      const result = await this._fetchAll(this._fetchArraySize, 0, false,
+        this._oracledb.fetchMemoryLimit);
+      batches.push(result.rows);
+      if (!result.moreRows)
+        break;
+    }
+    return concatColumns(batches);
+  }
+
+  // when fetching JSON text, the text of the rows is returned in a single
+  // Buffer; no rows are ever cached since getRow() cannot be used
+  if (this._isJsonText()) {
+    const result = await this._fetchJsonText(numRows, false);
+    return joinJsonText(result.parts,
+      this._outFormat === this._oracledb.OUT_FORMAT_JSON);
+  }
+
+  // when fetching ahead, all rows are returned from the row cache, which is
+  // filled by the fetch ahead in progress (if any) or by a fetch made now
+  if (this._fetchAhead > 0) {
+    while (numRows == 0 || this._rowCache.length < numRows) {
+      const rowsNeeded = (numRows == 0) ? 0 : numRows - this._rowCache.length;
+      if (!await this._fetchRowsIntoCache(rowsNeeded))
+        break;
+    }
+    let requestedRows = this._rowCache;
+    if (numRows == 0) {
+      this._rowCache = [];
+    } else {
+      requestedRows = this._rowCache.splice(0, numRows);
+    }
+    this._startFetchAhead();
+    return requestedRows;
+  }
+
   if (numRows == 0) {
     let requestedRows = this._rowCache;
 
-    const fetchArraySize = this._fetchArraySize;
+    // the worker thread fetches as many rows as the fetch memory limit
+    // permits in each call
     while (true) {  // eslint-disable-line
-      let rows = await this._getRows(fetchArraySize, false, false);
-      if (rows)
-        requestedRows = requestedRows.concat(rows);
-      if (rows.length < fetchArraySize)
+      const result = await this._fetchAll(this._fetchArraySize, 0, false,
+        this._oracledb.fetchMemoryLimit);
+      requestedRows = requestedRows.concat(result.rows);
+      if (!result.moreRows)
         break;
     }
     return requestedRows;
@@ -123,8 +389,24 @@ class ResultSet {
     this._rowCache = [];
     this._processingStarted = false;
     this._convertedToStream = false;
-    this._allowGetRowCall = false;
+    this._allowGetRowsCall = false;
     this._isActive = false;
+    this._fetchAheadPromise = null;
+    this._moreRows = true;
+  }
+
+  // creates the rows for a batch of buffered rows when the execute() option
+  // lazyRows is set; the handle refers to the buffered rows in the C layer
+  _createLazyRows(handle, numRows, names) {
+    const isObject = (this._outFormat === this._oracledb.OUT_FORMAT_OBJECT);
+    const LazyRowClass = getLazyRowClass(names, isObject);
+    const batch = { rs: this, handle: handle, names: names,
+      isObject: isObject };
+    const rows = new Array(numRows);
+    for (let i = 0; i < numRows; i++) {
+      rows[i] = new LazyRowClass(batch, i);
+    }
+    return rows;
   }
 
   _extend(oracledb) {
@@ -134,6 +416,49 @@ class ResultSet {
     this.getRows = nodbUtil.callbackify(nodbUtil.preventConcurrent(nodbUtil.serialize(getRows), 'NJS-017'));
   }
 
+  // fills the row cache with the rows fetched ahead of time, if a fetch ahead
+  // is in progress; otherwise, fetches enough batches of rows to satisfy the
+  // number of rows requested (or all rows if that number is 0); returns false
+  // if no more rows are available
+  async _fetchRowsIntoCache(numRows) {
+    let result;
+    if (this._fetchAheadPromise) {
+      const promise = this._fetchAheadPromise;
+      this._fetchAheadPromise = null;
+      result = await promise;
+    } else if (this._moreRows) {
+      const fetchArraySize = this._fetchArraySize;
+      const maxRows = Math.ceil(numRows / fetchArraySize) * fetchArraySize;
+      result = await this._fetchAll(fetchArraySize, maxRows, false,
+        this._oracledb.fetchMemoryLimit);
+    } else {
+      return false;
+    }
+    this._moreRows = result.moreRows;
+    this._rowCache = this._rowCache.concat(result.rows);
+    return true;
+  }
+
+  // fetches up to numRows rows (or all remaining rows if numRows is 0) as
+  // JSON text; the worker thread writes the rows directly from the fetch
+  // buffers in as few calls as the fetch memory limit permits; the text
+  // returned by each call is returned in an array, together with the total
+  // number of rows
+  async _fetchJsonText(numRows, closeOnAllRowsFetched) {
+    const parts = [];
+    let totalRows = 0;
+    while (this._moreRows && (numRows == 0 || totalRows < numRows)) {
+      const maxRows = (numRows == 0) ? 0 : numRows - totalRows;
+      const result = await this._fetchAll(this._fetchArraySize, maxRows,
+        closeOnAllRowsFetched, this._oracledb.fetchMemoryLimit);
+      this._moreRows = result.moreRows;
+      totalRows += result.numRows;
+      if (result.numRows > 0)
+        parts.push(result.rows);
+    }
+    return { parts: parts, numRows: totalRows };
+  }
+
   _getConnection() {
     let connection = this._parentObj;
     while (!(connection instanceof this._oracledb.Connection))
@@ -141,7 +466,7 @@ class ResultSet {
     return connection;
   }
 
-  async _getAllRows(executeOpts, metaDataObj, isNested) {
+  async _getAllRows(executeOpts, metaDataObj, isNested, firstRows) {
 
     // assign result set metadata to the object; this is either a top-level
     // result object that is returned to the user or a metadata object for a
@@ -163,8 +488,18 @@ class ResultSet {
       outFormat = executeOpts.outFormat;
     }
 
-    // determine the nested cursor indices to use, allowing for both
-    // OUT_FORMAT_ARRAY and OUT_FORMAT_OBJECT formats
+    // when fetching JSON text, nested cursors cannot be present and the text
+    // of all of the rows is returned in a single Buffer; the result set is
+    // closed by the worker thread once all rows have been fetched
+    if (this._isJsonText()) {
+      const result = await this._fetchJsonText(maxRows, true);
+      return joinJsonText(result.parts,
+        this._outFormat === this._oracledb.OUT_FORMAT_JSON);
+    }
+
+    // determine the nested cursor indices to use, allowing for the
+    // OUT_FORMAT_ARRAY, OUT_FORMAT_OBJECT and OUT_FORMAT_COLUMNS formats
+    const fetchColumns = (outFormat == this._oracledb.OUT_FORMAT_COLUMNS);
     const nestedCursorMetaDataObjs = [];
     const nestedCursorIndices = this._nestedCursorIndices;
     for (let i = 0; i < nestedCursorIndices.length; i++) {
@@ -176,19 +511,46 @@ class ResultSet {
     }
 
     // process all rows; transform nested cursors into arrays of rows by
-    // fetching them
+    // fetching them; when fetching columns, each batch is retained and the
+    // batches are concatenated once all rows have been fetched; if there are
+    // no nested cursors, the rows are fetched by the worker thread in as few
+    // calls as the fetch memory limit permits
     let rowsFetched = [];
+    const batches = [];
     let fetchArraySize = this._fetchArraySize;
     let closeOnFetch = false;
-    const closeOnAllRowsFetched = !isNested && nestedCursorIndices.length === 0;
+    const fetchAll = (nestedCursorIndices.length === 0);
+    const closeOnAllRowsFetched = !isNested && fetchAll;
     while (true) {    // eslint-disable-line
       if (maxRows > 0 && fetchArraySize >= maxRows) {
         fetchArraySize = maxRows;
         closeOnFetch = closeOnAllRowsFetched;
       }
-      const rows = await this._getRows(fetchArraySize, closeOnFetch,
-        closeOnAllRowsFetched);
-      if (nestedCursorIndices) {
+      let rows = firstRows;
+      let moreRows;
+      firstRows = undefined;
+      if (!rows && fetchAll) {
+        const result = await this._fetchAll(fetchArraySize, maxRows,
+          closeOnAllRowsFetched, this._oracledb.fetchMemoryLimit);
+        rows = result.rows;
+        moreRows = result.moreRows;
+      } else if (!rows) {
+        rows = await this._getRows(fetchArraySize, closeOnFetch,
+          closeOnAllRowsFetched);
+      }
+      const numRows = (fetchColumns) ? getNumColumnRows(rows) : rows.length;
+      if (fetchColumns) {
+        for (let j = 0; j < nestedCursorIndices.length; j++) {
+          const values = rows[nestedCursorIndices[j]].values;
+          for (let i = 0; i < values.length; i++) {
+            if (values[i]) {
+              values[i] = await values[i]._getAllRows(executeOpts,
+                nestedCursorMetaDataObjs[j], true);
+            }
+          }
+        }
+        batches.push(rows);
+      } else if (nestedCursorIndices) {
         for (let i = 0; i < rows.length; i++) {
           const row = rows[i];
           for (let j = 0; j < nestedCursorIndices.length; j++) {
@@ -201,14 +563,17 @@ class ResultSet {
           }
         }
       }
-      if (rows) {
+      if (rows && !fetchColumns) {
         rowsFetched = rowsFetched.concat(rows);
       }
-      if (rows.length == maxRows || rows.length < fetchArraySize) {
+      if (moreRows === undefined) {
+        moreRows = (numRows >= fetchArraySize);
+      }
+      if (!moreRows || (maxRows > 0 && numRows >= maxRows)) {
         break;
       }
       if (maxRows > 0) {
-        maxRows -= rows.length;
+        maxRows -= numRows;
       }
     }
 
@@ -218,15 +583,67 @@ class ResultSet {
     if (!closeOnAllRowsFetched) {
       await this._close();
     }
-    return rowsFetched;
+    return (fetchColumns) ? concatColumns(batches) : rowsFetched;
   }
 
   _getDbObjectClassJS(schema, name) {
     return this._connection._getDbObjectClassJS(schema, name);
   }
 
-  toQueryStream() {
-    nodbUtil.checkArgCount(arguments, 0, 0);
+  _getRowConstructor(names) {
+    return getRowConstructor(names);
+  }
+
+  // returns whether rows are fetched as JSON text, which is the case when
+  // outFormat is OUT_FORMAT_JSON or OUT_FORMAT_NDJSON
+  _isJsonText() {
+    return (this._outFormat === this._oracledb.OUT_FORMAT_JSON ||
+        this._outFormat === this._oracledb.OUT_FORMAT_NDJSON);
+  }
+
+  // starts fetching the next fetchAhead batches of rows in a worker thread
+  // once the row cache holds less than a batch, so that the database round
+  // trip overlaps with the processing of the rows already returned; the rows
+  // are only moved into the row cache when they are requested and any error
+  // is reported at that time; the fetch is registered with the connection so
+  // that any other serialized operation on the connection waits for it to
+  // complete before starting
+  _startFetchAhead() {
+    if (this._fetchAheadPromise || !this._moreRows ||
+        this._rowCache.length >= this._fetchArraySize) {
+      return;
+    }
+    const fetchArraySize = this._fetchArraySize;
+    const connection = this._getConnection();
+    const promise = (async () => {
+      return await this._fetchAll(fetchArraySize,
+        fetchArraySize * this._fetchAhead, false,
+        this._oracledb.fetchMemoryLimit);
+    })();
+    connection._fetchAheads.set(this, promise);
+    promise.catch(() => {}).then(() => {
+      if (connection._fetchAheads.get(this) === promise)
+        connection._fetchAheads.delete(this);
+    });
+    this._fetchAheadPromise = promise;
+  }
+
+  // waits for any fetch ahead in progress to complete so that the result set
+  // can be closed; the rows and any error are discarded
+  async _waitForFetchAhead() {
+    if (this._fetchAheadPromise) {
+      const promise = this._fetchAheadPromise;
+      this._fetchAheadPromise = null;
+      await promise.catch(() => {});
+    }
+  }
+
+  toQueryStream(options) {
+    nodbUtil.checkArgCount(arguments, 0, 1);
+
+    if (options) {
+      nodbUtil.assert(nodbUtil.isObject(options), 'NJS-005', 1);
+    }
 
     if (this._processingStarted) {
       throw new Error(nodbUtil.getErrorMessage('NJS-041'));
@@ -236,9 +653,14 @@ class ResultSet {
       throw new Error(nodbUtil.getErrorMessage('NJS-043'));
     }
 
+    if (this._outFormat === this._oracledb.OUT_FORMAT_COLUMNS) {
+      throw new Error(nodbUtil.getErrorMessage('NJS-084'));
+    }
+
+    const stream = new QueryStream(this, options, 1);
     this._convertedToStream = true;
 
-    return new QueryStream(this);
+    return stream;
   }
 
 }
@@ -48,6 +48,7 @@ const errorMessages = {
   'NJS-002': 'NJS-002: invalid pool',
   'NJS-004': 'NJS-004: invalid value for property %s',
   'NJS-005': 'NJS-005: invalid value for parameter %d',
+  'NJS-007': 'NJS-007: invalid value for "%s" in parameter %d',
   'NJS-009': 'NJS-009: invalid number of parameters',
   'NJS-017': 'NJS-017: concurrent operations on ResultSet are not allowed',
   'NJS-023': 'NJS-023: concurrent operations on LOB are not allowed',
@@ -66,7 +67,9 @@ const errorMessages = {
   'NJS-076': 'NJS-076: connection request rejected. Pool queue length queueMax %d reached',
   'NJS-081': 'NJS-081: concurrent operations on a connection are disabled',
   'NJS-082': 'NJS-082: connection pool is being reconfigured',
-  'NJS-083': 'NJS-083: pool statistics not enabled'
+  'NJS-083': 'NJS-083: pool statistics not enabled',
+  'NJS-084': 'NJS-084: rows cannot be fetched individually when outFormat is OUT_FORMAT_COLUMNS, OUT_FORMAT_JSON or OUT_FORMAT_NDJSON',
+  'NJS-086': 'NJS-086: connection request deadline passed'
 };
 
 // getInstallURL returns a string with installation URL
@@ -202,9 +205,12 @@ function serialize(func) {
     // progress, and if so, waits for it to complete
     await connection._acquireLock();
 
-    // call the function and ensure that the lock is "released" once the
-    // function has completed -- either successfully or in failure
+    // call the function, once any fetch ahead of time started by another
+    // result set has completed, and ensure that the lock is "released" once
+    // the function has completed -- either successfully or in failure
     try {
+      if (connection._fetchAheads.size > 0)
+        await connection._waitForFetchAheads(this);
       return await func.apply(this, arguments);
     } finally {
       connection._releaseLock();
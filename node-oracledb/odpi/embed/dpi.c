@@ -47,5 +47,6 @@
 #include "../src/dpiSodaDocCursor.c"
 #include "../src/dpiStmt.c"
 #include "../src/dpiSubscr.c"
+#include "../src/dpiTrace.c"
 #include "../src/dpiUtils.c"
 #include "../src/dpiVar.c"
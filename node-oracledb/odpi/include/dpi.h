@@ -115,6 +115,7 @@ extern "C" {
 // 0x0010: reports on all SQL statements
 // 0x0020: reports on all memory allocations/frees
 // 0x0040: reports on all attempts to load the Oracle Client library
+// 0x0080: records public function calls in binary per-thread trace buffers
 #define DPI_DEBUG_LEVEL_UNREPORTED_ERRORS           0x0001
 #define DPI_DEBUG_LEVEL_REFS                        0x0002
 #define DPI_DEBUG_LEVEL_FNS                         0x0004
@@ -122,6 +123,10 @@ extern "C" {
 #define DPI_DEBUG_LEVEL_SQL                         0x0010
 #define DPI_DEBUG_LEVEL_MEM                         0x0020
 #define DPI_DEBUG_LEVEL_LOAD_LIB                    0x0040
+#define DPI_DEBUG_LEVEL_TRACE                       0x0080
+
+// define number of buckets in the latency histogram of each traced function
+#define DPI_TRACE_NUM_BUCKETS                       32
 
 
 //-----------------------------------------------------------------------------
@@ -393,6 +398,7 @@ typedef struct dpiMsgProps dpiMsgProps;
 // Forward Declarations of Other Types
 //-----------------------------------------------------------------------------
 typedef struct dpiAppContext dpiAppContext;
+typedef struct dpiColumnBuffer dpiColumnBuffer;
 typedef struct dpiCommonCreateParams dpiCommonCreateParams;
 typedef struct dpiConnCreateParams dpiConnCreateParams;
 typedef struct dpiContext dpiContext;
@@ -422,6 +428,7 @@ typedef struct dpiSubscrMessage dpiSubscrMessage;
 typedef struct dpiSubscrMessageQuery dpiSubscrMessageQuery;
 typedef struct dpiSubscrMessageRow dpiSubscrMessageRow;
 typedef struct dpiSubscrMessageTable dpiSubscrMessageTable;
+typedef struct dpiTraceStats dpiTraceStats;
 typedef struct dpiVersionInfo dpiVersionInfo;
 
 
@@ -576,6 +583,17 @@ struct dpiContextCreateParams {
     const char *oracleClientConfigDir;
 };
 
+// structure used for transferring a column of query data from ODPI-C
+struct dpiColumnBuffer {
+    dpiNativeTypeNum nativeTypeNum;
+    uint8_t *nullBitmap;
+    int64_t *asInt64;
+    double *asDouble;
+    uint32_t *offsets;
+    char *bytes;
+    uint32_t bytesLength;
+};
+
 // structure used for transferring data to/from ODPI-C
 struct dpiData {
     int isNull;
@@ -779,6 +797,17 @@ struct dpiSubscrMessageTable {
     uint32_t numRows;
 };
 
+// structure used for transferring the statistics of a traced function from
+// ODPI-C
+struct dpiTraceStats {
+    const char *fnName;
+    uint64_t numCalls;
+    uint64_t numFailures;
+    uint64_t totalNanoseconds;
+    uint64_t maxNanoseconds;
+    uint64_t latencyBuckets[DPI_TRACE_NUM_BUCKETS];
+};
+
 // structure used for transferring version information
 struct dpiVersionInfo {
     int versionNum;
@@ -815,6 +844,11 @@ DPI_EXPORT int dpiContext_getClientVersion(const dpiContext *context,
 DPI_EXPORT void dpiContext_getError(const dpiContext *context,
         dpiErrorInfo *errorInfo);
 
+// return the call counts and latency histograms of the public functions that
+// have been traced
+DPI_EXPORT int dpiContext_getTraceStats(const dpiContext *context,
+        uint32_t *numStats, dpiTraceStats *stats);
+
 // initialize context parameters to default values
 DPI_EXPORT int dpiContext_initCommonCreateParams(const dpiContext *context,
         dpiCommonCreateParams *params);
@@ -835,6 +869,10 @@ DPI_EXPORT int dpiContext_initSodaOperOptions(const dpiContext *context,
 DPI_EXPORT int dpiContext_initSubscrCreateParams(const dpiContext *context,
         dpiSubscrCreateParams *params);
 
+// write the contents of the trace buffers to a file for offline decoding
+DPI_EXPORT int dpiContext_writeTrace(const dpiContext *context,
+        const char *fileName, uint32_t fileNameLength);
+
 
 //-----------------------------------------------------------------------------
 // Connection Methods (dpiConn)
@@ -1870,6 +1908,14 @@ DPI_EXPORT int dpiStmt_executeMany(dpiStmt *stmt, dpiExecMode mode,
 DPI_EXPORT int dpiStmt_fetch(dpiStmt *stmt, int *found,
         uint32_t *bufferRowIndex);
 
+// transfer the rows that are available in the defined variables up to the
+// maximum specified directly into the column buffers supplied; this will
+// internally perform execute/array fetch only if no rows are available in the
+// defined variables and there are more rows available to fetch
+DPI_EXPORT int dpiStmt_fetchColumns(dpiStmt *stmt, uint32_t maxRows,
+        uint32_t numColumns, dpiColumnBuffer *columns,
+        uint32_t *numRowsFetched, int *moreRows);
+
 // return the number of rows that are available in the defined variables
 // up to the maximum specified; this will internally perform execute/array
 // fetch only if no rows are available in the defined variables and there are
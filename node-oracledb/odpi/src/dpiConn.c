@@ -137,16 +137,9 @@ static int dpiConn__close(dpiConn *conn, uint32_t mode, const char *tag,
             obj = (dpiObject*) conn->objects->handles[i];
             if (!obj)
                 continue;
-            if (conn->env->threaded) {
-                dpiMutex__acquire(conn->env->mutex);
-                status = dpiGen__checkHandle(obj, DPI_HTYPE_OBJECT, NULL,
-                        NULL);
-                if (status == DPI_SUCCESS)
-                    obj->refCount += 1;
-                dpiMutex__release(conn->env->mutex);
-                if (status < 0)
-                    continue;
-            }
+            if (conn->env->threaded &&
+                    dpiGen__addRefIfValid(obj, DPI_HTYPE_OBJECT) < 0)
+                continue;
             status = dpiObject__close(obj, propagateErrors, error);
             if (conn->env->threaded)
                 dpiGen__setRefCount(obj, error, -1);
@@ -165,15 +158,9 @@ static int dpiConn__close(dpiConn *conn, uint32_t mode, const char *tag,
             stmt = (dpiStmt*) conn->openStmts->handles[i];
             if (!stmt)
                 continue;
-            if (conn->env->threaded) {
-                dpiMutex__acquire(conn->env->mutex);
-                status = dpiGen__checkHandle(stmt, DPI_HTYPE_STMT, NULL, NULL);
-                if (status == DPI_SUCCESS)
-                    stmt->refCount += 1;
-                dpiMutex__release(conn->env->mutex);
-                if (status < 0)
-                    continue;
-            }
+            if (conn->env->threaded &&
+                    dpiGen__addRefIfValid(stmt, DPI_HTYPE_STMT) < 0)
+                continue;
             status = dpiStmt__close(stmt, NULL, 0, propagateErrors, error);
             if (conn->env->threaded)
                 dpiGen__setRefCount(stmt, error, -1);
@@ -191,15 +178,9 @@ static int dpiConn__close(dpiConn *conn, uint32_t mode, const char *tag,
             lob = (dpiLob*) conn->openLobs->handles[i];
             if (!lob)
                 continue;
-            if (conn->env->threaded) {
-                dpiMutex__acquire(conn->env->mutex);
-                status = dpiGen__checkHandle(lob, DPI_HTYPE_LOB, NULL, NULL);
-                if (status == DPI_SUCCESS)
-                    lob->refCount += 1;
-                dpiMutex__release(conn->env->mutex);
-                if (status < 0)
-                    continue;
-            }
+            if (conn->env->threaded &&
+                    dpiGen__addRefIfValid(lob, DPI_HTYPE_LOB) < 0)
+                continue;
             status = dpiLob__close(lob, propagateErrors, error);
             if (conn->env->threaded)
                 dpiGen__setRefCount(lob, error, -1);
@@ -1414,7 +1395,7 @@ int dpiConn_close(dpiConn *conn, dpiConnCloseMode mode, const char *tag,
 
     // validate parameters
     if (dpiGen__startPublicFn(conn, DPI_HTYPE_CONN, __func__, &error) < 0)
-        return DPI_FAILURE;
+        return dpiGen__endPublicFn(conn, DPI_FAILURE, &error);
     if (!conn->handle || conn->closing ||
             (conn->pool && !conn->pool->handle)) {
         dpiError__set(&error, "check connected", DPI_ERR_NOT_CONNECTED);
@@ -1431,14 +1412,9 @@ int dpiConn_close(dpiConn *conn, dpiConnCloseMode mode, const char *tag,
     }
 
     // determine whether connection is already being closed and if not, mark
-    // connection as being closed; this MUST be done while holding the lock
-    // (if in threaded mode) to avoid race conditions!
-    if (conn->env->threaded)
-        dpiMutex__acquire(conn->env->mutex);
-    closing = conn->closing;
-    conn->closing = 1;
-    if (conn->env->threaded)
-        dpiMutex__release(conn->env->mutex);
+    // connection as being closed; this MUST be done atomically to avoid race
+    // conditions!
+    closing = dpiAtomic__exchangeInt(&conn->closing, 1);
 
     // if connection is already being closed, raise an exception
     if (closing) {
@@ -1446,16 +1422,11 @@ int dpiConn_close(dpiConn *conn, dpiConnCloseMode mode, const char *tag,
         return dpiGen__endPublicFn(conn, DPI_FAILURE, &error);
     }
 
-    // if actual close fails, reset closing flag; again, this must be done
-    // while holding the lock (if in threaded mode) in order to avoid race
-    // conditions!
+    // if actual close fails, reset closing flag; this is done atomically
+    // as well
     if (dpiConn__close(conn, mode, tag, tagLength, propagateErrors,
             &error) < 0) {
-        if (conn->env->threaded)
-            dpiMutex__acquire(conn->env->mutex);
-        conn->closing = 0;
-        if (conn->env->threaded)
-            dpiMutex__release(conn->env->mutex);
+        dpiAtomic__storeInt(&conn->closing, 0);
         return dpiGen__endPublicFn(conn, DPI_FAILURE, &error);
     }
 
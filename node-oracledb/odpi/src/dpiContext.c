@@ -238,6 +238,8 @@ int dpiContext_destroy(dpiContext *context)
     if (dpiDebugLevel & DPI_DEBUG_LEVEL_FNS)
         (void) sprintf(message, "fn end %s(%p) -> %d", __func__, context,
                 DPI_SUCCESS);
+    if (dpiDebugLevel & DPI_DEBUG_LEVEL_TRACE)
+        dpiTrace__end(error.buffer, context, DPI_SUCCESS);
     dpiContext__free(context);
     if (dpiDebugLevel & DPI_DEBUG_LEVEL_FNS)
         dpiDebug__print("%s\n", message);
@@ -277,6 +279,30 @@ void dpiContext_getError(const dpiContext *context, dpiErrorInfo *info)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiContext_getTraceStats() [PUBLIC]
+//   Return the call counts and latency histograms of the public functions
+// that have been traced since the debug level DPI_DEBUG_LEVEL_TRACE was
+// enabled. On input numStats is the number of elements in the stats array; on
+// output it is the number of functions for which statistics are available.
+//-----------------------------------------------------------------------------
+int dpiContext_getTraceStats(const dpiContext *context, uint32_t *numStats,
+        dpiTraceStats *stats)
+{
+    dpiError error;
+
+    if (dpiGen__startPublicFn(context, DPI_HTYPE_CONTEXT, __func__,
+            &error) < 0)
+        return dpiGen__endPublicFn(context, DPI_FAILURE, &error);
+    DPI_CHECK_PTR_NOT_NULL(context, numStats)
+    if (*numStats > 0) {
+        DPI_CHECK_PTR_NOT_NULL(context, stats)
+    }
+    dpiTrace__getStats(numStats, stats);
+    return dpiGen__endPublicFn(context, DPI_SUCCESS, &error);
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiContext_initCommonCreateParams() [PUBLIC]
 //   Initialize the common connection/pool creation parameters to default
@@ -389,3 +415,30 @@ int dpiContext_initSubscrCreateParams(const dpiContext *context,
     dpiContext__initSubscrCreateParams(params);
     return dpiGen__endPublicFn(context, DPI_SUCCESS, &error);
 }
+
+
+//-----------------------------------------------------------------------------
+// dpiContext_writeTrace() [PUBLIC]
+//   Write the records held in the trace buffers of all threads to the
+// specified file so that they can be decoded offline.
+//-----------------------------------------------------------------------------
+int dpiContext_writeTrace(const dpiContext *context, const char *fileName,
+        uint32_t fileNameLength)
+{
+    char *tempFileName;
+    dpiError error;
+    int status;
+
+    if (dpiGen__startPublicFn(context, DPI_HTYPE_CONTEXT, __func__,
+            &error) < 0)
+        return dpiGen__endPublicFn(context, DPI_FAILURE, &error);
+    DPI_CHECK_PTR_NOT_NULL(context, fileName)
+    if (dpiUtils__allocateMemory(1, fileNameLength + 1, 0,
+            "allocate file name", (void**) &tempFileName, &error) < 0)
+        return dpiGen__endPublicFn(context, DPI_FAILURE, &error);
+    memcpy(tempFileName, fileName, fileNameLength);
+    tempFileName[fileNameLength] = '\0';
+    status = dpiTrace__write(tempFileName, &error);
+    dpiUtils__freeMemory(tempFileName);
+    return dpiGen__endPublicFn(context, status, &error);
+}
@@ -23,6 +23,16 @@
 #define DPI_MS_SECOND     1000      // ms per sec
 #define DPI_MS_FSECOND    1000000   // 1000 * 1000
 
+// Julian day number of January 1, 1970
+#define DPI_JULIAN_DAY_1970   2440588
+
+// forward declarations of internal functions only used in this file
+static int dpiDataBuffer__getEpochMs(int16_t year, uint8_t month, uint8_t day,
+        uint8_t hour, uint8_t minute, uint8_t second, uint32_t fsecond,
+        int32_t tzOffset, double *value);
+static int dpiDataBuffer__subtractBaseDate(dpiDataBuffer *data,
+        uint32_t dataType, dpiEnv *env, dpiError *error, void *oracleValue);
+
 
 //-----------------------------------------------------------------------------
 // dpiDataBuffer__fromOracleDate() [INTERNAL]
@@ -46,10 +56,43 @@ int dpiDataBuffer__fromOracleDate(dpiDataBuffer *data,
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiDataBuffer__fromOracleDateArrayAsDouble() [INTERNAL]
+//   Populate an array of data values from an array of dpiOciDate structures
+// as double values (number of milliseconds since January 1, 1970) in a single
+// pass. The null flag of each data value is expected to have been set
+// already; null values are skipped.
+//-----------------------------------------------------------------------------
+int dpiDataBuffer__fromOracleDateArrayAsDouble(dpiData *data,
+        dpiOciDate *oracleValues, uint32_t numValues, dpiEnv *env,
+        dpiError *error)
+{
+    dpiOciDate *oracleValue;
+    uint32_t i;
+
+    for (i = 0; i < numValues; i++) {
+        if (data[i].isNull)
+            continue;
+        oracleValue = &oracleValues[i];
+        if (dpiDataBuffer__getEpochMs(oracleValue->year, oracleValue->month,
+                oracleValue->day, oracleValue->hour, oracleValue->minute,
+                oracleValue->second, 0, 0, &data[i].value.asDouble))
+            continue;
+        if (dpiDataBuffer__fromOracleDateAsDouble(&data[i].value, env, error,
+                oracleValue) < 0)
+            return DPI_FAILURE;
+    }
+
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiDataBuffer__fromOracleDateAsDouble() [INTERNAL]
 //   Populate the data from an dpiOciDate structure as a double value (number
-// of milliseconds since January 1, 1970).
+// of milliseconds since January 1, 1970). The value is calculated directly
+// from the components of the date; OCI is only used for dates that cannot be
+// calculated that way.
 //-----------------------------------------------------------------------------
 int dpiDataBuffer__fromOracleDateAsDouble(dpiDataBuffer *data,
         dpiEnv *env, dpiError *error, dpiOciDate *oracleValue)
@@ -57,6 +100,12 @@ int dpiDataBuffer__fromOracleDateAsDouble(dpiDataBuffer *data,
     void *timestamp;
     int status;
 
+    // calculate the value directly, if possible
+    if (dpiDataBuffer__getEpochMs(oracleValue->year, oracleValue->month,
+            oracleValue->day, oracleValue->hour, oracleValue->minute,
+            oracleValue->second, 0, 0, &data->asDouble))
+        return DPI_SUCCESS;
+
     // allocate and populate a timestamp with the value of the date
     if (dpiOci__descriptorAlloc(env->handle, &timestamp,
             DPI_OCI_DTYPE_TIMESTAMP, "alloc timestamp", error) < 0)
@@ -69,8 +118,8 @@ int dpiDataBuffer__fromOracleDateAsDouble(dpiDataBuffer *data,
     }
 
     // now calculate the number of milliseconds since January 1, 1970
-    status = dpiDataBuffer__fromOracleTimestampAsDouble(data,
-            DPI_ORACLE_TYPE_TIMESTAMP, env, error, timestamp);
+    status = dpiDataBuffer__subtractBaseDate(data, DPI_ORACLE_TYPE_TIMESTAMP,
+            env, error, timestamp);
     dpiOci__descriptorFree(timestamp, DPI_OCI_DTYPE_TIMESTAMP);
     return status;
 }
@@ -105,6 +154,63 @@ int dpiDataBuffer__fromOracleIntervalYM(dpiDataBuffer *data, dpiEnv *env,
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiDataBuffer__fromOracleNumberArray() [INTERNAL]
+//   Populate an array of data values from an array of OCINumber structures
+// as doubles or integers in a single pass. The null flag of each data value
+// is expected to have been set already; null values are skipped. Values are
+// decoded directly and OCI is only called for those that cannot be decoded
+// exactly.
+//-----------------------------------------------------------------------------
+int dpiDataBuffer__fromOracleNumberArray(dpiData *data,
+        dpiOciNumber *oracleValues, uint32_t numValues,
+        dpiNativeTypeNum nativeTypeNum, dpiError *error)
+{
+    uint32_t i;
+
+    switch (nativeTypeNum) {
+        case DPI_NATIVE_TYPE_DOUBLE:
+            for (i = 0; i < numValues; i++) {
+                if (data[i].isNull || dpiUtils__decodeOracleNumberAsDouble(
+                        &oracleValues[i], &data[i].value.asDouble))
+                    continue;
+                if (dpiOci__numberToReal(&data[i].value.asDouble,
+                        &oracleValues[i], error) < 0)
+                    return DPI_FAILURE;
+            }
+            break;
+        case DPI_NATIVE_TYPE_INT64:
+            for (i = 0; i < numValues; i++) {
+                if (data[i].isNull || dpiUtils__decodeOracleNumberAsInteger(
+                        &oracleValues[i], 0, &data[i].value.asUint64))
+                    continue;
+                if (dpiOci__numberToInt(&oracleValues[i],
+                        &data[i].value.asInt64, sizeof(int64_t),
+                        DPI_OCI_NUMBER_SIGNED, error) < 0)
+                    return DPI_FAILURE;
+            }
+            break;
+        case DPI_NATIVE_TYPE_UINT64:
+            for (i = 0; i < numValues; i++) {
+                if (data[i].isNull || dpiUtils__decodeOracleNumberAsInteger(
+                        &oracleValues[i], 1, &data[i].value.asUint64))
+                    continue;
+                if (dpiOci__numberToInt(&oracleValues[i],
+                        &data[i].value.asUint64, sizeof(uint64_t),
+                        DPI_OCI_NUMBER_UNSIGNED, error) < 0)
+                    return DPI_FAILURE;
+            }
+            break;
+        default:
+            return dpiError__set(error, "decode number array",
+                    DPI_ERR_UNHANDLED_CONVERSION, DPI_ORACLE_TYPE_NUMBER,
+                    nativeTypeNum);
+    }
+
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiDataBuffer__fromOracleNumberAsDouble() [INTERNAL]
 //   Populate the data from an OCINumber structure as a double.
@@ -112,6 +218,8 @@ int dpiDataBuffer__fromOracleIntervalYM(dpiDataBuffer *data, dpiEnv *env,
 int dpiDataBuffer__fromOracleNumberAsDouble(dpiDataBuffer *data,
         dpiError *error, void *oracleValue)
 {
+    if (dpiUtils__decodeOracleNumberAsDouble(oracleValue, &data->asDouble))
+        return DPI_SUCCESS;
     return dpiOci__numberToReal(&data->asDouble, oracleValue, error);
 }
 
@@ -123,6 +231,9 @@ int dpiDataBuffer__fromOracleNumberAsDouble(dpiDataBuffer *data,
 int dpiDataBuffer__fromOracleNumberAsInteger(dpiDataBuffer *data,
         dpiError *error, void *oracleValue)
 {
+    if (dpiUtils__decodeOracleNumberAsInteger(oracleValue, 0,
+            &data->asUint64))
+        return DPI_SUCCESS;
     return dpiOci__numberToInt(oracleValue, &data->asInt64, sizeof(int64_t),
             DPI_OCI_NUMBER_SIGNED, error);
 }
@@ -135,6 +246,9 @@ int dpiDataBuffer__fromOracleNumberAsInteger(dpiDataBuffer *data,
 int dpiDataBuffer__fromOracleNumberAsUnsignedInteger(dpiDataBuffer *data,
         dpiError *error, void *oracleValue)
 {
+    if (dpiUtils__decodeOracleNumberAsInteger(oracleValue, 1,
+            &data->asUint64))
+        return DPI_SUCCESS;
     return dpiOci__numberToInt(oracleValue, &data->asUint64, sizeof(uint64_t),
             DPI_OCI_NUMBER_UNSIGNED, error);
 }
@@ -278,6 +392,39 @@ int dpiDataBuffer__fromOracleTimestamp(dpiDataBuffer *data, dpiEnv *env,
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiDataBuffer__fromOracleTimestampArrayAsDouble() [INTERNAL]
+//   Populate an array of data values from an array of OCIDateTime structures
+// as double values (number of milliseconds since January 1, 1970) in a single
+// pass. The null flag of each data value is expected to have been set
+// already; null values are skipped. The session time zone offset used for
+// timestamps with local time zone is only looked up once for the array.
+//-----------------------------------------------------------------------------
+int dpiDataBuffer__fromOracleTimestampArrayAsDouble(dpiData *data,
+        uint32_t dataType, void **oracleValues, uint32_t numValues,
+        dpiEnv *env, dpiError *error)
+{
+    int isFixed = 1;
+    int32_t offset = 0;
+    uint32_t i;
+
+    if (dataType == DPI_ORACLE_TYPE_TIMESTAMP_LTZ &&
+            dpiEnv__getLocalTimeZoneOffset(env, &isFixed, &offset,
+                    error) < 0)
+        return DPI_FAILURE;
+    for (i = 0; i < numValues; i++) {
+        if (data[i].isNull)
+            continue;
+        if (dpiDataBuffer__fromOracleTimestampWithOffsetAsDouble(
+                &data[i].value, dataType, env, error, oracleValues[i],
+                isFixed, offset) < 0)
+            return DPI_FAILURE;
+    }
+
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiDataBuffer__fromOracleTimestampAsDouble() [INTERNAL]
 //   Populate the data from an OCIDateTime structure as a double value (number
@@ -285,6 +432,113 @@ int dpiDataBuffer__fromOracleTimestamp(dpiDataBuffer *data, dpiEnv *env,
 //-----------------------------------------------------------------------------
 int dpiDataBuffer__fromOracleTimestampAsDouble(dpiDataBuffer *data,
         uint32_t dataType, dpiEnv *env, dpiError *error, void *oracleValue)
+{
+    int isFixed = 1;
+    int32_t offset = 0;
+
+    if (dataType == DPI_ORACLE_TYPE_TIMESTAMP_LTZ &&
+            dpiEnv__getLocalTimeZoneOffset(env, &isFixed, &offset,
+                    error) < 0)
+        return DPI_FAILURE;
+    return dpiDataBuffer__fromOracleTimestampWithOffsetAsDouble(data,
+            dataType, env, error, oracleValue, isFixed, offset);
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiDataBuffer__fromOracleTimestampWithOffsetAsDouble() [INTERNAL]
+//   Populate the data from an OCIDateTime structure as a double value (number
+// of milliseconds since January 1, 1970). The components of the timestamp are
+// acquired from OCI and the value is calculated directly from them, which
+// avoids the allocation of an interval and the date arithmetic otherwise
+// required. Timestamps with time zone are adjusted by their own offset;
+// timestamps with local time zone are adjusted by the supplied session time
+// zone offset, if it is fixed. OCI is used to perform the calculation for
+// dates that cannot be calculated directly.
+//-----------------------------------------------------------------------------
+int dpiDataBuffer__fromOracleTimestampWithOffsetAsDouble(dpiDataBuffer *data,
+        uint32_t dataType, dpiEnv *env, dpiError *error, void *oracleValue,
+        int isFixed, int32_t offset)
+{
+    int8_t tzHourOffset, tzMinuteOffset;
+    uint8_t month, day, hour, minute, second;
+    uint32_t fsecond;
+    int16_t year;
+
+    // acquire the components of the timestamp
+    if (dpiOci__dateTimeGetDate(env->handle, oracleValue, &year, &month, &day,
+            error) < 0)
+        return DPI_FAILURE;
+    if (dpiOci__dateTimeGetTime(env->handle, oracleValue, &hour, &minute,
+            &second, &fsecond, error) < 0)
+        return DPI_FAILURE;
+
+    // acquire the time zone offset, if applicable
+    if (dataType == DPI_ORACLE_TYPE_TIMESTAMP) {
+        offset = 0;
+    } else if (dataType == DPI_ORACLE_TYPE_TIMESTAMP_TZ || !isFixed) {
+        if (dpiOci__dateTimeGetTimeZoneOffset(env->handle, oracleValue,
+                &tzHourOffset, &tzMinuteOffset, error) < 0)
+            return DPI_FAILURE;
+        offset = tzHourOffset * 60 + tzMinuteOffset;
+    }
+
+    // calculate the value directly, if possible
+    if (dpiDataBuffer__getEpochMs(year, month, day, hour, minute, second,
+            fsecond, offset, &data->asDouble))
+        return DPI_SUCCESS;
+    return dpiDataBuffer__subtractBaseDate(data, dataType, env, error,
+            oracleValue);
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiDataBuffer__getEpochMs() [INTERNAL]
+//   Calculate the number of milliseconds since January 1, 1970 for the given
+// date and time, adjusted by the given time zone offset (in minutes), in the
+// same way that OCI date arithmetic does: the Julian calendar is used for
+// dates prior to October 15, 1582 and fractional milliseconds are truncated
+// toward zero. Dates prior to year 1 are not calculated and 0 is returned in
+// that case; otherwise, 1 is returned.
+//-----------------------------------------------------------------------------
+static int dpiDataBuffer__getEpochMs(int16_t year, uint8_t month, uint8_t day,
+        uint8_t hour, uint8_t minute, uint8_t second, uint32_t fsecond,
+        int32_t tzOffset, double *value)
+{
+    int64_t julianDay, ms, y, m;
+
+    if (year < 1)
+        return 0;
+
+    // calculate the Julian day number, using March as the first month of the
+    // year so that the leap day is the last day of the year
+    y = (int64_t) year + 4800 - (month < 3);
+    m = (int64_t) month + ((month < 3) ? 9 : -3);
+    julianDay = day + (153 * m + 2) / 5 + 365 * y + y / 4 - 32083;
+    if (year > 1582 || (year == 1582 && (month > 10 ||
+            (month == 10 && day >= 15))))
+        julianDay += 38 - y / 100 + y / 400;
+
+    // calculate milliseconds since January 1, 1970
+    ms = (julianDay - DPI_JULIAN_DAY_1970) * DPI_MS_DAY + hour * DPI_MS_HOUR +
+            minute * DPI_MS_MINUTE + second * DPI_MS_SECOND -
+            (int64_t) tzOffset * DPI_MS_MINUTE;
+    if (ms < 0)
+        ms += (fsecond + DPI_MS_FSECOND - 1) / DPI_MS_FSECOND;
+    else ms += fsecond / DPI_MS_FSECOND;
+    *value = (double) ms;
+    return 1;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiDataBuffer__subtractBaseDate() [INTERNAL]
+//   Populate the data from an OCIDateTime structure as a double value (number
+// of milliseconds since January 1, 1970) by subtracting the base date using
+// OCI date arithmetic.
+//-----------------------------------------------------------------------------
+static int dpiDataBuffer__subtractBaseDate(dpiDataBuffer *data,
+        uint32_t dataType, dpiEnv *env, dpiError *error, void *oracleValue)
 {
     int32_t day, hour, minute, second, fsecond;
     void *interval, *baseDate;
@@ -156,9 +156,10 @@ void dpiDebug__initialize(void)
     // messages are written to stderr
     dpiDebugStream = stderr;
 
-    // for any debugging level > 0 print a message indicating that tracing
-    // has started
-    if (dpiDebugLevel) {
+    // for any debugging level which prints messages, print a message
+    // indicating that tracing has started; binary tracing alone (intended to
+    // be left enabled in production) prints nothing
+    if (dpiDebugLevel & ~DPI_DEBUG_LEVEL_TRACE) {
         dpiDebug__print("ODPI-C %s\n", DPI_VERSION_STRING);
         dpiDebug__print("debugging messages initialized at level %lu\n",
                 dpiDebugLevel);
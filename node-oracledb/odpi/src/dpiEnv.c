@@ -118,6 +118,70 @@ int dpiEnv__getEncodingInfo(dpiEnv *env, dpiEncodingInfo *info)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiEnv__getLocalTimeZoneOffset() [INTERNAL]
+//   Return the offset (in minutes) of the session time zone, which is used for
+// values of type TIMESTAMP WITH LOCAL TIME ZONE. The offset is sampled in
+// January and July of each decade from 1900 to 2100 the first time this is
+// called and the result is cached on the environment. If the samples are not
+// all the same (the time zone observes daylight saving time or has changed
+// its offset) the offset is not fixed and must be acquired for each value
+// instead.
+//-----------------------------------------------------------------------------
+int dpiEnv__getLocalTimeZoneOffset(dpiEnv *env, int *isFixed,
+        int32_t *offset, dpiError *error)
+{
+    int8_t tzHourOffset, tzMinuteOffset;
+    int32_t sampleOffset, firstOffset;
+    int status, fixed;
+    uint8_t month;
+    int16_t year;
+    void *sample;
+
+    if (!env->ltzOffsetChecked) {
+        if (dpiOci__descriptorAlloc(env->handle, &sample,
+                DPI_OCI_DTYPE_TIMESTAMP_LTZ, "alloc offset sample",
+                error) < 0)
+            return DPI_FAILURE;
+        status = DPI_SUCCESS;
+        firstOffset = 0;
+        fixed = 1;
+        for (year = 1900; fixed && year <= 2100; year += 10) {
+            for (month = 1; fixed && month <= 7; month += 6) {
+                status = dpiOci__dateTimeConstruct(env->handle, sample, year,
+                        month, 1, 0, 0, 0, 0, NULL, 0, error);
+                if (status == DPI_SUCCESS)
+                    status = dpiOci__dateTimeGetTimeZoneOffset(env->handle,
+                            sample, &tzHourOffset, &tzMinuteOffset, error);
+                if (status < 0)
+                    break;
+                sampleOffset = tzHourOffset * 60 + tzMinuteOffset;
+                if (year == 1900 && month == 1)
+                    firstOffset = sampleOffset;
+                else if (sampleOffset != firstOffset)
+                    fixed = 0;
+            }
+            if (status < 0)
+                break;
+        }
+        dpiOci__descriptorFree(sample, DPI_OCI_DTYPE_TIMESTAMP_LTZ);
+        if (status < 0)
+            return DPI_FAILURE;
+        if (env->threaded)
+            dpiMutex__acquire(env->mutex);
+        env->ltzOffset = firstOffset;
+        env->ltzOffsetFixed = fixed;
+        env->ltzOffsetChecked = 1;
+        if (env->threaded)
+            dpiMutex__release(env->mutex);
+    }
+
+    *isFixed = env->ltzOffsetFixed;
+    *offset = env->ltzOffset;
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiEnv__init() [INTERNAL]
 //   Initialize the environment structure. If an external handle is provided it
@@ -59,9 +59,7 @@ int dpiError__getInfo(dpiError *error, dpiErrorInfo *info)
 //-----------------------------------------------------------------------------
 int dpiError__initHandle(dpiError *error)
 {
-    if (dpiHandlePool__acquire(error->env->errorHandles, &error->handle,
-            error) < 0)
-        return DPI_FAILURE;
+    dpiHandlePool__acquire(error->env->errorHandles, &error->handle);
     if (!error->handle) {
         if (dpiOci__handleAlloc(error->env->handle, &error->handle,
                 DPI_OCI_HTYPE_ERROR, "allocate OCI error", error) < 0)
@@ -82,6 +80,7 @@ int dpiError__set(dpiError *error, const char *action, dpiErrorNum errorNum,
     va_list varArgs;
 
     if (error) {
+        error->buffer->hasInfo = 1;
         error->buffer->code = 0;
         error->buffer->isRecoverable = 0;
         error->buffer->isWarning = 0;
@@ -164,6 +164,37 @@ int dpiGen__addRef(void *ptr, dpiHandleTypeNum typeNum, const char *fnName)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiGen__addRefIfValid() [INTERNAL]
+//   Add a reference to the handle, but only if it is valid and its reference
+// count has not already reached zero in another thread. This is used when
+// acquiring handles from lists which do not hold references to them. The
+// reference count is only increased if it is non-zero so that a handle
+// which is in the process of being freed is never revived.
+//-----------------------------------------------------------------------------
+int dpiGen__addRefIfValid(void *ptr, dpiHandleTypeNum typeNum)
+{
+    dpiBaseType *value = (dpiBaseType*) ptr;
+    int localRefCount;
+
+    if (dpiGen__checkHandle(ptr, typeNum, NULL, NULL) < 0)
+        return DPI_FAILURE;
+    localRefCount = dpiAtomic__loadInt(&value->refCount);
+    while (1) {
+        if (localRefCount <= 0)
+            return DPI_FAILURE;
+        if (dpiAtomic__compareExchangeInt(&value->refCount, localRefCount,
+                localRefCount + 1))
+            break;
+        localRefCount = dpiAtomic__loadInt(&value->refCount);
+    }
+    if (dpiDebugLevel & DPI_DEBUG_LEVEL_REFS)
+        dpiDebug__print("ref %p (%s) -> %d\n", ptr, value->typeDef->name,
+                localRefCount + 1);
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiGen__allocate() [INTERNAL]
 //   Allocate memory for the specified type and initialize the base fields. The
@@ -229,6 +260,8 @@ int dpiGen__endPublicFn(const void *ptr, int returnValue, dpiError *error)
     if (dpiDebugLevel & DPI_DEBUG_LEVEL_FNS)
         dpiDebug__print("fn end %s(%p) -> %d\n", error->buffer->fnName, ptr,
                 returnValue);
+    if (dpiDebugLevel & DPI_DEBUG_LEVEL_TRACE)
+        dpiTrace__end(error->buffer, ptr, returnValue);
     if (error->handle)
         dpiHandlePool__release(error->env->errorHandles, &error->handle);
 
@@ -257,27 +290,22 @@ int dpiGen__release(void *ptr, dpiHandleTypeNum typeNum, const char *fnName)
 //-----------------------------------------------------------------------------
 // dpiGen__setRefCount() [INTERNAL]
 //   Increase or decrease the reference count by the given amount. The handle
-// is assumed to be valid at this point. If the environment is in threaded
-// mode, acquire the mutex first before making any adjustments to the reference
-// count. If the operation sets the reference count to zero, release all
-// resources and free the memory associated with the structure.
+// is assumed to be valid at this point. The reference count is adjusted
+// atomically so no lock is required, even in threaded mode. If the operation
+// sets the reference count to zero, release all resources and free the memory
+// associated with the structure.
 //-----------------------------------------------------------------------------
 void dpiGen__setRefCount(void *ptr, dpiError *error, int increment)
 {
     dpiBaseType *value = (dpiBaseType*) ptr;
-    unsigned localRefCount;
+    int localRefCount;
 
-    // if threaded need to protect modification of the refCount with a mutex;
-    // also ensure that if the reference count reaches zero that it is
-    // immediately marked invalid in order to avoid race conditions
-    if (value->env->threaded)
-        dpiMutex__acquire(value->env->mutex);
-    value->refCount += increment;
-    localRefCount = value->refCount;
+    // only the thread that sets the reference count to zero sees that value;
+    // that thread marks the handle invalid; once zero, the reference count is
+    // never increased again (see dpiGen__addRefIfValid())
+    localRefCount = dpiAtomic__addInt(&value->refCount, increment);
     if (localRefCount == 0)
         dpiUtils__clearMemory(&value->checkInt, sizeof(value->checkInt));
-    if (value->env->threaded)
-        dpiMutex__release(value->env->mutex);
 
     // reference count debugging
     if (dpiDebugLevel & DPI_DEBUG_LEVEL_REFS)
@@ -306,6 +334,8 @@ int dpiGen__startPublicFn(const void *ptr, dpiHandleTypeNum typeNum,
         dpiDebug__print("fn start %s(%p)\n", fnName, ptr);
     if (dpiGlobal__initError(fnName, error) < 0)
         return DPI_FAILURE;
+    if (dpiDebugLevel & DPI_DEBUG_LEVEL_TRACE)
+        dpiTrace__start(error->buffer, fnName, ptr);
     if (dpiGen__checkHandle(ptr, typeNum, "check main handle", error) < 0)
         return DPI_FAILURE;
     error->env = value->env;
@@ -46,6 +46,9 @@ static void *dpiGlobalEnvHandle = NULL;
 static void *dpiGlobalErrorHandle = NULL;
 static void *dpiGlobalThreadKey = NULL;
 static dpiErrorBuffer dpiGlobalErrorBuffer;
+#ifdef DPI_THREAD_LOCAL
+static DPI_THREAD_LOCAL dpiErrorBuffer *dpiGlobalThreadErrorBuffer = NULL;
+#endif
 static dpiVersionInfo dpiGlobalClientVersionInfo;
 static int dpiGlobalInitialized = 0;
 
@@ -57,6 +60,7 @@ static dpiMutexType dpiGlobalMutex;
 static int dpiGlobal__extendedInitialize(dpiContextCreateParams *params,
         dpiError *error);
 static void dpiGlobal__finalize(void);
+static void dpiGlobal__freeErrorBuffer(void *errorBuffer);
 static int dpiGlobal__getErrorBuffer(const char *fnName, dpiError *error);
 
 
@@ -128,7 +132,7 @@ static int dpiGlobal__extendedInitialize(dpiContextCreateParams *params,
 
     // create global thread key
     status = dpiOci__threadKeyInit(dpiGlobalEnvHandle, dpiGlobalErrorHandle,
-            &dpiGlobalThreadKey, (void*) dpiUtils__freeMemory, error);
+            &dpiGlobalThreadKey, (void*) dpiGlobal__freeErrorBuffer, error);
     if (status < 0) {
         dpiOci__handleFree(dpiGlobalEnvHandle, DPI_OCI_HTYPE_ENV);
         return DPI_FAILURE;
@@ -154,13 +158,16 @@ static void dpiGlobal__finalize(void)
     dpiMutex__acquire(dpiGlobalMutex);
     dpiGlobalInitialized = 0;
     error.buffer = &dpiGlobalErrorBuffer;
+#ifdef DPI_THREAD_LOCAL
+    dpiGlobalThreadErrorBuffer = NULL;
+#endif
     if (dpiGlobalThreadKey) {
         dpiOci__threadKeyGet(dpiGlobalEnvHandle, dpiGlobalErrorHandle,
                 dpiGlobalThreadKey, &errorBuffer, &error);
         if (errorBuffer) {
             dpiOci__threadKeySet(dpiGlobalEnvHandle, dpiGlobalErrorHandle,
                     dpiGlobalThreadKey, NULL, &error);
-            dpiUtils__freeMemory(errorBuffer);
+            dpiGlobal__freeErrorBuffer(errorBuffer);
         }
         dpiOci__threadKeyDestroy(dpiGlobalEnvHandle, dpiGlobalErrorHandle,
                 &dpiGlobalThreadKey, &error);
@@ -174,48 +181,84 @@ static void dpiGlobal__finalize(void)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiGlobal__freeErrorBuffer() [INTERNAL]
+//   Free the error buffer for a thread. This is called by the OCI thread key
+// when the thread exits. The trace buffer used by the thread, if any, is
+// released so that another thread can use it.
+//-----------------------------------------------------------------------------
+static void dpiGlobal__freeErrorBuffer(void *errorBuffer)
+{
+    dpiErrorBuffer *tempErrorBuffer = (dpiErrorBuffer*) errorBuffer;
+
+    if (tempErrorBuffer->traceBuffer)
+        dpiTrace__releaseBuffer(tempErrorBuffer->traceBuffer);
+    dpiUtils__freeMemory(tempErrorBuffer);
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiGlobal__getErrorBuffer() [INTERNAL]
 //   Get the thread local error buffer. This will replace use of the global
 // error buffer which is used until this function has completed successfully.
 // At this point it is assumed that the global infrastructure has been
-// initialialized successfully.
+// initialialized successfully. The OCI thread key owns the error buffer (and
+// frees it when the thread exits); if the compiler supports thread-local
+// variables, the buffer is also cached in one so that the OCI thread key only
+// needs to be consulted once per thread.
 //-----------------------------------------------------------------------------
 static int dpiGlobal__getErrorBuffer(const char *fnName, dpiError *error)
 {
     dpiErrorBuffer *tempErrorBuffer;
 
-    // look up the error buffer specific to this thread
-    if (dpiOci__threadKeyGet(dpiGlobalEnvHandle, dpiGlobalErrorHandle,
-            dpiGlobalThreadKey, (void**) &tempErrorBuffer, error) < 0)
-        return DPI_FAILURE;
-
-    // if NULL, key has never been set for this thread, allocate new error
-    // buffer and set it
+#ifdef DPI_THREAD_LOCAL
+    tempErrorBuffer = dpiGlobalThreadErrorBuffer;
     if (!tempErrorBuffer) {
-        if (dpiUtils__allocateMemory(1, sizeof(dpiErrorBuffer), 1,
-                "allocate error buffer", (void**) &tempErrorBuffer, error) < 0)
-            return DPI_FAILURE;
-        if (dpiOci__threadKeySet(dpiGlobalEnvHandle, dpiGlobalErrorHandle,
-                dpiGlobalThreadKey, tempErrorBuffer, error) < 0) {
-            dpiUtils__freeMemory(tempErrorBuffer);
+#endif
+
+        // look up the error buffer specific to this thread
+        if (dpiOci__threadKeyGet(dpiGlobalEnvHandle, dpiGlobalErrorHandle,
+                dpiGlobalThreadKey, (void**) &tempErrorBuffer, error) < 0)
             return DPI_FAILURE;
+
+        // if NULL, key has never been set for this thread, allocate new error
+        // buffer and set it
+        if (!tempErrorBuffer) {
+            if (dpiUtils__allocateMemory(1, sizeof(dpiErrorBuffer), 1,
+                    "allocate error buffer", (void**) &tempErrorBuffer,
+                    error) < 0)
+                return DPI_FAILURE;
+            strcpy(tempErrorBuffer->encoding, DPI_CHARSET_NAME_UTF8);
+            if (dpiOci__threadKeySet(dpiGlobalEnvHandle, dpiGlobalErrorHandle,
+                    dpiGlobalThreadKey, tempErrorBuffer, error) < 0) {
+                dpiUtils__freeMemory(tempErrorBuffer);
+                return DPI_FAILURE;
+            }
         }
+
+#ifdef DPI_THREAD_LOCAL
+        dpiGlobalThreadErrorBuffer = tempErrorBuffer;
     }
+#endif
 
     // if a function name has been specified, clear error
     // the only time a function name is not specified is for
-    // dpiContext_getError() when the error information is being retrieved
+    // dpiContext_getError() when the error information is being retrieved;
+    // the error information itself only needs to be cleared if it has been
+    // populated since it was last cleared
     if (fnName) {
-        tempErrorBuffer->code = 0;
-        tempErrorBuffer->offset = 0;
-        tempErrorBuffer->errorNum = (dpiErrorNum) 0;
-        tempErrorBuffer->isRecoverable = 0;
-        tempErrorBuffer->messageLength = 0;
+        if (tempErrorBuffer->hasInfo) {
+            tempErrorBuffer->code = 0;
+            tempErrorBuffer->offset = 0;
+            tempErrorBuffer->errorNum = (dpiErrorNum) 0;
+            tempErrorBuffer->isRecoverable = 0;
+            tempErrorBuffer->messageLength = 0;
+            tempErrorBuffer->isWarning = 0;
+            strcpy(tempErrorBuffer->encoding, DPI_CHARSET_NAME_UTF8);
+            tempErrorBuffer->hasInfo = 0;
+        }
         tempErrorBuffer->fnName = fnName;
         tempErrorBuffer->action = "start";
-        tempErrorBuffer->isWarning = 0;
-        strcpy(tempErrorBuffer->encoding, DPI_CHARSET_NAME_UTF8);
     }
 
     error->buffer = tempErrorBuffer;
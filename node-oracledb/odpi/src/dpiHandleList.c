@@ -18,45 +18,27 @@
 
 #include "dpiImpl.h"
 
+// forward declarations of internal functions only used in this file
+static int dpiHandleList__expand(dpiHandleList *list, uint32_t numSlots,
+        dpiError *error);
+
+
 //-----------------------------------------------------------------------------
 // dpiHandleList__addHandle() [INTERNAL]
-//   Add a handle to the list. The list is expanded in sets of 8 handles as
-// needed. A current position is maintained to reduce the number of scans of
-// the list are required. An empty slot is designated by a NULL pointer.
+//   Add a handle to the list. The most recently emptied slot is reused if one
+// is available; otherwise, the list is doubled in size. An empty slot is
+// designated by a NULL pointer.
 //-----------------------------------------------------------------------------
 int dpiHandleList__addHandle(dpiHandleList *list, void *handle,
         uint32_t *slotNum, dpiError *error)
 {
-    uint32_t numSlots, i;
-    void **tempHandles;
-
     dpiMutex__acquire(list->mutex);
-    if (list->numUsedSlots == list->numSlots) {
-        numSlots = list->numSlots + 8;
-        if (dpiUtils__allocateMemory(numSlots, sizeof(void*), 1,
-                "allocate slots", (void**) &tempHandles, error) < 0) {
-            dpiMutex__release(list->mutex);
-            return DPI_FAILURE;
-        }
-        memcpy(tempHandles, list->handles, list->numSlots * sizeof(void*));
-        dpiUtils__freeMemory(list->handles);
-        list->handles = tempHandles;
-        list->numSlots = numSlots;
-        *slotNum = list->numUsedSlots++;
-        list->currentPos = list->numUsedSlots;
-    } else {
-        for (i = 0; i < list->numSlots; i++) {
-            if (!list->handles[list->currentPos])
-                break;
-            list->currentPos++;
-            if (list->currentPos == list->numSlots)
-                list->currentPos = 0;
-        }
-        list->numUsedSlots++;
-        *slotNum = list->currentPos++;
-        if (list->currentPos == list->numSlots)
-            list->currentPos = 0;
+    if (list->numFreeSlots == 0 &&
+            dpiHandleList__expand(list, list->numSlots * 2, error) < 0) {
+        dpiMutex__release(list->mutex);
+        return DPI_FAILURE;
     }
+    *slotNum = list->freeSlotNums[--list->numFreeSlots];
     list->handles[*slotNum] = handle;
     dpiMutex__release(list->mutex);
     return DPI_SUCCESS;
@@ -71,23 +53,56 @@ int dpiHandleList__create(dpiHandleList **list, dpiError *error)
 {
     dpiHandleList *tempList;
 
-    if (dpiUtils__allocateMemory(1, sizeof(dpiHandleList), 0,
+    if (dpiUtils__allocateMemory(1, sizeof(dpiHandleList), 1,
             "allocate handle list", (void**) &tempList, error) < 0)
         return DPI_FAILURE;
-    tempList->numSlots = 8;
-    tempList->numUsedSlots = 0;
-    if (dpiUtils__allocateMemory(tempList->numSlots, sizeof(void*), 1,
-            "allocate handle list slots", (void**) &tempList->handles,
-            error) < 0) {
-        dpiUtils__freeMemory(tempList);
+    dpiMutex__initialize(tempList->mutex);
+    if (dpiHandleList__expand(tempList, 8, error) < 0) {
+        dpiHandleList__free(tempList);
         return DPI_FAILURE;
     }
-    dpiMutex__initialize(tempList->mutex);
-    tempList->currentPos = 0;
     *list = tempList;
     return DPI_SUCCESS;
 }
 
+
+//-----------------------------------------------------------------------------
+// dpiHandleList__expand() [INTERNAL]
+//   Expand the list to the specified number of slots. The new slots are empty
+// and are pushed onto the stack of free slots so that the lowest numbered
+// slots are used first.
+//-----------------------------------------------------------------------------
+static int dpiHandleList__expand(dpiHandleList *list, uint32_t numSlots,
+        dpiError *error)
+{
+    uint32_t *tempFreeSlotNums, i;
+    void **tempHandles;
+
+    if (dpiUtils__allocateMemory(numSlots, sizeof(void*), 1,
+            "allocate slots", (void**) &tempHandles, error) < 0)
+        return DPI_FAILURE;
+    if (dpiUtils__allocateMemory(numSlots, sizeof(uint32_t), 0,
+            "allocate free slot numbers", (void**) &tempFreeSlotNums,
+            error) < 0) {
+        dpiUtils__freeMemory(tempHandles);
+        return DPI_FAILURE;
+    }
+    if (list->handles) {
+        memcpy(tempHandles, list->handles, list->numSlots * sizeof(void*));
+        memcpy(tempFreeSlotNums, list->freeSlotNums,
+                list->numFreeSlots * sizeof(uint32_t));
+        dpiUtils__freeMemory(list->handles);
+        dpiUtils__freeMemory(list->freeSlotNums);
+    }
+    for (i = numSlots; i > list->numSlots; i--)
+        tempFreeSlotNums[list->numFreeSlots++] = i - 1;
+    list->handles = tempHandles;
+    list->freeSlotNums = tempFreeSlotNums;
+    list->numSlots = numSlots;
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiHandleList__free() [INTERNAL]
 //   Free the memory associated with the handle list.
@@ -98,6 +113,10 @@ void dpiHandleList__free(dpiHandleList *list)
         dpiUtils__freeMemory(list->handles);
         list->handles = NULL;
     }
+    if (list->freeSlotNums) {
+        dpiUtils__freeMemory(list->freeSlotNums);
+        list->freeSlotNums = NULL;
+    }
     dpiMutex__destroy(list->mutex);
     dpiUtils__freeMemory(list);
 }
@@ -105,12 +124,13 @@ void dpiHandleList__free(dpiHandleList *list)
 
 //-----------------------------------------------------------------------------
 // dpiHandleList__removeHandle() [INTERNAL]
-//   Remove the handle at the specified location from the list.
+//   Remove the handle at the specified location from the list. The slot is
+// pushed onto the stack of free slots so that it is the next one reused.
 //-----------------------------------------------------------------------------
 void dpiHandleList__removeHandle(dpiHandleList *list, uint32_t slotNum)
 {
     dpiMutex__acquire(list->mutex);
     list->handles[slotNum] = NULL;
-    list->numUsedSlots--;
+    list->freeSlotNums[list->numFreeSlots++] = slotNum;
     dpiMutex__release(list->mutex);
 }
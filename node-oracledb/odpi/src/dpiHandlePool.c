@@ -12,51 +12,99 @@
 //-----------------------------------------------------------------------------
 // dpiHandlePool.c
 //   Implementation of a pool of handles which can be acquired and released in
-// a thread-safe manner. The pool is a circular queue where handles are
-// acquired from the front and released to the back.
+// a thread-safe manner without taking any locks. Each thread is mapped to a
+// slot in the pool which caches the last handle released by that thread.
+// Handles which cannot be placed in the slot are pushed onto an overflow stack
+// shared by all threads.
+//
+// The stacks are only ever popped by atomically detaching the entire stack
+// and then pushing back the nodes that were not wanted. Since a node is never
+// removed from the middle of a stack that another thread may be examining,
+// the stacks are not subject to the ABA problem of classic lock-free stacks.
 //-----------------------------------------------------------------------------
 
 #include "dpiImpl.h"
 
+// forward declarations of internal functions only used in this file
+static void dpiHandlePool__pushNodes(dpiAtomicPtr *stack,
+        dpiHandlePoolNode *firstNode, dpiHandlePoolNode *lastNode);
+
 //-----------------------------------------------------------------------------
-// dpiHandlePool__acquire() [INTERNAL]
-//   Acquire a handle from the pool. If a handle is available, it will be
-// cleared out of the pool and returned to the caller. It is the caller's
-// responsibility to return the handle back to the pool when it is finished
-// with it. If no handle is available, a NULL value is returned. The caller is
-// expected to create a new handle and return it to the pool when it is
-// finished with it.
-//-----------------------------------------------------------------------------
-int dpiHandlePool__acquire(dpiHandlePool *pool, void **handle, dpiError *error)
+// dpiHandlePool__getSlot() [INTERNAL]
+//   Return the slot to which the calling thread is mapped. The thread
+// identifier is hashed so that identifiers which are multiples of a page size
+// or other power of 2 are still spread evenly across the slots.
+//-----------------------------------------------------------------------------
+static dpiHandlePoolSlot *dpiHandlePool__getSlot(dpiHandlePool *pool)
 {
-    void **tempHandles;
-    uint32_t numSlots;
-
-    dpiMutex__acquire(pool->mutex);
-    if (pool->acquirePos != pool->releasePos) {
-        *handle = pool->handles[pool->acquirePos];
-        pool->handles[pool->acquirePos++] = NULL;
-        if (pool->acquirePos == pool->numSlots)
-            pool->acquirePos = 0;
-    } else {
-        *handle = NULL;
-        pool->numUsedSlots++;
-        if (pool->numUsedSlots > pool->numSlots) {
-            numSlots = pool->numSlots + 8;
-            if (dpiUtils__allocateMemory(numSlots, sizeof(void*), 1,
-                    "allocate slots", (void**) &tempHandles, error) < 0) {
-                dpiMutex__release(pool->mutex);
-                return DPI_FAILURE;
-            }
-            memcpy(tempHandles, pool->handles, pool->numSlots * sizeof(void*));
-            dpiUtils__freeMemory(pool->handles);
-            pool->handles = tempHandles;
-            pool->numSlots = numSlots;
-        }
+    uint64_t hash;
+
+    hash = dpiThread__getId() * 0x9E3779B97F4A7C15ULL;
+    return &pool->slots[(hash >> 32) & (DPI_HANDLE_POOL_NUM_SLOTS - 1)];
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiHandlePool__popNode() [INTERNAL]
+//   Pop a node from the specified stack. NULL is returned if the stack is
+// empty or if another thread has temporarily detached the whole stack in order
+// to pop a node from it. In the latter case the caller simply behaves as
+// though the stack was empty.
+//-----------------------------------------------------------------------------
+static dpiHandlePoolNode *dpiHandlePool__popNode(dpiAtomicPtr *stack)
+{
+    dpiHandlePoolNode *node = NULL, *lastNode;
+
+    while (!node && dpiAtomic__loadPtr(stack))
+        node = (dpiHandlePoolNode*) dpiAtomic__exchangePtr(stack, NULL);
+    if (node && node->next) {
+        for (lastNode = node->next; lastNode->next; lastNode = lastNode->next);
+        dpiHandlePool__pushNodes(stack, node->next, lastNode);
     }
-    dpiMutex__release(pool->mutex);
+    return node;
+}
 
-    return DPI_SUCCESS;
+
+//-----------------------------------------------------------------------------
+// dpiHandlePool__pushNodes() [INTERNAL]
+//   Push the chain of nodes onto the specified stack.
+//-----------------------------------------------------------------------------
+static void dpiHandlePool__pushNodes(dpiAtomicPtr *stack,
+        dpiHandlePoolNode *firstNode, dpiHandlePoolNode *lastNode)
+{
+    dpiHandlePoolNode *topNode;
+
+    do {
+        topNode = (dpiHandlePoolNode*) dpiAtomic__loadPtr(stack);
+        lastNode->next = topNode;
+    } while (!dpiAtomic__compareExchangePtr(stack, topNode, firstNode));
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiHandlePool__acquire() [INTERNAL]
+//   Acquire a handle from the pool. The handle cached in the slot for the
+// calling thread is returned if one is available; otherwise, a handle is taken
+// from the overflow stack. It is the caller's responsibility to return the
+// handle back to the pool when it is finished with it. If no handle is
+// available, a NULL value is returned. The caller is expected to create a new
+// handle and return it to the pool when it is finished with it.
+//-----------------------------------------------------------------------------
+void dpiHandlePool__acquire(dpiHandlePool *pool, void **handle)
+{
+    dpiHandlePoolSlot *slot;
+    dpiHandlePoolNode *node;
+
+    slot = dpiHandlePool__getSlot(pool);
+    *handle = dpiAtomic__exchangePtr(&slot->handle, NULL);
+    if (*handle)
+        return;
+    node = dpiHandlePool__popNode(&pool->overflow);
+    if (node) {
+        *handle = node->handle;
+        node->handle = NULL;
+        dpiHandlePool__pushNodes(&pool->freeNodes, node, node);
+    }
 }
 
 
@@ -68,35 +116,32 @@ int dpiHandlePool__create(dpiHandlePool **pool, dpiError *error)
 {
     dpiHandlePool *tempPool;
 
-    if (dpiUtils__allocateMemory(1, sizeof(dpiHandlePool), 0,
+    if (dpiUtils__allocateMemory(1, sizeof(dpiHandlePool), 1,
             "allocate handle pool", (void**) &tempPool, error) < 0)
         return DPI_FAILURE;
-    tempPool->numSlots = 8;
-    tempPool->numUsedSlots = 0;
-    if (dpiUtils__allocateMemory(tempPool->numSlots, sizeof(void*), 1,
-            "allocate handle pool slots", (void**) &tempPool->handles,
-            error) < 0) {
-        dpiUtils__freeMemory(tempPool);
-        return DPI_FAILURE;
-    }
-    dpiMutex__initialize(tempPool->mutex);
-    tempPool->acquirePos = 0;
-    tempPool->releasePos = 0;
     *pool = tempPool;
     return DPI_SUCCESS;
 }
 
 //-----------------------------------------------------------------------------
 // dpiHandlePool__free() [INTERNAL]
-//   Free the memory associated with the error pool.
+//   Free the memory associated with the error pool. The handles themselves
+// are not freed; they are freed when the parent environment handle is freed.
 //-----------------------------------------------------------------------------
 void dpiHandlePool__free(dpiHandlePool *pool)
 {
-    if (pool->handles) {
-        dpiUtils__freeMemory(pool->handles);
-        pool->handles = NULL;
+    dpiHandlePoolNode *node;
+
+    while (pool->overflow) {
+        node = (dpiHandlePoolNode*) pool->overflow;
+        pool->overflow = node->next;
+        dpiUtils__freeMemory(node);
+    }
+    while (pool->freeNodes) {
+        node = (dpiHandlePoolNode*) pool->freeNodes;
+        pool->freeNodes = node->next;
+        dpiUtils__freeMemory(node);
     }
-    dpiMutex__destroy(pool->mutex);
     dpiUtils__freeMemory(pool);
 }
 
@@ -104,16 +149,29 @@ void dpiHandlePool__free(dpiHandlePool *pool)
 //-----------------------------------------------------------------------------
 // dpiHandlePool__release() [INTERNAL]
 //   Release a handle back to the pool. No checks are performed on the handle
-// that is being returned to the pool; It will simply be placed back in the
-// pool. The handle is then NULLed in order to avoid multiple attempts to
-// release the handle back to the pool.
+// that is being returned to the pool; it is placed in the slot for the
+// calling thread if that slot is empty and otherwise pushed onto the overflow
+// stack. If memory for an overflow node cannot be allocated, the handle is
+// simply left to be freed when the parent environment handle is freed. The
+// handle is then NULLed in order to avoid multiple attempts to release the
+// handle back to the pool.
 //-----------------------------------------------------------------------------
 void dpiHandlePool__release(dpiHandlePool *pool, void **handle)
 {
-    dpiMutex__acquire(pool->mutex);
-    pool->handles[pool->releasePos++] = *handle;
+    dpiHandlePoolNode *node;
+    dpiHandlePoolSlot *slot;
+    void *emptyHandle = NULL;
+
+    slot = dpiHandlePool__getSlot(pool);
+    if (!dpiAtomic__compareExchangePtr(&slot->handle, emptyHandle, *handle)) {
+        node = dpiHandlePool__popNode(&pool->freeNodes);
+        if (!node)
+            dpiUtils__allocateMemory(1, sizeof(dpiHandlePoolNode), 0,
+                    "allocate handle pool node", (void**) &node, NULL);
+        if (node) {
+            node->handle = *handle;
+            dpiHandlePool__pushNodes(&pool->overflow, node, node);
+        }
+    }
     *handle = NULL;
-    if (pool->releasePos == pool->numSlots)
-        pool->releasePos = 0;
-    dpiMutex__release(pool->mutex);
 }
@@ -50,6 +50,7 @@
 #include <errno.h>
 #include <pthread.h>
 #include <sys/time.h>
+#include <time.h>
 #include <dlfcn.h>
 #endif
 #ifdef __linux
@@ -75,6 +76,19 @@
 #define UNUSED
 #endif
 
+// define storage class for thread-local variables, if the compiler supports
+// them; if not (or if DPI_NO_THREAD_LOCAL is defined) OCI thread keys are used
+// instead
+#ifndef DPI_NO_THREAD_LOCAL
+#if defined(_MSC_VER)
+#define DPI_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define DPI_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define DPI_THREAD_LOCAL __thread
+#endif
+#endif
+
 // define debugging level (defined in dpiGlobal.c)
 extern unsigned long dpiDebugLevel;
 
@@ -93,6 +107,10 @@ extern unsigned long dpiDebugLevel;
 // define maximum number of digits possible in an Oracle number
 #define DPI_NUMBER_MAX_DIGITS                       40
 
+// define largest integer for which all smaller integers are exactly
+// representable as a double (2^53)
+#define DPI_MAX_EXACT_DOUBLE_INT                    9007199254740992ULL
+
 // define maximum size in bytes supported by basic string handling
 #define DPI_MAX_BASIC_BUFFER_SIZE                   32767
 
@@ -108,6 +126,28 @@ extern unsigned long dpiDebugLevel;
 // define number of rows to prefetch
 #define DPI_PREFETCH_ROWS_DEFAULT                   2
 
+// define number of per-thread slots in a handle pool (must be a power of 2)
+#define DPI_HANDLE_POOL_NUM_SLOTS                   64
+
+// define size of a cache line; used to keep data written by different threads
+// on separate cache lines
+#define DPI_CACHE_LINE_SIZE                         64
+
+// define number of records in each per-thread trace buffer and the maximum
+// number of distinct functions that can be traced (both must be a power of 2)
+#define DPI_TRACE_NUM_RECORDS                       4096
+#define DPI_TRACE_MAX_FNS                           512
+
+// define maximum depth of nested public function calls that are timed
+#define DPI_TRACE_MAX_DEPTH                         8
+
+// define function identifier used when the table of traced functions is full
+#define DPI_TRACE_UNKNOWN_FN_ID                     0xFFFF
+
+// define types of trace records
+#define DPI_TRACE_RECORD_START                      1
+#define DPI_TRACE_RECORD_END                        2
+
 // define default load error URL
 #if defined _WIN32 || defined __CYGWIN__
     #define DPI_ERR_LOAD_URL_FRAGMENT   "#windows"
@@ -654,6 +694,78 @@ typedef enum {
 #endif
 
 
+//-----------------------------------------------------------------------------
+// Atomic operation definitions; C11 atomics are used if the compiler supports
+// them and compiler intrinsics otherwise; all operations are sequentially
+// consistent; for compare and exchange operations the expected value must be
+// an lvalue which may be overwritten with the current value if the comparison
+// fails; the result is true if the exchange took place
+//-----------------------------------------------------------------------------
+#if defined(_WIN32)
+    typedef LONG volatile dpiAtomicInt;
+    typedef PVOID volatile dpiAtomicPtr;
+    #define dpiAtomic__loadInt(p)       InterlockedCompareExchange((p), 0, 0)
+    #define dpiAtomic__storeInt(p, v)   InterlockedExchange((p), (LONG) (v))
+    #define dpiAtomic__exchangeInt(p, v) \
+        InterlockedExchange((p), (LONG) (v))
+    #define dpiAtomic__addInt(p, v) \
+        (InterlockedExchangeAdd((p), (LONG) (v)) + (LONG) (v))
+    #define dpiAtomic__compareExchangeInt(p, e, v) \
+        (InterlockedCompareExchange((p), (LONG) (v), (LONG) (e)) == (LONG) (e))
+    #define dpiAtomic__loadPtr(p) \
+        InterlockedCompareExchangePointer((p), NULL, NULL)
+    #define dpiAtomic__exchangePtr(p, v) \
+        InterlockedExchangePointer((p), (PVOID) (v))
+    #define dpiAtomic__compareExchangePtr(p, e, v) \
+        (InterlockedCompareExchangePointer((p), (PVOID) (v), (PVOID) (e)) == \
+                (PVOID) (e))
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+        !defined(__STDC_NO_ATOMICS__)
+    #include <stdatomic.h>
+    typedef atomic_int dpiAtomicInt;
+    typedef _Atomic(void*) dpiAtomicPtr;
+    #define dpiAtomic__loadInt(p)       atomic_load(p)
+    #define dpiAtomic__storeInt(p, v)   atomic_store((p), (v))
+    #define dpiAtomic__exchangeInt(p, v) atomic_exchange((p), (v))
+    #define dpiAtomic__addInt(p, v)     (atomic_fetch_add((p), (v)) + (v))
+    #define dpiAtomic__compareExchangeInt(p, e, v) \
+        atomic_compare_exchange_strong((p), &(e), (v))
+    #define dpiAtomic__loadPtr(p)       atomic_load(p)
+    #define dpiAtomic__exchangePtr(p, v) atomic_exchange((p), (void*) (v))
+    #define dpiAtomic__compareExchangePtr(p, e, v) \
+        atomic_compare_exchange_strong((p), (void**) &(e), (void*) (v))
+#else
+    typedef int dpiAtomicInt;
+    typedef void *dpiAtomicPtr;
+    #define dpiAtomic__loadInt(p)       __atomic_load_n((p), __ATOMIC_SEQ_CST)
+    #define dpiAtomic__storeInt(p, v) \
+        __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+    #define dpiAtomic__exchangeInt(p, v) \
+        __atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
+    #define dpiAtomic__addInt(p, v) \
+        __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+    #define dpiAtomic__compareExchangeInt(p, e, v) \
+        __atomic_compare_exchange_n((p), &(e), (v), 0, __ATOMIC_SEQ_CST, \
+                __ATOMIC_SEQ_CST)
+    #define dpiAtomic__loadPtr(p)       __atomic_load_n((p), __ATOMIC_SEQ_CST)
+    #define dpiAtomic__exchangePtr(p, v) \
+        __atomic_exchange_n((p), (void*) (v), __ATOMIC_SEQ_CST)
+    #define dpiAtomic__compareExchangePtr(p, e, v) \
+        __atomic_compare_exchange_n((p), (void**) &(e), (void*) (v), 0, \
+                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Thread definitions
+//-----------------------------------------------------------------------------
+#ifdef _WIN32
+    #define dpiThread__getId()          ((uint64_t) GetCurrentThreadId())
+#else
+    #define dpiThread__getId()          ((uint64_t) (uintptr_t) pthread_self())
+#endif
+
+
 //-----------------------------------------------------------------------------
 // old type definitions (to be dropped)
 //-----------------------------------------------------------------------------
@@ -951,30 +1063,77 @@ struct dpiJznDomScalar {
 // a connection (so that they can be closed before the connection itself is
 // closed); the functions for managing this structure can be found in the file
 // dpiHandleList.c; empty slots in the array are represented by a NULL handle
+// and their slot numbers are kept on a stack so that they can be reused
+// without searching the array
 typedef struct {
     void **handles;                     // array of handles managed by list
+    uint32_t *freeSlotNums;             // stack of empty slot numbers
     uint32_t numSlots;                  // length of handles array
-    uint32_t numUsedSlots;              // actual number of managed handles
-    uint32_t currentPos;                // next position to search
+    uint32_t numFreeSlots;              // number of entries in free stack
     dpiMutexType mutex;                 // enables thread safety
 } dpiHandleList;
 
-// used to manage a pool of shared handles in a thread-safe manner; currently
-// used for managing the pool of error handles in the dpiEnv structure; the
-// functions for managing this structure are found in the file dpiHandlePool.c
+// used to hold a handle in the overflow stack of a handle pool
+typedef struct dpiHandlePoolNode {
+    void *handle;                       // handle held by the node
+    struct dpiHandlePoolNode *next;     // next node in the stack
+} dpiHandlePoolNode;
+
+// used to hold the handle cached for a thread in a handle pool; each slot is
+// kept on its own cache line so that threads do not contend with each other
 typedef struct {
-    void **handles;                     // array of handles managed by pool
-    uint32_t numSlots;                  // length of handles array
-    uint32_t numUsedSlots;              // actual number of managed handles
-    uint32_t acquirePos;                // position from which to acquire
-    uint32_t releasePos;                // position to place released handles
-    dpiMutexType mutex;                 // enables thread safety
+    dpiAtomicPtr handle;                // cached handle or NULL
+    char padding[DPI_CACHE_LINE_SIZE - sizeof(dpiAtomicPtr)];
+} dpiHandlePoolSlot;
+
+// used to manage a pool of shared handles in a thread-safe manner without
+// locks; currently used for managing the pool of error handles in the dpiEnv
+// structure; each thread is mapped to a slot which caches the handle it last
+// released; handles which do not fit in the slot are placed on a lock-free
+// stack shared by all threads; the functions for managing this structure are
+// found in the file dpiHandlePool.c
+typedef struct {
+    dpiHandlePoolSlot slots[DPI_HANDLE_POOL_NUM_SLOTS];     // per thread
+    dpiAtomicPtr overflow;              // stack of nodes holding handles
+    dpiAtomicPtr freeNodes;             // stack of nodes available for reuse
 } dpiHandlePool;
 
+// used to record the start or end of a public function call in a trace
+// buffer; the layout is fixed (32 bytes) so that the records written to a
+// trace file can be decoded offline
+typedef struct {
+    uint64_t timestamp;                 // monotonic time in nanoseconds
+    uint64_t threadId;                  // thread which made the call
+    uint64_t handle;                    // handle passed to the function
+    uint16_t fnId;                      // identifier of traced function
+    uint8_t recordType;                 // start or end of call
+    int8_t status;                      // return value (end of call only)
+    uint32_t depth;                     // depth of nested calls
+} dpiTraceRecord;
+
+// used to record the public function calls made by a thread; the records are
+// written to a ring buffer and the statistics are accumulated for each
+// function; these buffers are never freed but are released for use by another
+// thread when the thread using them exits
+typedef struct dpiTraceBuffer {
+    struct dpiTraceBuffer *next;        // next buffer in list of all buffers
+    dpiAtomicInt inUse;                 // is buffer in use by a thread?
+    uint64_t threadId;                  // thread using the buffer
+    uint64_t numRecords;                // number of records ever written
+    uint32_t depth;                     // depth of nested calls in progress
+    uint16_t fnIds[DPI_TRACE_MAX_DEPTH];    // functions in progress
+    uint64_t startTimes[DPI_TRACE_MAX_DEPTH];   // start times of calls
+    dpiTraceRecord records[DPI_TRACE_NUM_RECORDS];  // ring buffer of records
+    dpiTraceStats stats[DPI_TRACE_MAX_FNS];     // statistics by function
+} dpiTraceBuffer;
+
 // used to save error information internally; one of these is stored for each
 // thread using OCIThreadKeyGet() and OCIThreadKeySet() with a globally created
-// OCI environment handle; it is also used when getting batch error information
-// with the function dpiStmt_getBatchErrors()
+// OCI environment handle (and cached in a thread-local variable, if the
+// compiler supports them); it is also used when getting batch error
+// information with the function dpiStmt_getBatchErrors(); the error
+// information is only cleared at the start of a public function if it has
+// been populated since it was last cleared
 typedef struct {
     int32_t code;                       // Oracle error code or 0
     uint32_t offset;                    // parse error offset or row offset
@@ -986,6 +1145,8 @@ typedef struct {
     uint32_t messageLength;             // length of message in buffer
     int isRecoverable;                  // is recoverable?
     int isWarning;                      // is a warning?
+    int hasInfo;                        // populated since last cleared?
+    dpiTraceBuffer *traceBuffer;        // trace buffer for thread (or NULL)
 } dpiErrorBuffer;
 
 // represents an OCI environment; a pointer to this structure is stored on each
@@ -997,7 +1158,7 @@ typedef struct {
 typedef struct {
     const dpiContext *context;          // context used to create environment
     void *handle;                       // OCI environment handle
-    dpiMutexType mutex;                 // for reference count (threaded mode)
+    dpiMutexType mutex;                 // for shared state (threaded mode)
     char encoding[DPI_OCI_NLS_MAXBUFSZ];    // CHAR encoding (IANA name)
     int32_t maxBytesPerCharacter;       // max bytes per CHAR character
     uint16_t charsetId;                 // CHAR encoding (Oracle charset ID)
@@ -1009,6 +1170,9 @@ typedef struct {
     void *baseDate;                     // timestamp
     void *baseDateTZ;                   // timestamp with time zone
     void *baseDateLTZ;                  // timestamp with local time zone
+    int32_t ltzOffset;                  // fixed session time zone offset
+    int ltzOffsetFixed;                 // session time zone offset fixed?
+    int ltzOffsetChecked;               // session time zone offset checked?
     int threaded;                       // threaded mode enabled?
     int events;                         // events mode enabled?
     int externalHandle;                 // external handle?
@@ -1043,7 +1207,7 @@ typedef struct {
 #define dpiType_HEAD \
     const dpiTypeDef *typeDef; \
     uint32_t checkInt; \
-    unsigned refCount; \
+    dpiAtomicInt refCount; \
     dpiEnv *env;
 
 // contains the base attributes that all handles exposed publicly have; generic
@@ -1242,7 +1406,7 @@ struct dpiConn {
     int deadSession;                    // dead session (drop from pool)?
     int standalone;                     // standalone connection (not pooled)?
     int creating;                       // connection is being created?
-    int closing;                        // connection is being closed?
+    dpiAtomicInt closing;               // connection is being closed?
 };
 
 // represents the context in which all activity in the library takes place; the
@@ -1275,6 +1439,7 @@ struct dpiStmt {
     uint32_t allocatedBindVars;         // number of allocated bind variables
     uint32_t numBindVars;               // actual nubmer of bind variables
     dpiBindVar *bindVars;               // array of bind variables
+    uint32_t *bindVarIndex;             // hash index into bind variables
     uint32_t numBatchErrors;            // number of batch errors
     dpiErrorBuffer *batchErrors;        // array of batch errors
     uint64_t rowCount;                  // rows affected or rows fetched so far
@@ -1287,7 +1452,8 @@ struct dpiStmt {
     int scrollable;                     // scrollable cursor?
     int isReturning;                    // statement has RETURNING clause?
     int deleteFromCache;                // drop from statement cache on close?
-    int closing;                        // statement is being closed?
+    dpiAtomicInt closing;               // statement is being closed?
+    uint32_t numDeferredPostFetchVars;  // leading vars not yet post fetched
 };
 
 // represents memory areas used for transferring data to and from the database
@@ -1336,7 +1502,7 @@ struct dpiLob {
     const dpiOracleType *type;          // type of LOB
     void *locator;                      // OCI LOB locator descriptor
     char *buffer;                       // stores dir alias/name for BFILE
-    int closing;                        // is LOB being closed?
+    dpiAtomicInt closing;               // is LOB being closed?
 };
 
 // represents object attributes of the types created by the SQL command CREATE
@@ -1379,7 +1545,7 @@ struct dpiObject {
     void *indicator;                    // OCI indicator
     dpiObject *dependsOnObj;            // extracted from parent obj, or NULL
     int freeIndicator;                  // should indicator be freed?
-    int closing;                        // is object being closed?
+    dpiAtomicInt closing;               // is object being closed?
 };
 
 // represents the unique identifier of a row in Oracle Database and is exposed
@@ -1515,12 +1681,18 @@ void dpiContext__initSubscrCreateParams(dpiSubscrCreateParams *params);
 //-----------------------------------------------------------------------------
 int dpiDataBuffer__fromOracleDate(dpiDataBuffer *data,
         dpiOciDate *oracleValue);
+int dpiDataBuffer__fromOracleDateArrayAsDouble(dpiData *data,
+        dpiOciDate *oracleValues, uint32_t numValues, dpiEnv *env,
+        dpiError *error);
 int dpiDataBuffer__fromOracleDateAsDouble(dpiDataBuffer *data,
         dpiEnv *env, dpiError *error, dpiOciDate *oracleValue);
 int dpiDataBuffer__fromOracleIntervalDS(dpiDataBuffer *data, dpiEnv *env,
         dpiError *error, void *oracleValue);
 int dpiDataBuffer__fromOracleIntervalYM(dpiDataBuffer *data, dpiEnv *env,
         dpiError *error, void *oracleValue);
+int dpiDataBuffer__fromOracleNumberArray(dpiData *data,
+        dpiOciNumber *oracleValues, uint32_t numValues,
+        dpiNativeTypeNum nativeTypeNum, dpiError *error);
 int dpiDataBuffer__fromOracleNumberAsDouble(dpiDataBuffer *data,
         dpiError *error, void *oracleValue);
 int dpiDataBuffer__fromOracleNumberAsInteger(dpiDataBuffer *data,
@@ -1531,8 +1703,14 @@ int dpiDataBuffer__fromOracleNumberAsUnsignedInteger(dpiDataBuffer *data,
         dpiError *error, void *oracleValue);
 int dpiDataBuffer__fromOracleTimestamp(dpiDataBuffer *data, dpiEnv *env,
         dpiError *error, void *oracleValue, int withTZ);
+int dpiDataBuffer__fromOracleTimestampArrayAsDouble(dpiData *data,
+        uint32_t dataType, void **oracleValues, uint32_t numValues,
+        dpiEnv *env, dpiError *error);
 int dpiDataBuffer__fromOracleTimestampAsDouble(dpiDataBuffer *data,
         uint32_t dataType, dpiEnv *env, dpiError *error, void *oracleValue);
+int dpiDataBuffer__fromOracleTimestampWithOffsetAsDouble(dpiDataBuffer *data,
+        uint32_t dataType, dpiEnv *env, dpiError *error, void *oracleValue,
+        int isFixed, int32_t offset);
 int dpiDataBuffer__toOracleDate(dpiDataBuffer *data, dpiOciDate *oracleValue);
 int dpiDataBuffer__toOracleDateFromDouble(dpiDataBuffer *data, dpiEnv *env,
         dpiError *error, dpiOciDate *oracleValue);
@@ -1564,6 +1742,8 @@ int dpiEnv__init(dpiEnv *env, const dpiContext *context,
 int dpiEnv__getBaseDate(dpiEnv *env, uint32_t dataType, void **baseDate,
         dpiError *error);
 int dpiEnv__getEncodingInfo(dpiEnv *env, dpiEncodingInfo *info);
+int dpiEnv__getLocalTimeZoneOffset(dpiEnv *env, int *isFixed,
+        int32_t *offset, dpiError *error);
 
 
 //-----------------------------------------------------------------------------
@@ -1582,6 +1762,7 @@ int dpiError__setFromOS(dpiError *error, const char *action);
 // definition of internal dpiGen methods
 //-----------------------------------------------------------------------------
 int dpiGen__addRef(void *ptr, dpiHandleTypeNum typeNum, const char *fnName);
+int dpiGen__addRefIfValid(void *ptr, dpiHandleTypeNum typeNum);
 int dpiGen__allocate(dpiHandleTypeNum typeNum, dpiEnv *env, void **handle,
         dpiError *error);
 int dpiGen__checkHandle(const void *ptr, dpiHandleTypeNum typeNum,
@@ -1660,6 +1841,8 @@ int dpiVar__allocate(dpiConn *conn, dpiOracleTypeNum oracleTypeNum,
         dpiNativeTypeNum nativeTypeNum, uint32_t maxArraySize, uint32_t size,
         int sizeIsBytes, int isArray, dpiObjectType *objType, dpiVar **var,
         dpiData **data, dpiError *error);
+int dpiVar__checkColumnBuffer(dpiVar *var, dpiColumnBuffer *column,
+        uint32_t startRow, uint32_t *numRows, dpiError *error);
 int dpiVar__convertToLob(dpiVar *var, dpiError *error);
 int dpiVar__copyData(dpiVar *var, uint32_t pos, dpiData *sourceData,
         dpiError *error);
@@ -1672,6 +1855,9 @@ void dpiVar__free(dpiVar *var, dpiError *error);
 int32_t dpiVar__inBindCallback(dpiVar *var, void *bindp, uint32_t iter,
         uint32_t index, void **bufpp, uint32_t *alenp, uint8_t *piecep,
         void **indpp);
+int dpiVar__getColumnBuffer(dpiVar *var, dpiColumnBuffer *column,
+        uint32_t startRow, uint32_t numRows, dpiError *error);
+int dpiVar__getColumnValues(dpiVar *var, uint32_t numRows, dpiError *error);
 int dpiVar__getValue(dpiVar *var, dpiVarBuffer *buffer, uint32_t pos,
         int inFetch, dpiError *error);
 int dpiVar__setValue(dpiVar *var, dpiVarBuffer *buffer, uint32_t pos,
@@ -2127,8 +2313,7 @@ void dpiMsgProps__free(dpiMsgProps *props, dpiError *error);
 //-----------------------------------------------------------------------------
 // definition of internal dpiHandlePool methods
 //-----------------------------------------------------------------------------
-int dpiHandlePool__acquire(dpiHandlePool *pool, void **handle,
-        dpiError *error);
+void dpiHandlePool__acquire(dpiHandlePool *pool, void **handle);
 int dpiHandlePool__create(dpiHandlePool **pool, dpiError *error);
 void dpiHandlePool__free(dpiHandlePool *pool);
 void dpiHandlePool__release(dpiHandlePool *pool, void **handle);
@@ -2144,6 +2329,17 @@ void dpiHandleList__free(dpiHandleList *list);
 void dpiHandleList__removeHandle(dpiHandleList *list, uint32_t slotNum);
 
 
+//-----------------------------------------------------------------------------
+// definition of internal dpiTrace methods
+//-----------------------------------------------------------------------------
+void dpiTrace__end(dpiErrorBuffer *buffer, const void *handle, int status);
+void dpiTrace__getStats(uint32_t *numStats, dpiTraceStats *stats);
+void dpiTrace__releaseBuffer(dpiTraceBuffer *traceBuffer);
+void dpiTrace__start(dpiErrorBuffer *buffer, const char *fnName,
+        const void *handle);
+int dpiTrace__write(const char *fileName, dpiError *error);
+
+
 //-----------------------------------------------------------------------------
 // definition of internal dpiUtils methods
 //-----------------------------------------------------------------------------
@@ -2157,6 +2353,12 @@ int dpiUtils__checkClientVersionMulti(dpiVersionInfo *versionInfo,
 int dpiUtils__checkDatabaseVersion(dpiConn *conn, int minVersionNum,
         int minReleaseNum, dpiError *error);
 void dpiUtils__clearMemory(void *ptr, size_t length);
+int dpiUtils__decodeOracleNumber(const void *oracleValue, int *isNegative,
+        uint64_t *mantissa, int16_t *exponent);
+int dpiUtils__decodeOracleNumberAsDouble(const void *oracleValue,
+        double *value);
+int dpiUtils__decodeOracleNumberAsInteger(const void *oracleValue,
+        int isUnsigned, uint64_t *value);
 int dpiUtils__ensureBuffer(size_t desiredSize, const char *action,
         void **ptr, size_t *currentSize, dpiError *error);
 void dpiUtils__freeMemory(void *ptr);
@@ -72,14 +72,9 @@ int dpiLob__close(dpiLob *lob, int propagateErrors, dpiError *error)
     int isTemporary, closing, status = DPI_SUCCESS;
 
     // determine whether LOB is already being closed and if not, mark LOB as
-    // being closed; this MUST be done while holding the lock (if in threaded
-    // mode) to avoid race conditions!
-    if (lob->env->threaded)
-        dpiMutex__acquire(lob->env->mutex);
-    closing = lob->closing;
-    lob->closing = 1;
-    if (lob->env->threaded)
-        dpiMutex__release(lob->env->mutex);
+    // being closed; this MUST be done atomically to avoid race
+    // conditions!
+    closing = dpiAtomic__exchangeInt(&lob->closing, 1);
 
     // if LOB is already being closed, nothing needs to be done
     if (closing)
@@ -104,16 +99,10 @@ int dpiLob__close(dpiLob *lob, int propagateErrors, dpiError *error)
         lob->buffer = NULL;
     }
 
-    // if actual close fails, reset closing flag; again, this must be done
-    // while holding the lock (if in threaded mode) in order to avoid race
-    // conditions!
-    if (status < 0) {
-        if (lob->env->threaded)
-            dpiMutex__acquire(lob->env->mutex);
-        lob->closing = 0;
-        if (lob->env->threaded)
-            dpiMutex__release(lob->env->mutex);
-    }
+    // if actual close fails, reset closing flag; this is done atomically
+    // as well
+    if (status < 0)
+        dpiAtomic__storeInt(&lob->closing, 0);
 
     return status;
 }
@@ -156,29 +156,19 @@ int dpiObject__close(dpiObject *obj, int checkError, dpiError *error)
     int closing;
 
     // determine whether object is already being closed and if not, mark
-    // object as being closed; this MUST be done while holding the lock (if
-    // in threaded mode) to avoid race conditions!
-    if (obj->env->threaded)
-        dpiMutex__acquire(obj->env->mutex);
-    closing = obj->closing;
-    obj->closing = 1;
-    if (obj->env->threaded)
-        dpiMutex__release(obj->env->mutex);
+    // object as being closed; this MUST be done atomically to avoid race
+    // conditions!
+    closing = dpiAtomic__exchangeInt(&obj->closing, 1);
 
     // if object is already being closed, nothing needs to be done
     if (closing)
         return DPI_SUCCESS;
 
     // perform actual work of closing object; if this fails, reset closing
-    // flag; again, this must be done while holding the lock (if in threaded
-    // mode) in order to avoid race conditions!
+    // flag; this is done atomically as well
     if (obj->instance && !obj->dependsOnObj) {
         if (dpiObject__closeHelper(obj, checkError, error) < 0) {
-            if (obj->env->threaded)
-                dpiMutex__acquire(obj->env->mutex);
-            obj->closing = 0;
-            if (obj->env->threaded)
-                dpiMutex__release(obj->env->mutex);
+            dpiAtomic__storeInt(&obj->closing, 0);
             return DPI_FAILURE;
         }
     }
@@ -1435,6 +1435,7 @@ int dpiOci__errorGet(void *handle, uint32_t handleType, uint16_t charsetId,
     char *ptr;
 
     DPI_OCI_LOAD_SYMBOL("OCIErrorGet", dpiOciSymbols.fnErrorGet)
+    error->buffer->hasInfo = 1;
     status = (*dpiOciSymbols.fnErrorGet)(handle, 1, NULL, &error->buffer->code,
             error->buffer->message, sizeof(error->buffer->message),
             handleType);
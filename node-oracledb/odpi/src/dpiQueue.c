@@ -522,7 +522,7 @@ int dpiQueue_getDeqOptions(dpiQueue *queue, dpiDeqOptions **options)
     dpiError error;
 
     if (dpiGen__startPublicFn(queue, DPI_HTYPE_QUEUE, __func__, &error) < 0)
-        return DPI_FAILURE;
+        return dpiGen__endPublicFn(queue, DPI_FAILURE, &error);
     DPI_CHECK_PTR_NOT_NULL(queue, options)
     if (!queue->deqOptions && dpiQueue__createDeqOptions(queue, &error) < 0)
         return dpiGen__endPublicFn(queue, DPI_FAILURE, &error);
@@ -541,7 +541,7 @@ int dpiQueue_getEnqOptions(dpiQueue *queue, dpiEnqOptions **options)
     dpiError error;
 
     if (dpiGen__startPublicFn(queue, DPI_HTYPE_QUEUE, __func__, &error) < 0)
-        return DPI_FAILURE;
+        return dpiGen__endPublicFn(queue, DPI_FAILURE, &error);
     DPI_CHECK_PTR_NOT_NULL(queue, options)
     if (!queue->enqOptions && dpiQueue__createEnqOptions(queue, &error) < 0)
         return dpiGen__endPublicFn(queue, DPI_FAILURE, &error);
@@ -17,16 +17,60 @@
 #include "dpiImpl.h"
 
 // forward declarations of internal functions only used in this file
+static int dpiStmt__allocateBindVars(dpiStmt *stmt, uint32_t numBindVars,
+        dpiError *error);
+static int dpiStmt__checkColumnBuffer(dpiColumnBuffer *column,
+        dpiError *error);
+static uint32_t *dpiStmt__getBindVarIndexSlot(dpiStmt *stmt, uint32_t pos,
+        const char *name, uint32_t nameLength);
 static int dpiStmt__getQueryInfo(dpiStmt *stmt, uint32_t pos,
         dpiQueryInfo *info, dpiError *error);
 static int dpiStmt__getQueryInfoFromParam(dpiStmt *stmt, void *param,
         dpiQueryInfo *info, dpiError *error);
-static int dpiStmt__postFetch(dpiStmt *stmt, dpiError *error);
+static int dpiStmt__postFetch(dpiStmt *stmt, uint32_t startPos,
+        uint32_t endPos, dpiError *error);
+static int dpiStmt__postFetchDeferred(dpiStmt *stmt, dpiError *error);
 static int dpiStmt__beforeFetch(dpiStmt *stmt, dpiError *error);
 static int dpiStmt__reExecute(dpiStmt *stmt, uint32_t numIters,
         uint32_t mode, dpiError *error);
 
 
+//-----------------------------------------------------------------------------
+// dpiStmt__addBindVar() [INTERNAL]
+//   Add an entry to the list of bind variables for the given position or name
+// and return it. The list and its hash index are normally sized when the
+// statement is prepared; if the list is full anyway, its size is doubled.
+//-----------------------------------------------------------------------------
+static int dpiStmt__addBindVar(dpiStmt *stmt, uint32_t pos, const char *name,
+        uint32_t nameLength, dpiBindVar **entry, dpiError *error)
+{
+    dpiBindVar *tempEntry;
+
+    // allocate memory for additional bind variables, if needed
+    if (stmt->numBindVars == stmt->allocatedBindVars &&
+            dpiStmt__allocateBindVars(stmt, stmt->allocatedBindVars * 2,
+                    error) < 0)
+        return DPI_FAILURE;
+
+    // add to the list of bind variables and to the index
+    tempEntry = &stmt->bindVars[stmt->numBindVars];
+    tempEntry->var = NULL;
+    tempEntry->pos = pos;
+    if (name) {
+        if (dpiUtils__allocateMemory(1, nameLength, 0,
+                "allocate memory for name", (void**) &tempEntry->name,
+                error) < 0)
+            return DPI_FAILURE;
+        tempEntry->nameLength = nameLength;
+        memcpy( (void*) tempEntry->name, name, nameLength);
+    }
+    *dpiStmt__getBindVarIndexSlot(stmt, pos, name, nameLength) =
+            ++stmt->numBindVars;
+    *entry = tempEntry;
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiStmt__allocate() [INTERNAL]
 //   Create a new statement object and return it. In case of error NULL is
@@ -51,6 +95,52 @@ int dpiStmt__allocate(dpiConn *conn, int scrollable, dpiStmt **stmt,
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiStmt__allocateBindVars() [INTERNAL]
+//   Allocate space for at least the given number of bind variables (rounded
+// up to a power of two) and build the hash index which refers to them. The
+// index always has twice as many slots as there are allocated bind variables
+// so that it is never more than half full. Any existing bind variables are
+// retained.
+//-----------------------------------------------------------------------------
+static int dpiStmt__allocateBindVars(dpiStmt *stmt, uint32_t numBindVars,
+        dpiError *error)
+{
+    uint32_t allocatedBindVars, *bindVarIndex, i;
+    dpiBindVar *bindVars, *entry;
+
+    allocatedBindVars = 8;
+    while (allocatedBindVars < numBindVars)
+        allocatedBindVars *= 2;
+    if (allocatedBindVars <= stmt->allocatedBindVars)
+        return DPI_SUCCESS;
+    if (dpiUtils__allocateMemory(allocatedBindVars, sizeof(dpiBindVar), 1,
+            "allocate bind vars", (void**) &bindVars, error) < 0)
+        return DPI_FAILURE;
+    if (dpiUtils__allocateMemory(allocatedBindVars * 2, sizeof(uint32_t), 1,
+            "allocate bind var index", (void**) &bindVarIndex, error) < 0) {
+        dpiUtils__freeMemory(bindVars);
+        return DPI_FAILURE;
+    }
+    if (stmt->bindVars) {
+        for (i = 0; i < stmt->numBindVars; i++)
+            bindVars[i] = stmt->bindVars[i];
+        dpiUtils__freeMemory(stmt->bindVars);
+        dpiUtils__freeMemory(stmt->bindVarIndex);
+    }
+    stmt->bindVars = bindVars;
+    stmt->bindVarIndex = bindVarIndex;
+    stmt->allocatedBindVars = allocatedBindVars;
+    for (i = 0; i < stmt->numBindVars; i++) {
+        entry = &stmt->bindVars[i];
+        *dpiStmt__getBindVarIndexSlot(stmt, entry->pos, entry->name,
+                entry->nameLength) = i + 1;
+    }
+
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiStmt__bind() [INTERNAL]
 //   Bind the variable to the statement using either a position or a name. A
@@ -59,10 +149,10 @@ int dpiStmt__allocate(dpiConn *conn, int scrollable, dpiStmt **stmt,
 static int dpiStmt__bind(dpiStmt *stmt, dpiVar *var, uint32_t pos,
         const char *name, uint32_t nameLength, dpiError *error)
 {
-    dpiBindVar *bindVars, *entry = NULL;
-    int found, dynamicBind, status;
+    uint32_t *indexSlot, i;
+    int dynamicBind, status;
     void *bindHandle = NULL;
-    uint32_t i;
+    dpiBindVar *entry;
 
     // a zero length name is not supported
     if (pos == 0 && nameLength == 0)
@@ -80,19 +170,15 @@ static int dpiStmt__bind(dpiStmt *stmt, dpiVar *var, uint32_t pos,
     }
 
     // check to see if the bind position or name has already been bound
-    found = 0;
-    for (i = 0; i < stmt->numBindVars; i++) {
-        entry = &stmt->bindVars[i];
-        if (entry->pos == pos && entry->nameLength == nameLength) {
-            if (nameLength > 0 && strncmp(entry->name, name, nameLength) != 0)
-                continue;
-            found = 1;
-            break;
-        }
+    entry = NULL;
+    if (stmt->bindVarIndex) {
+        indexSlot = dpiStmt__getBindVarIndexSlot(stmt, pos, name, nameLength);
+        if (*indexSlot)
+            entry = &stmt->bindVars[*indexSlot - 1];
     }
 
     // if already found, use that entry
-    if (found) {
+    if (entry) {
 
         // if already bound, no need to bind a second time
         if (entry->var == var)
@@ -105,37 +191,9 @@ static int dpiStmt__bind(dpiStmt *stmt, dpiVar *var, uint32_t pos,
         }
 
     // if not found, add to the list of bind variables
-    } else {
-
-        // allocate memory for additional bind variables, if needed
-        if (stmt->numBindVars == stmt->allocatedBindVars) {
-            if (dpiUtils__allocateMemory(stmt->allocatedBindVars + 8,
-                    sizeof(dpiBindVar), 1, "allocate bind vars",
-                    (void**) &bindVars, error) < 0)
-                return DPI_FAILURE;
-            if (stmt->bindVars) {
-                for (i = 0; i < stmt->numBindVars; i++)
-                    bindVars[i] = stmt->bindVars[i];
-                dpiUtils__freeMemory(stmt->bindVars);
-            }
-            stmt->bindVars = bindVars;
-            stmt->allocatedBindVars += 8;
-        }
-
-        // add to the list of bind variables
-        entry = &stmt->bindVars[stmt->numBindVars];
-        entry->var = NULL;
-        entry->pos = pos;
-        if (name) {
-            if (dpiUtils__allocateMemory(1, nameLength, 0,
-                    "allocate memory for name", (void**) &entry->name,
-                    error) < 0)
-                return DPI_FAILURE;
-            entry->nameLength = nameLength;
-            memcpy( (void*) entry->name, name, nameLength);
-        }
-        stmt->numBindVars++;
-
+    } else if (dpiStmt__addBindVar(stmt, pos, name, nameLength, &entry,
+            error) < 0) {
+        return DPI_FAILURE;
     }
 
     // for PL/SQL where the maxSize is greater than 32K, adjust the variable
@@ -224,6 +282,41 @@ static int dpiStmt__check(dpiStmt *stmt, const char *fnName, dpiError *error)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiStmt__checkColumnBuffer() [INTERNAL]
+//   Verifies that the arrays required for the native type of the column
+// buffer have been supplied. The types of the variables are checked once the
+// rows have been fetched.
+//-----------------------------------------------------------------------------
+static int dpiStmt__checkColumnBuffer(dpiColumnBuffer *column,
+        dpiError *error)
+{
+    switch (column->nativeTypeNum) {
+        case DPI_NATIVE_TYPE_INT64:
+            if (!column->asInt64)
+                return dpiError__set(error, "check parameter asInt64",
+                        DPI_ERR_NULL_POINTER_PARAMETER, "asInt64");
+            break;
+        case DPI_NATIVE_TYPE_DOUBLE:
+            if (!column->asDouble)
+                return dpiError__set(error, "check parameter asDouble",
+                        DPI_ERR_NULL_POINTER_PARAMETER, "asDouble");
+            break;
+        case DPI_NATIVE_TYPE_BYTES:
+            if (!column->offsets)
+                return dpiError__set(error, "check parameter offsets",
+                        DPI_ERR_NULL_POINTER_PARAMETER, "offsets");
+            if (!column->bytes && column->bytesLength > 0)
+                return dpiError__set(error, "check parameter bytes",
+                        DPI_ERR_PTR_LENGTH_MISMATCH, "bytes");
+            break;
+        default:
+            break;
+    }
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiStmt__clearBatchErrors() [INTERNAL]
 //   Clear the batch errors associated with the statement.
@@ -255,6 +348,10 @@ static void dpiStmt__clearBindVars(dpiStmt *stmt, dpiError *error)
         dpiUtils__freeMemory(stmt->bindVars);
         stmt->bindVars = NULL;
     }
+    if (stmt->bindVarIndex) {
+        dpiUtils__freeMemory(stmt->bindVarIndex);
+        stmt->bindVarIndex = NULL;
+    }
     stmt->numBindVars = 0;
     stmt->allocatedBindVars = 0;
 }
@@ -304,14 +401,9 @@ int dpiStmt__close(dpiStmt *stmt, const char *tag, uint32_t tagLength,
     int closing, status = DPI_SUCCESS;
 
     // determine whether statement is already being closed and if not, mark
-    // statement as being closed; this MUST be done while holding the lock (if
-    // in threaded mode) to avoid race conditions!
-    if (stmt->env->threaded)
-        dpiMutex__acquire(stmt->env->mutex);
-    closing = stmt->closing;
-    stmt->closing = 1;
-    if (stmt->env->threaded)
-        dpiMutex__release(stmt->env->mutex);
+    // statement as being closed; this MUST be done atomically to avoid race
+    // conditions!
+    closing = dpiAtomic__exchangeInt(&stmt->closing, 1);
 
     // if statement is already being closed, nothing needs to be done
     if (closing)
@@ -339,16 +431,10 @@ int dpiStmt__close(dpiStmt *stmt, const char *tag, uint32_t tagLength,
         stmt->handle = NULL;
     }
 
-    // if actual close fails, reset closing flag; again, this must be done
-    // while holding the lock (if in threaded mode) in order to avoid race
-    // conditions!
-    if (status < 0) {
-        if (stmt->env->threaded)
-            dpiMutex__acquire(stmt->env->mutex);
-        stmt->closing = 0;
-        if (stmt->env->threaded)
-            dpiMutex__release(stmt->env->mutex);
-    }
+    // if actual close fails, reset closing flag; this is done atomically
+    // as well
+    if (status < 0)
+        dpiAtomic__storeInt(&stmt->closing, 0);
 
     return status;
 }
@@ -663,9 +749,16 @@ static int dpiStmt__execute(dpiStmt *stmt, uint32_t numIters,
 
 //-----------------------------------------------------------------------------
 // dpiStmt__fetch() [INTERNAL]
-//   Performs the actual fetch from Oracle.
-//-----------------------------------------------------------------------------
-static int dpiStmt__fetch(dpiStmt *stmt, dpiError *error)
+//   Performs the actual fetch from Oracle. The post fetch activities for the
+// first numDeferredVars variables may be deferred when their values are going
+// to be transferred directly from the variable buffers by
+// dpiStmt_fetchColumns(); they are performed later if the values are
+// requested in any other way. The post fetch activities for all other
+// variables are always performed immediately, since variables such as LOBs
+// and objects require them before the next fetch takes place.
+//-----------------------------------------------------------------------------
+static int dpiStmt__fetch(dpiStmt *stmt, uint32_t numDeferredVars,
+        dpiError *error)
 {
     // perform any pre-fetch activities required
     if (dpiStmt__beforeFetch(stmt, error) < 0)
@@ -686,8 +779,13 @@ static int dpiStmt__fetch(dpiStmt *stmt, dpiError *error)
     stmt->bufferMinRow = stmt->rowCount + 1;
     stmt->bufferRowIndex = 0;
 
-    // perform post-fetch activities required
-    if (dpiStmt__postFetch(stmt, error) < 0)
+    // perform post-fetch activities required for the variables whose values
+    // are not being transferred directly
+    if (numDeferredVars > stmt->numQueryVars)
+        numDeferredVars = stmt->numQueryVars;
+    stmt->numDeferredPostFetchVars = numDeferredVars;
+    if (dpiStmt__postFetch(stmt, numDeferredVars, stmt->numQueryVars,
+            error) < 0)
         return DPI_FAILURE;
 
     return DPI_SUCCESS;
@@ -801,6 +899,38 @@ static int dpiStmt__getBatchErrors(dpiStmt *stmt, dpiError *error)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiStmt__getBindVarIndexSlot() [INTERNAL]
+//   Return the slot in the hash index which refers to the bind variable with
+// the given position or name or, if there is no such bind variable, the empty
+// slot where a reference to it belongs. The index uses open addressing with
+// linear probing and each slot holds the offset of the bind variable in the
+// array plus one, so that zero designates an empty slot. Names are hashed
+// with FNV-1a and, like the comparison that follows, are case sensitive.
+//-----------------------------------------------------------------------------
+static uint32_t *dpiStmt__getBindVarIndexSlot(dpiStmt *stmt, uint32_t pos,
+        const char *name, uint32_t nameLength)
+{
+    uint32_t hash, mask, i;
+    dpiBindVar *entry;
+
+    if (nameLength > 0) {
+        hash = 2166136261u;
+        for (i = 0; i < nameLength; i++)
+            hash = (hash ^ (uint8_t) name[i]) * 16777619u;
+    } else hash = pos * 2654435761u;
+    mask = stmt->allocatedBindVars * 2 - 1;
+    for (i = hash & mask; stmt->bindVarIndex[i] != 0; i = (i + 1) & mask) {
+        entry = &stmt->bindVars[stmt->bindVarIndex[i] - 1];
+        if (entry->pos == pos && entry->nameLength == nameLength &&
+                (nameLength == 0 ||
+                        memcmp(entry->name, name, nameLength) == 0))
+            break;
+    }
+    return &stmt->bindVarIndex[i];
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiStmt__getRowCount() [INTERNAL]
 //   Return the number of rows affected by the last DML executed (for insert,
@@ -918,21 +1048,20 @@ int dpiStmt__init(dpiStmt *stmt, dpiError *error)
 //-----------------------------------------------------------------------------
 // dpiStmt__postFetch() [INTERNAL]
 //   Performs the transformations required to convert Oracle data values into
-// C data values.
+// C data values for the query variables in the given range of positions.
 //-----------------------------------------------------------------------------
-static int dpiStmt__postFetch(dpiStmt *stmt, dpiError *error)
+static int dpiStmt__postFetch(dpiStmt *stmt, uint32_t startPos,
+        uint32_t endPos, dpiError *error)
 {
-    uint32_t i, j;
+    uint32_t i;
     dpiVar *var;
 
-    for (i = 0; i < stmt->numQueryVars; i++) {
+    for (i = startPos; i < endPos; i++) {
         var = stmt->queryVars[i];
-        for (j = 0; j < stmt->bufferRowCount; j++) {
-            if (dpiVar__getValue(var, &var->buffer, j, 1, error) < 0)
-                return DPI_FAILURE;
-            if (var->type->requiresPreFetch)
-                var->requiresPreFetch = 1;
-        }
+        if (dpiVar__getColumnValues(var, stmt->bufferRowCount, error) < 0)
+            return DPI_FAILURE;
+        if (stmt->bufferRowCount > 0 && var->type->requiresPreFetch)
+            var->requiresPreFetch = 1;
         var->error = NULL;
     }
 
@@ -940,6 +1069,20 @@ static int dpiStmt__postFetch(dpiStmt *stmt, dpiError *error)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiStmt__postFetchDeferred() [INTERNAL]
+//   Performs the post fetch activities that were deferred by
+// dpiStmt_fetchColumns(), if any.
+//-----------------------------------------------------------------------------
+static int dpiStmt__postFetchDeferred(dpiStmt *stmt, dpiError *error)
+{
+    uint32_t numVars = stmt->numDeferredPostFetchVars;
+
+    stmt->numDeferredPostFetchVars = 0;
+    return dpiStmt__postFetch(stmt, 0, numVars, error);
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiStmt__beforeFetch() [INTERNAL]
 //   Performs work that needs to be done prior to fetch for each variable. In
@@ -985,11 +1128,14 @@ static int dpiStmt__beforeFetch(dpiStmt *stmt, dpiError *error)
 
 //-----------------------------------------------------------------------------
 // dpiStmt__prepare() [INTERNAL]
-//   Prepare a statement for execution.
+//   Prepare a statement for execution. The bind variables and their hash
+// index are sized from the number of bind variables in the statement.
 //-----------------------------------------------------------------------------
 int dpiStmt__prepare(dpiStmt *stmt, const char *sql, uint32_t sqlLength,
         const char *tag, uint32_t tagLength, dpiError *error)
 {
+    uint32_t bindCount;
+
     if (sql && dpiDebugLevel & DPI_DEBUG_LEVEL_SQL)
         dpiDebug__print("SQL %.*s\n", sqlLength, sql);
     if (dpiOci__stmtPrepare2(stmt, sql, sqlLength, tag, tagLength, error) < 0)
@@ -1000,8 +1146,19 @@ int dpiStmt__prepare(dpiStmt *stmt, const char *sql, uint32_t sqlLength,
         stmt->handle = NULL;
         return DPI_FAILURE;
     }
+    if (dpiStmt__init(stmt, error) < 0)
+        return DPI_FAILURE;
+
+    // size the bind variables and their hash index once, so that binding
+    // (and rebinding on each execute) never has to grow or rebuild them
+    if (dpiOci__attrGet(stmt->handle, DPI_OCI_HTYPE_STMT, (void*) &bindCount,
+            0, DPI_OCI_ATTR_BIND_COUNT, "get bind count", error) < 0)
+        return DPI_FAILURE;
+    if (bindCount > 0 && dpiStmt__allocateBindVars(stmt, bindCount,
+            error) < 0)
+        return DPI_FAILURE;
 
-    return dpiStmt__init(stmt, error);
+    return DPI_SUCCESS;
 }
 
 
@@ -1333,13 +1490,16 @@ int dpiStmt_fetch(dpiStmt *stmt, int *found, uint32_t *bufferRowIndex)
     DPI_CHECK_PTR_NOT_NULL(stmt, found)
     DPI_CHECK_PTR_NOT_NULL(stmt, bufferRowIndex)
     if (stmt->bufferRowIndex >= stmt->bufferRowCount) {
-        if (stmt->hasRowsToFetch && dpiStmt__fetch(stmt, &error) < 0)
+        if (stmt->hasRowsToFetch && dpiStmt__fetch(stmt, 0, &error) < 0)
             return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
         if (stmt->bufferRowIndex >= stmt->bufferRowCount) {
             *found = 0;
             return dpiGen__endPublicFn(stmt, DPI_SUCCESS, &error);
         }
     }
+    if (stmt->numDeferredPostFetchVars > 0 &&
+            dpiStmt__postFetchDeferred(stmt, &error) < 0)
+        return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
     *found = 1;
     *bufferRowIndex = stmt->bufferRowIndex;
     stmt->bufferRowIndex++;
@@ -1348,6 +1508,80 @@ int dpiStmt_fetch(dpiStmt *stmt, int *found, uint32_t *bufferRowIndex)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiStmt_fetchColumns() [PUBLIC]
+//   Fetch rows into buffers and transfer the values of the first numColumns
+// columns directly into the column buffers supplied by the caller, returning
+// the number of rows that were so fetched. If there are still rows available
+// in the buffer, no additional fetch will take place. Fewer rows than are
+// available are returned if the byte strings of all of them do not fit into
+// the column buffers.
+//-----------------------------------------------------------------------------
+int dpiStmt_fetchColumns(dpiStmt *stmt, uint32_t maxRows,
+        uint32_t numColumns, dpiColumnBuffer *columns,
+        uint32_t *numRowsFetched, int *moreRows)
+{
+    uint32_t i, numRows;
+    dpiError error;
+
+    if (dpiStmt__check(stmt, __func__, &error) < 0)
+        return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
+    if (!columns && numColumns > 0) {
+        dpiError__set(&error, "check parameter columns",
+                DPI_ERR_PTR_LENGTH_MISMATCH, "columns");
+        return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
+    }
+    DPI_CHECK_PTR_NOT_NULL(stmt, numRowsFetched)
+    DPI_CHECK_PTR_NOT_NULL(stmt, moreRows)
+    for (i = 0; i < numColumns; i++) {
+        if (dpiStmt__checkColumnBuffer(&columns[i], &error) < 0)
+            return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
+    }
+    if (stmt->bufferRowIndex >= stmt->bufferRowCount) {
+        if (stmt->hasRowsToFetch &&
+                dpiStmt__fetch(stmt, numColumns, &error) < 0)
+            return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
+        if (stmt->bufferRowIndex >= stmt->bufferRowCount) {
+            *moreRows = 0;
+            *numRowsFetched = 0;
+            return dpiGen__endPublicFn(stmt, DPI_SUCCESS, &error);
+        }
+    }
+    if (numColumns > stmt->numQueryVars) {
+        dpiError__set(&error, "check number of columns",
+                DPI_ERR_QUERY_POSITION_INVALID, numColumns);
+        return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
+    }
+
+    // determine the number of rows that can be transferred
+    numRows = stmt->bufferRowCount - stmt->bufferRowIndex;
+    if (numRows > maxRows)
+        numRows = maxRows;
+    for (i = 0; i < numColumns && numRows > 0; i++) {
+        if (dpiVar__checkColumnBuffer(stmt->queryVars[i], &columns[i],
+                stmt->bufferRowIndex, &numRows, &error) < 0) {
+            if (stmt->numDeferredPostFetchVars > 0)
+                dpiStmt__postFetchDeferred(stmt, &error);
+            return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
+        }
+    }
+
+    // transfer the values for each column
+    for (i = 0; i < numColumns && numRows > 0; i++) {
+        if (dpiVar__getColumnBuffer(stmt->queryVars[i], &columns[i],
+                stmt->bufferRowIndex, numRows, &error) < 0)
+            return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
+    }
+
+    *numRowsFetched = numRows;
+    *moreRows = (stmt->hasRowsToFetch ||
+            stmt->bufferRowIndex + numRows < stmt->bufferRowCount);
+    stmt->bufferRowIndex += numRows;
+    stmt->rowCount += numRows;
+    return dpiGen__endPublicFn(stmt, DPI_SUCCESS, &error);
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiStmt_fetchRows() [PUBLIC]
 //   Fetch rows into buffers and return the number of rows that were so
@@ -1365,7 +1599,7 @@ int dpiStmt_fetchRows(dpiStmt *stmt, uint32_t maxRows,
     DPI_CHECK_PTR_NOT_NULL(stmt, numRowsFetched)
     DPI_CHECK_PTR_NOT_NULL(stmt, moreRows)
     if (stmt->bufferRowIndex >= stmt->bufferRowCount) {
-        if (stmt->hasRowsToFetch && dpiStmt__fetch(stmt, &error) < 0)
+        if (stmt->hasRowsToFetch && dpiStmt__fetch(stmt, 0, &error) < 0)
             return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
         if (stmt->bufferRowIndex >= stmt->bufferRowCount) {
             *moreRows = 0;
@@ -1374,6 +1608,9 @@ int dpiStmt_fetchRows(dpiStmt *stmt, uint32_t maxRows,
             return dpiGen__endPublicFn(stmt, DPI_SUCCESS, &error);
         }
     }
+    if (stmt->numDeferredPostFetchVars > 0 &&
+            dpiStmt__postFetchDeferred(stmt, &error) < 0)
+        return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
     *bufferRowIndex = stmt->bufferRowIndex;
     *numRowsFetched = stmt->bufferRowCount - stmt->bufferRowIndex;
     *moreRows = stmt->hasRowsToFetch;
@@ -1740,6 +1977,9 @@ int dpiStmt_getQueryValue(dpiStmt *stmt, uint32_t pos,
         dpiError__set(&error, "check fetched row", DPI_ERR_NO_ROW_FETCHED);
         return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
     }
+    if (stmt->numDeferredPostFetchVars > 0 &&
+            dpiStmt__postFetchDeferred(stmt, &error) < 0)
+        return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
     *nativeTypeNum = var->nativeTypeNum;
     *data = &var->buffer.externalData[stmt->bufferRowIndex - 1];
     return dpiGen__endPublicFn(stmt, DPI_SUCCESS, &error);
@@ -1907,7 +2147,8 @@ int dpiStmt_scroll(dpiStmt *stmt, dpiFetchMode mode, int32_t offset,
     stmt->bufferRowIndex = 0;
 
     // perform post-fetch activities required
-    if (dpiStmt__postFetch(stmt, &error) < 0)
+    stmt->numDeferredPostFetchVars = 0;
+    if (dpiStmt__postFetch(stmt, 0, stmt->numQueryVars, &error) < 0)
         return dpiGen__endPublicFn(stmt, DPI_FAILURE, &error);
 
     return dpiGen__endPublicFn(stmt, DPI_SUCCESS, &error);
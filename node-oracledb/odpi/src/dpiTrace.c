@@ -0,0 +1,381 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+// This program is free software: you can modify it and/or redistribute it
+// under the terms of:
+//
+// (i)  the Universal Permissive License v 1.0 or at your option, any
+//      later version (http://oss.oracle.com/licenses/upl); and/or
+//
+// (ii) the Apache License v 2.0. (http://www.apache.org/licenses/LICENSE-2.0)
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// dpiTrace.c
+//   Low overhead tracing of public function calls, enabled with the debug
+// level DPI_DEBUG_LEVEL_TRACE. Each thread is given its own trace buffer the
+// first time it calls a public function; fixed size binary records are
+// written to a ring buffer within it and the call count and latency histogram
+// of the function are updated when the call ends. Nothing is formatted and no
+// locks are taken while tracing. The statistics of all buffers are aggregated
+// on request and the records can be written to a file which is decoded
+// offline by the script util/tracing/fn_trace.py.
+//
+// Only the thread using a buffer writes to it. The statistics and records are
+// read by other threads without synchronization, so a record or count that is
+// being written at that moment may be incomplete.
+//-----------------------------------------------------------------------------
+
+#include "dpiImpl.h"
+
+// define identifying header and version of trace files
+#define DPI_TRACE_FILE_MAGIC            "DPITRACE"
+#define DPI_TRACE_FILE_VERSION          1
+#define DPI_TRACE_FILE_BYTE_ORDER       0x01020304
+
+// list of all trace buffers ever allocated
+static dpiAtomicPtr dpiTraceBuffers = NULL;
+
+// table of traced function names; the function identifier is the slot number
+static dpiAtomicPtr dpiTraceFnNames[DPI_TRACE_MAX_FNS];
+
+
+//-----------------------------------------------------------------------------
+// dpiTrace__acquireBuffer() [INTERNAL]
+//   Acquire a trace buffer for the calling thread. A buffer released by a
+// thread that has exited is reused if one is available; otherwise, a new
+// buffer is allocated and pushed onto the list of buffers. NULL is returned
+// if memory cannot be allocated, in which case the thread is not traced.
+//-----------------------------------------------------------------------------
+static dpiTraceBuffer *dpiTrace__acquireBuffer(void)
+{
+    dpiTraceBuffer *traceBuffer, *topBuffer;
+    int notInUse;
+
+    // look for a buffer that is no longer in use
+    traceBuffer = (dpiTraceBuffer*) dpiAtomic__loadPtr(&dpiTraceBuffers);
+    while (traceBuffer) {
+        notInUse = 0;
+        if (dpiAtomic__compareExchangeInt(&traceBuffer->inUse, notInUse, 1))
+            break;
+        traceBuffer = traceBuffer->next;
+    }
+
+    // if none is available, allocate a new one and add it to the list
+    if (!traceBuffer) {
+        if (dpiUtils__allocateMemory(1, sizeof(dpiTraceBuffer), 1,
+                "allocate trace buffer", (void**) &traceBuffer, NULL) < 0)
+            return NULL;
+        dpiAtomic__storeInt(&traceBuffer->inUse, 1);
+        do {
+            topBuffer = (dpiTraceBuffer*) dpiAtomic__loadPtr(&dpiTraceBuffers);
+            traceBuffer->next = topBuffer;
+        } while (!dpiAtomic__compareExchangePtr(&dpiTraceBuffers, topBuffer,
+                traceBuffer));
+    }
+
+    traceBuffer->threadId = dpiThread__getId();
+    traceBuffer->depth = 0;
+    return traceBuffer;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTrace__addRecord() [INTERNAL]
+//   Add a record to the ring buffer, overwriting the oldest record if the
+// ring buffer is full.
+//-----------------------------------------------------------------------------
+static void dpiTrace__addRecord(dpiTraceBuffer *traceBuffer, uint16_t fnId,
+        uint8_t recordType, const void *handle, int status,
+        uint64_t timestamp)
+{
+    dpiTraceRecord *record;
+
+    record = &traceBuffer->records[traceBuffer->numRecords &
+            (DPI_TRACE_NUM_RECORDS - 1)];
+    record->timestamp = timestamp;
+    record->threadId = traceBuffer->threadId;
+    record->handle = (uint64_t) (uintptr_t) handle;
+    record->fnId = fnId;
+    record->recordType = recordType;
+    record->status = (int8_t) status;
+    record->depth = traceBuffer->depth;
+    traceBuffer->numRecords++;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTrace__getFnId() [INTERNAL]
+//   Return the identifier of the function with the given name, adding it to
+// the table of traced functions if needed. The names passed are the values of
+// __func__ in the public functions, so the pointer itself is hashed and
+// compared. If the table is full, DPI_TRACE_UNKNOWN_FN_ID is returned.
+//-----------------------------------------------------------------------------
+static uint16_t dpiTrace__getFnId(const char *fnName)
+{
+    void *slotFnName, *emptyFnName;
+    uint32_t slotNum, i;
+    uint64_t hash;
+
+    hash = (uint64_t) (uintptr_t) fnName * 0x9E3779B97F4A7C15ULL;
+    slotNum = (uint32_t) (hash >> 32) & (DPI_TRACE_MAX_FNS - 1);
+    for (i = 0; i < DPI_TRACE_MAX_FNS; i++) {
+        slotFnName = dpiAtomic__loadPtr(&dpiTraceFnNames[slotNum]);
+        if (!slotFnName) {
+            emptyFnName = NULL;
+            if (dpiAtomic__compareExchangePtr(&dpiTraceFnNames[slotNum],
+                    emptyFnName, fnName))
+                return (uint16_t) slotNum;
+            slotFnName = dpiAtomic__loadPtr(&dpiTraceFnNames[slotNum]);
+        }
+        if (slotFnName == (void*) fnName)
+            return (uint16_t) slotNum;
+        slotNum = (slotNum + 1) & (DPI_TRACE_MAX_FNS - 1);
+    }
+    return DPI_TRACE_UNKNOWN_FN_ID;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTrace__getTime() [INTERNAL]
+//   Return the value of a monotonic clock in nanoseconds.
+//-----------------------------------------------------------------------------
+static uint64_t dpiTrace__getTime(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, frequency;
+
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t) (count.QuadPart / frequency.QuadPart) * 1000000000 +
+            (uint64_t) (count.QuadPart % frequency.QuadPart) * 1000000000 /
+            (uint64_t) frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTrace__end() [INTERNAL]
+//   Record the end of the public function call most recently started by the
+// thread and update the statistics of the function. Bucket 0 of the latency
+// histogram counts calls taking less than 1 microsecond and bucket n counts
+// calls taking at least 2^(n-1) and less than 2^n microseconds; the last
+// bucket also counts all longer calls.
+//-----------------------------------------------------------------------------
+void dpiTrace__end(dpiErrorBuffer *buffer, const void *handle, int status)
+{
+    dpiTraceBuffer *traceBuffer = buffer->traceBuffer;
+    uint64_t timestamp, elapsed, micros;
+    dpiTraceStats *stats;
+    uint32_t bucketNum;
+    uint16_t fnId;
+
+    // nothing to do if the start of the call was not recorded
+    if (!traceBuffer || traceBuffer->depth == 0)
+        return;
+    if (--traceBuffer->depth >= DPI_TRACE_MAX_DEPTH)
+        return;
+
+    // add the record
+    timestamp = dpiTrace__getTime();
+    fnId = traceBuffer->fnIds[traceBuffer->depth];
+    dpiTrace__addRecord(traceBuffer, fnId, DPI_TRACE_RECORD_END, handle,
+            status, timestamp);
+    if (fnId == DPI_TRACE_UNKNOWN_FN_ID)
+        return;
+
+    // update statistics
+    elapsed = timestamp - traceBuffer->startTimes[traceBuffer->depth];
+    stats = &traceBuffer->stats[fnId];
+    stats->numCalls++;
+    if (status < 0)
+        stats->numFailures++;
+    stats->totalNanoseconds += elapsed;
+    if (elapsed > stats->maxNanoseconds)
+        stats->maxNanoseconds = elapsed;
+    micros = elapsed / 1000;
+    for (bucketNum = 0; micros > 0 && bucketNum < DPI_TRACE_NUM_BUCKETS - 1;
+            bucketNum++)
+        micros >>= 1;
+    stats->latencyBuckets[bucketNum]++;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTrace__getStats() [INTERNAL]
+//   Aggregate the statistics of all trace buffers (including those no longer
+// in use) for each function that has completed at least one call. On input
+// numStats is the number of elements in the stats array; on output it is the
+// number of functions for which statistics are available. If that is larger
+// than the array, only as many elements as the array holds are populated.
+//-----------------------------------------------------------------------------
+void dpiTrace__getStats(uint32_t *numStats, dpiTraceStats *stats)
+{
+    dpiTraceBuffer *traceBuffer, *firstBuffer;
+    dpiTraceStats fnStats, *bufferStats;
+    uint32_t fnId, numFns, i;
+    const char *fnName;
+
+    numFns = 0;
+    firstBuffer = (dpiTraceBuffer*) dpiAtomic__loadPtr(&dpiTraceBuffers);
+    for (fnId = 0; fnId < DPI_TRACE_MAX_FNS; fnId++) {
+        fnName = (const char*) dpiAtomic__loadPtr(&dpiTraceFnNames[fnId]);
+        if (!fnName)
+            continue;
+        memset(&fnStats, 0, sizeof(fnStats));
+        fnStats.fnName = fnName;
+        for (traceBuffer = firstBuffer; traceBuffer;
+                traceBuffer = traceBuffer->next) {
+            bufferStats = &traceBuffer->stats[fnId];
+            if (bufferStats->numCalls == 0)
+                continue;
+            fnStats.numCalls += bufferStats->numCalls;
+            fnStats.numFailures += bufferStats->numFailures;
+            fnStats.totalNanoseconds += bufferStats->totalNanoseconds;
+            if (bufferStats->maxNanoseconds > fnStats.maxNanoseconds)
+                fnStats.maxNanoseconds = bufferStats->maxNanoseconds;
+            for (i = 0; i < DPI_TRACE_NUM_BUCKETS; i++)
+                fnStats.latencyBuckets[i] += bufferStats->latencyBuckets[i];
+        }
+        if (fnStats.numCalls == 0)
+            continue;
+        if (numFns < *numStats)
+            stats[numFns] = fnStats;
+        numFns++;
+    }
+    *numStats = numFns;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTrace__releaseBuffer() [INTERNAL]
+//   Release the trace buffer when the thread using it exits so that it can be
+// reused by another thread. Its records and statistics are retained.
+//-----------------------------------------------------------------------------
+void dpiTrace__releaseBuffer(dpiTraceBuffer *traceBuffer)
+{
+    dpiAtomic__storeInt(&traceBuffer->inUse, 0);
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTrace__start() [INTERNAL]
+//   Record the start of a public function call. A trace buffer is acquired
+// for the thread the first time this is called. This function is not
+// permitted to fail; if a trace buffer cannot be allocated the call is simply
+// not traced.
+//-----------------------------------------------------------------------------
+void dpiTrace__start(dpiErrorBuffer *buffer, const char *fnName,
+        const void *handle)
+{
+    dpiTraceBuffer *traceBuffer = buffer->traceBuffer;
+    uint64_t timestamp;
+    uint16_t fnId;
+
+    if (!traceBuffer) {
+        traceBuffer = dpiTrace__acquireBuffer();
+        if (!traceBuffer)
+            return;
+        buffer->traceBuffer = traceBuffer;
+    }
+    if (traceBuffer->depth < DPI_TRACE_MAX_DEPTH) {
+        fnId = dpiTrace__getFnId(fnName);
+        timestamp = dpiTrace__getTime();
+        dpiTrace__addRecord(traceBuffer, fnId, DPI_TRACE_RECORD_START, handle,
+                0, timestamp);
+        traceBuffer->fnIds[traceBuffer->depth] = fnId;
+        traceBuffer->startTimes[traceBuffer->depth] = timestamp;
+    }
+    traceBuffer->depth++;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTrace__write() [INTERNAL]
+//   Write the table of traced functions and the records held in all trace
+// buffers to the specified file. All values are written in native byte order
+// and the file starts with a byte order mark so that the decoder can detect
+// which byte order was used. The records of each buffer are written oldest
+// first.
+//-----------------------------------------------------------------------------
+int dpiTrace__write(const char *fileName, dpiError *error)
+{
+    uint32_t value, numRecords, startPos, i;
+    dpiTraceBuffer *traceBuffer, *firstBuffer;
+    uint16_t fnId, nameLength;
+    const char *fnName;
+    uint64_t total;
+    FILE *fp;
+    int ok;
+
+    fp = fopen(fileName, "wb");
+    if (!fp)
+        return dpiError__setFromOS(error, "open trace file");
+    firstBuffer = (dpiTraceBuffer*) dpiAtomic__loadPtr(&dpiTraceBuffers);
+
+    // write header
+    ok = (fwrite(DPI_TRACE_FILE_MAGIC, 8, 1, fp) == 1);
+    value = DPI_TRACE_FILE_VERSION;
+    ok = ok && (fwrite(&value, sizeof(value), 1, fp) == 1);
+    value = DPI_TRACE_FILE_BYTE_ORDER;
+    ok = ok && (fwrite(&value, sizeof(value), 1, fp) == 1);
+    value = sizeof(dpiTraceRecord);
+    ok = ok && (fwrite(&value, sizeof(value), 1, fp) == 1);
+
+    // write table of traced functions
+    value = 0;
+    for (i = 0; i < DPI_TRACE_MAX_FNS; i++) {
+        if (dpiAtomic__loadPtr(&dpiTraceFnNames[i]))
+            value++;
+    }
+    ok = ok && (fwrite(&value, sizeof(value), 1, fp) == 1);
+    for (i = 0; ok && i < DPI_TRACE_MAX_FNS; i++) {
+        fnName = (const char*) dpiAtomic__loadPtr(&dpiTraceFnNames[i]);
+        if (!fnName)
+            continue;
+        fnId = (uint16_t) i;
+        nameLength = (uint16_t) strlen(fnName);
+        ok = (fwrite(&fnId, sizeof(fnId), 1, fp) == 1 &&
+                fwrite(&nameLength, sizeof(nameLength), 1, fp) == 1 &&
+                fwrite(fnName, nameLength, 1, fp) == 1);
+    }
+
+    // write records of each trace buffer
+    value = 0;
+    for (traceBuffer = firstBuffer; traceBuffer;
+            traceBuffer = traceBuffer->next)
+        value++;
+    ok = ok && (fwrite(&value, sizeof(value), 1, fp) == 1);
+    for (traceBuffer = firstBuffer; ok && traceBuffer;
+            traceBuffer = traceBuffer->next) {
+        total = traceBuffer->numRecords;
+        if (total > DPI_TRACE_NUM_RECORDS) {
+            numRecords = DPI_TRACE_NUM_RECORDS;
+            startPos = (uint32_t) (total & (DPI_TRACE_NUM_RECORDS - 1));
+        } else {
+            numRecords = (uint32_t) total;
+            startPos = 0;
+        }
+        ok = (fwrite(&numRecords, sizeof(numRecords), 1, fp) == 1);
+        if (ok && numRecords > startPos)
+            ok = (fwrite(&traceBuffer->records[startPos],
+                    sizeof(dpiTraceRecord), numRecords - startPos,
+                    fp) == numRecords - startPos);
+        if (ok && startPos > 0)
+            ok = (fwrite(traceBuffer->records, sizeof(dpiTraceRecord),
+                    startPos, fp) == startPos);
+    }
+
+    if (!ok) {
+        dpiError__setFromOS(error, "write trace file");
+        fclose(fp);
+        return DPI_FAILURE;
+    }
+    if (fclose(fp) != 0)
+        return dpiError__setFromOS(error, "close trace file");
+    return DPI_SUCCESS;
+}
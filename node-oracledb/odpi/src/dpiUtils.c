@@ -112,6 +112,169 @@ void dpiUtils__clearMemory(void *ptr, size_t length)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiUtils__decodeOracleNumber() [INTERNAL]
+//   Decode the contents of an Oracle number into a 64-bit unsigned mantissa
+// and the power of 10 by which the mantissa must be scaled, without calling
+// OCI. The base-100 digits are processed in the same way as is done in
+// dpiUtils__parseOracleNumber() but are accumulated directly instead of being
+// split into decimal digits. A value of 0 is returned if the mantissa does
+// not fit in 64 bits or if the value is one of the special values (+/-1e126)
+// or is corrupt; the caller is then expected to use OCI instead. Otherwise a
+// value of 1 is returned.
+//-----------------------------------------------------------------------------
+int dpiUtils__decodeOracleNumber(const void *oracleValue, int *isNegative,
+        uint64_t *mantissa, int16_t *exponent)
+{
+    uint8_t length, ociExponent, byte, i;
+    const uint8_t *source;
+    uint64_t value;
+
+    // the first byte of the structure is a length byte which includes the
+    // exponent and the mantissa bytes; a mantissa length longer than 20
+    // signals corruption of some kind
+    source = (const uint8_t*) oracleValue;
+    length = (uint8_t) (*source++ - 1);
+    if (length > 20)
+        return 0;
+
+    // the second byte of the structure is the exponent; positive numbers have
+    // the highest order bit set whereas negative numbers have the highest
+    // order bit cleared and the bits inverted
+    ociExponent = *source++;
+    *isNegative = (ociExponent & 0x80) ? 0 : 1;
+    if (*isNegative)
+        ociExponent = (uint8_t) ~ociExponent;
+
+    // a mantissa length of 0 implies a value of 0 (if positive) or -1e126 (if
+    // negative); the latter cannot be represented
+    if (length == 0) {
+        if (*isNegative)
+            return 0;
+        *mantissa = 0;
+        *exponent = 0;
+        return 1;
+    }
+
+    // check for the trailing 102 byte for negative numbers and if present,
+    // reduce the number of mantissa digits
+    if (*isNegative && source[length - 1] == 102)
+        length--;
+
+    // accumulate the base-100 digits, checking for overflow as each digit is
+    // added; a digit of 100 is only found in the special value +1e126
+    value = 0;
+    for (i = 0; i < length; i++) {
+        byte = source[i];
+        if (*isNegative)
+            byte = (uint8_t) (101 - byte);
+        else byte--;
+        if (byte > 99 || value > (UINT64_MAX - byte) / 100)
+            return 0;
+        value = value * 100 + byte;
+    }
+
+    *mantissa = value;
+    *exponent = (int16_t) (((int) ociExponent - 193 - length + 1) * 2);
+    return 1;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiUtils__decodeOracleNumberAsDouble() [INTERNAL]
+//   Decode the contents of an Oracle number as a double without calling OCI.
+// This is only done when the result is guaranteed to be correctly rounded:
+// the mantissa must be exactly representable as a double and the power of 10
+// must be one that is also exactly representable (possibly after moving some
+// of it into the mantissa), so that a single IEEE multiplication or division
+// produces the result. A value of 0 is returned
+// if this is not the case and OCI must be used instead.
+//-----------------------------------------------------------------------------
+int dpiUtils__decodeOracleNumberAsDouble(const void *oracleValue,
+        double *value)
+{
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+        1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    uint64_t mantissa;
+    int16_t exponent;
+    int isNegative;
+    double result;
+
+    if (!dpiUtils__decodeOracleNumber(oracleValue, &isNegative, &mantissa,
+            &exponent))
+        return 0;
+    while (mantissa != 0 && mantissa % 10 == 0 &&
+            (exponent < 0 || mantissa > DPI_MAX_EXACT_DOUBLE_INT)) {
+        mantissa /= 10;
+        exponent++;
+    }
+    while (exponent > 22 && mantissa <= DPI_MAX_EXACT_DOUBLE_INT / 10) {
+        mantissa *= 10;
+        exponent--;
+    }
+    if (mantissa > DPI_MAX_EXACT_DOUBLE_INT || exponent > 22 ||
+            exponent < -22)
+        return 0;
+    result = (double) mantissa;
+    if (exponent > 0)
+        result *= powersOfTen[exponent];
+    else if (exponent < 0)
+        result /= powersOfTen[-exponent];
+    *value = (isNegative) ? -result : result;
+    return 1;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiUtils__decodeOracleNumberAsInteger() [INTERNAL]
+//   Decode the contents of an Oracle number as a signed or unsigned 64-bit
+// integer without calling OCI. A value of 0 is returned if the number has a
+// fractional part or is out of range for the requested type; OCI must then be
+// used instead so that its rounding and error semantics are retained.
+//-----------------------------------------------------------------------------
+int dpiUtils__decodeOracleNumberAsInteger(const void *oracleValue,
+        int isUnsigned, uint64_t *value)
+{
+    uint64_t mantissa;
+    int16_t exponent;
+    int isNegative;
+
+    if (!dpiUtils__decodeOracleNumber(oracleValue, &isNegative, &mantissa,
+            &exponent))
+        return 0;
+    if (mantissa == 0) {
+        *value = 0;
+        return 1;
+    }
+    for (; exponent < 0; exponent++) {
+        if (mantissa % 10 != 0)
+            return 0;
+        mantissa /= 10;
+    }
+    for (; exponent > 0; exponent--) {
+        if (mantissa > UINT64_MAX / 10)
+            return 0;
+        mantissa *= 10;
+    }
+    if (isUnsigned) {
+        if (isNegative)
+            return 0;
+        *value = mantissa;
+    } else if (isNegative) {
+        if (mantissa > (uint64_t) INT64_MAX + 1)
+            return 0;
+        *value = (uint64_t) 0 - mantissa;
+    } else {
+        if (mantissa > (uint64_t) INT64_MAX)
+            return 0;
+        *value = mantissa;
+    }
+    return 1;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiUtils__ensureBuffer() [INTERNAL]
 //   Ensure that a buffer of the specified size is available. If a buffer of
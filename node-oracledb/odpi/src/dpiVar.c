@@ -243,6 +243,80 @@ static int dpiVar__checkArraySize(dpiVar *var, uint32_t pos,
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiVar__checkColumnBuffer() [INTERNAL]
+//   Verifies that the column buffer can be populated directly from the
+// variable's buffer and reduces the number of rows, if necessary, so that the
+// byte strings for those rows fit in the column buffer. An error is raised if
+// not even a single row fits.
+//-----------------------------------------------------------------------------
+int dpiVar__checkColumnBuffer(dpiVar *var, dpiColumnBuffer *column,
+        uint32_t startRow, uint32_t *numRows, dpiError *error)
+{
+    dpiOracleTypeNum oracleTypeNum = var->type->oracleTypeNum;
+    dpiVarBuffer *buffer = &var->buffer;
+    uint64_t bytesLength;
+    uint32_t i, pos;
+    int supported;
+
+    // verify that the combination of types is supported
+    supported = 0;
+    if (column->nativeTypeNum == var->nativeTypeNum && !var->isDynamic &&
+            !buffer->dynamicBytes && !buffer->objectIndicator &&
+            !var->dynBindBuffers) {
+        switch (var->nativeTypeNum) {
+            case DPI_NATIVE_TYPE_INT64:
+                supported = (oracleTypeNum == DPI_ORACLE_TYPE_NUMBER ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_NATIVE_INT);
+                break;
+            case DPI_NATIVE_TYPE_DOUBLE:
+                supported = (oracleTypeNum == DPI_ORACLE_TYPE_NUMBER ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_NATIVE_DOUBLE ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_DATE ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_TIMESTAMP ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_TIMESTAMP_TZ ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_TIMESTAMP_LTZ);
+                break;
+            case DPI_NATIVE_TYPE_BYTES:
+                supported = (!buffer->tempBuffer &&
+                        (oracleTypeNum == DPI_ORACLE_TYPE_VARCHAR ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_NVARCHAR ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_CHAR ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_NCHAR ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_ROWID ||
+                        oracleTypeNum == DPI_ORACLE_TYPE_RAW));
+                break;
+            default:
+                break;
+        }
+    }
+    if (!supported)
+        return dpiError__set(error, "check column buffer",
+                DPI_ERR_UNHANDLED_CONVERSION, oracleTypeNum,
+                column->nativeTypeNum);
+
+    // for byte strings, determine how many rows fit in the buffer
+    if (var->nativeTypeNum == DPI_NATIVE_TYPE_BYTES) {
+        bytesLength = 0;
+        for (i = 0; i < *numRows; i++) {
+            pos = startRow + i;
+            if (buffer->indicator[pos] == DPI_OCI_IND_NULL)
+                continue;
+            bytesLength += (buffer->actualLength32) ?
+                    buffer->actualLength32[pos] : buffer->actualLength16[pos];
+            if (bytesLength > column->bytesLength)
+                break;
+        }
+        if (i == 0)
+            return dpiError__set(error, "check column buffer size",
+                    DPI_ERR_BUFFER_SIZE_TOO_SMALL, column->bytesLength);
+        *numRows = i;
+    }
+
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiVar__convertToLob() [INTERNAL]
 //   Convert the variable from using dynamic bytes for a long string to using a
@@ -632,6 +706,270 @@ void dpiVar__free(dpiVar *var, dpiError *error)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiVar__getColumnBuffer() [INTERNAL]
+//   Populate the column buffer with the values in the given range of rows of
+// the variable's buffer. Native values are copied directly from the buffer
+// and byte strings are copied into a single contiguous buffer; no dpiData
+// structures are populated. The column buffer is expected to have been
+// checked by dpiVar__checkColumnBuffer() already.
+//-----------------------------------------------------------------------------
+int dpiVar__getColumnBuffer(dpiVar *var, dpiColumnBuffer *column,
+        uint32_t startRow, uint32_t numRows, dpiError *error)
+{
+    dpiOracleTypeNum oracleTypeNum = var->type->oracleTypeNum;
+    dpiVarBuffer *buffer = &var->buffer;
+    uint32_t i, pos, length;
+    int32_t ltzOffset = 0;
+    dpiDataBuffer value;
+    int isFixed = 1;
+    int16_t *ind;
+
+    // check return codes for variable length data
+    ind = &buffer->indicator[startRow];
+    if (buffer->returnCode) {
+        for (i = 0; i < numRows; i++) {
+            pos = startRow + i;
+            if (ind[i] != DPI_OCI_IND_NULL && buffer->returnCode[pos] != 0) {
+                dpiError__set(error, "check return code",
+                        DPI_ERR_COLUMN_FETCH, pos, buffer->returnCode[pos]);
+                error->buffer->code = buffer->returnCode[pos];
+                return DPI_FAILURE;
+            }
+        }
+    }
+
+    // populate the null bitmap, if one was supplied
+    if (column->nullBitmap) {
+        memset(column->nullBitmap, 0, (numRows + 7) / 8);
+        for (i = 0; i < numRows; i++) {
+            if (ind[i] == DPI_OCI_IND_NULL)
+                column->nullBitmap[i / 8] |= (uint8_t) (1 << (i % 8));
+        }
+    }
+
+    // transform the various types
+    switch (oracleTypeNum) {
+        case DPI_ORACLE_TYPE_NATIVE_INT:
+            memcpy(column->asInt64, &buffer->data.asInt64[startRow],
+                    numRows * sizeof(int64_t));
+            break;
+        case DPI_ORACLE_TYPE_NATIVE_DOUBLE:
+            memcpy(column->asDouble, &buffer->data.asDouble[startRow],
+                    numRows * sizeof(double));
+            break;
+        case DPI_ORACLE_TYPE_NUMBER:
+            for (i = 0; i < numRows; i++) {
+                pos = startRow + i;
+                if (ind[i] == DPI_OCI_IND_NULL) {
+                    value.asInt64 = 0;
+                } else if (var->nativeTypeNum == DPI_NATIVE_TYPE_INT64) {
+                    if (dpiDataBuffer__fromOracleNumberAsInteger(&value,
+                            error, &buffer->data.asNumber[pos]) < 0)
+                        return DPI_FAILURE;
+                } else if (dpiDataBuffer__fromOracleNumberAsDouble(&value,
+                        error, &buffer->data.asNumber[pos]) < 0)
+                    return DPI_FAILURE;
+                if (var->nativeTypeNum == DPI_NATIVE_TYPE_INT64)
+                    column->asInt64[i] = value.asInt64;
+                else column->asDouble[i] = value.asDouble;
+            }
+            break;
+        case DPI_ORACLE_TYPE_DATE:
+            for (i = 0; i < numRows; i++) {
+                value.asDouble = 0;
+                if (ind[i] != DPI_OCI_IND_NULL &&
+                        dpiDataBuffer__fromOracleDateAsDouble(&value,
+                                var->env, error,
+                                &buffer->data.asDate[startRow + i]) < 0)
+                    return DPI_FAILURE;
+                column->asDouble[i] = value.asDouble;
+            }
+            break;
+        case DPI_ORACLE_TYPE_TIMESTAMP:
+        case DPI_ORACLE_TYPE_TIMESTAMP_TZ:
+        case DPI_ORACLE_TYPE_TIMESTAMP_LTZ:
+            if (oracleTypeNum == DPI_ORACLE_TYPE_TIMESTAMP_LTZ &&
+                    dpiEnv__getLocalTimeZoneOffset(var->env, &isFixed,
+                            &ltzOffset, error) < 0)
+                return DPI_FAILURE;
+            for (i = 0; i < numRows; i++) {
+                value.asDouble = 0;
+                if (ind[i] != DPI_OCI_IND_NULL &&
+                        dpiDataBuffer__fromOracleTimestampWithOffsetAsDouble(
+                                &value, oracleTypeNum, var->env, error,
+                                buffer->data.asTimestamp[startRow + i],
+                                isFixed, ltzOffset) < 0)
+                    return DPI_FAILURE;
+                column->asDouble[i] = value.asDouble;
+            }
+            break;
+        default:
+            column->offsets[0] = 0;
+            for (i = 0; i < numRows; i++) {
+                pos = startRow + i;
+                column->offsets[i + 1] = column->offsets[i];
+                if (ind[i] == DPI_OCI_IND_NULL)
+                    continue;
+                length = (buffer->actualLength32) ?
+                        buffer->actualLength32[pos] :
+                        buffer->actualLength16[pos];
+                memcpy(column->bytes + column->offsets[i],
+                        buffer->data.asBytes + pos * var->sizeInBytes,
+                        length);
+                column->offsets[i + 1] += length;
+            }
+            break;
+    }
+
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiVar__getColumnValues() [INTERNAL]
+//   Populate the external data for the first numRows rows of the buffer after
+// a fetch. Instead of calling dpiVar__getValue() for each row, which repeats
+// the same type dispatch for every value, the null flags are set for the
+// entire column and the conversion appropriate for the types of the variable
+// is determined once and performed for the entire column. Null values are
+// skipped and columns containing only null values require no conversion at
+// all. Types which have no column conversion are converted one row at a time
+// as before.
+//-----------------------------------------------------------------------------
+int dpiVar__getColumnValues(dpiVar *var, uint32_t numRows, dpiError *error)
+{
+    dpiOracleTypeNum oracleTypeNum;
+    uint32_t i, numNulls;
+    dpiVarBuffer *buffer;
+    dpiData *data;
+
+    // objects, dynamic bytes and dynamic binds are handled one row at a time
+    buffer = &var->buffer;
+    if (buffer->objectIndicator || buffer->dynamicBytes ||
+            var->dynBindBuffers) {
+        for (i = 0; i < numRows; i++) {
+            if (dpiVar__getValue(var, buffer, i, 1, error) < 0)
+                return DPI_FAILURE;
+        }
+        return DPI_SUCCESS;
+    }
+
+    // set the null flags for the entire column
+    data = buffer->externalData;
+    numNulls = 0;
+    for (i = 0; i < numRows; i++) {
+        data[i].isNull = (buffer->indicator[i] == DPI_OCI_IND_NULL);
+        numNulls += data[i].isNull;
+    }
+    if (numNulls == numRows)
+        return DPI_SUCCESS;
+
+    // check return codes for variable length data
+    if (buffer->returnCode) {
+        for (i = 0; i < numRows; i++) {
+            if (!data[i].isNull && buffer->returnCode[i] != 0) {
+                dpiError__set(error, "check return code",
+                        DPI_ERR_COLUMN_FETCH, i, buffer->returnCode[i]);
+                error->buffer->code = buffer->returnCode[i];
+                return DPI_FAILURE;
+            }
+        }
+    }
+
+    // for 11g, dynamic lengths are 32-bit whereas static lengths are 16-bit
+    if (buffer->actualLength16 && buffer->actualLength32) {
+        for (i = 0; i < numRows; i++)
+            buffer->actualLength16[i] = (uint16_t) buffer->actualLength32[i];
+    }
+
+    // transform the various types
+    oracleTypeNum = var->type->oracleTypeNum;
+    switch (var->nativeTypeNum) {
+        case DPI_NATIVE_TYPE_INT64:
+        case DPI_NATIVE_TYPE_UINT64:
+            switch (oracleTypeNum) {
+                case DPI_ORACLE_TYPE_NATIVE_INT:
+                case DPI_ORACLE_TYPE_NATIVE_UINT:
+                    for (i = 0; i < numRows; i++)
+                        data[i].value.asInt64 = buffer->data.asInt64[i];
+                    return DPI_SUCCESS;
+                case DPI_ORACLE_TYPE_NUMBER:
+                    return dpiDataBuffer__fromOracleNumberArray(data,
+                            buffer->data.asNumber, numRows,
+                            var->nativeTypeNum, error);
+                default:
+                    break;
+            }
+            break;
+        case DPI_NATIVE_TYPE_DOUBLE:
+            switch (oracleTypeNum) {
+                case DPI_ORACLE_TYPE_NUMBER:
+                    return dpiDataBuffer__fromOracleNumberArray(data,
+                            buffer->data.asNumber, numRows,
+                            var->nativeTypeNum, error);
+                case DPI_ORACLE_TYPE_NATIVE_DOUBLE:
+                    for (i = 0; i < numRows; i++)
+                        data[i].value.asDouble = buffer->data.asDouble[i];
+                    return DPI_SUCCESS;
+                case DPI_ORACLE_TYPE_DATE:
+                    return dpiDataBuffer__fromOracleDateArrayAsDouble(data,
+                            buffer->data.asDate, numRows, var->env, error);
+                case DPI_ORACLE_TYPE_TIMESTAMP:
+                case DPI_ORACLE_TYPE_TIMESTAMP_TZ:
+                case DPI_ORACLE_TYPE_TIMESTAMP_LTZ:
+                    return dpiDataBuffer__fromOracleTimestampArrayAsDouble(
+                            data, oracleTypeNum, buffer->data.asTimestamp,
+                            numRows, var->env, error);
+                default:
+                    break;
+            }
+            break;
+        case DPI_NATIVE_TYPE_FLOAT:
+            for (i = 0; i < numRows; i++)
+                data[i].value.asFloat = buffer->data.asFloat[i];
+            return DPI_SUCCESS;
+        case DPI_NATIVE_TYPE_BOOLEAN:
+            for (i = 0; i < numRows; i++)
+                data[i].value.asBoolean = buffer->data.asBoolean[i];
+            return DPI_SUCCESS;
+        case DPI_NATIVE_TYPE_BYTES:
+            switch (oracleTypeNum) {
+                case DPI_ORACLE_TYPE_VARCHAR:
+                case DPI_ORACLE_TYPE_NVARCHAR:
+                case DPI_ORACLE_TYPE_CHAR:
+                case DPI_ORACLE_TYPE_NCHAR:
+                case DPI_ORACLE_TYPE_ROWID:
+                case DPI_ORACLE_TYPE_RAW:
+                case DPI_ORACLE_TYPE_LONG_VARCHAR:
+                case DPI_ORACLE_TYPE_LONG_RAW:
+                    if (buffer->actualLength16) {
+                        for (i = 0; i < numRows; i++)
+                            data[i].value.asBytes.length =
+                                    buffer->actualLength16[i];
+                    } else {
+                        for (i = 0; i < numRows; i++)
+                            data[i].value.asBytes.length =
+                                    buffer->actualLength32[i];
+                    }
+                    return DPI_SUCCESS;
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+
+    // all other types are converted one row at a time
+    for (i = 0; i < numRows; i++) {
+        if (dpiVar__getValue(var, buffer, i, 1, error) < 0)
+            return DPI_FAILURE;
+    }
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiVar__getValue() [PRIVATE]
 //   Returns the contents of the variable in the type specified, if possible.
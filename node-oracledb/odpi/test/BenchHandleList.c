@@ -0,0 +1,164 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+// This program is free software: you can modify it and/or redistribute it
+// under the terms of:
+//
+// (i)  the Universal Permissive License v 1.0 or at your option, any
+//      later version (http://oss.oracle.com/licenses/upl); and/or
+//
+// (ii) the Apache License v 2.0. (http://www.apache.org/licenses/LICENSE-2.0)
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// BenchHandleList.c
+//   Measures the time taken to add 100,000 handles to a handle list (as is
+// done for the LOBs open on a connection) and then to repeatedly close one of
+// them and open another while they remain live. The previous implementation
+// (growth by 8 slots and a linear search for an empty slot) is measured
+// alongside for comparison. The ODPI-C source is embedded; neither the Oracle
+// Client libraries nor a database are required.
+//-----------------------------------------------------------------------------
+
+#include "../embed/dpi.c"
+#include <time.h>
+
+// number of live handles and number of close/open cycles
+#define DPI_BENCH_NUM_HANDLES           100000
+#define DPI_BENCH_NUM_CYCLES            20000
+
+// the previous implementation of the handle list
+typedef struct {
+    void **handles;
+    uint32_t numSlots;
+    uint32_t numUsedSlots;
+    uint32_t currentPos;
+} dpiBenchOldList;
+
+
+//-----------------------------------------------------------------------------
+// dpiBench__getTime()
+//   Return a monotonic time in seconds.
+//-----------------------------------------------------------------------------
+static double dpiBench__getTime(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, frequency;
+
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double) count.QuadPart / (double) frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiBench__oldAddHandle()
+//   Add a handle to the list using the previous implementation.
+//-----------------------------------------------------------------------------
+static void dpiBench__oldAddHandle(dpiBenchOldList *list, void *handle,
+        uint32_t *slotNum)
+{
+    uint32_t numSlots, i;
+    void **tempHandles;
+
+    if (list->numUsedSlots == list->numSlots) {
+        numSlots = list->numSlots + 8;
+        tempHandles = calloc(numSlots, sizeof(void*));
+        memcpy(tempHandles, list->handles, list->numSlots * sizeof(void*));
+        free(list->handles);
+        list->handles = tempHandles;
+        list->numSlots = numSlots;
+        *slotNum = list->numUsedSlots++;
+        list->currentPos = list->numUsedSlots;
+    } else {
+        for (i = 0; i < list->numSlots; i++) {
+            if (!list->handles[list->currentPos])
+                break;
+            list->currentPos++;
+            if (list->currentPos == list->numSlots)
+                list->currentPos = 0;
+        }
+        list->numUsedSlots++;
+        *slotNum = list->currentPos++;
+        if (list->currentPos == list->numSlots)
+            list->currentPos = 0;
+    }
+    list->handles[*slotNum] = handle;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiBench__measure()
+//   Add the handles and then perform the close/open cycles, choosing the
+// handle to close pseudo-randomly. The time taken for each phase is returned.
+//-----------------------------------------------------------------------------
+static void dpiBench__measure(int useOldList, uint32_t *slotNums,
+        double *addTime, double *cycleTime)
+{
+    dpiBenchOldList oldList;
+    dpiHandleList *list;
+    uint32_t i, seed, n;
+    double startTime;
+    char handle;
+
+    memset(&oldList, 0, sizeof(oldList));
+    if (dpiHandleList__create(&list, NULL) < 0) {
+        fprintf(stderr, "Unable to create list\n");
+        exit(1);
+    }
+
+    // add handles
+    startTime = dpiBench__getTime();
+    for (i = 0; i < DPI_BENCH_NUM_HANDLES; i++) {
+        if (useOldList)
+            dpiBench__oldAddHandle(&oldList, &handle, &slotNums[i]);
+        else dpiHandleList__addHandle(list, &handle, &slotNums[i], NULL);
+    }
+    *addTime = dpiBench__getTime() - startTime;
+
+    // close and open handles
+    seed = 1;
+    startTime = dpiBench__getTime();
+    for (i = 0; i < DPI_BENCH_NUM_CYCLES; i++) {
+        seed = seed * 1103515245 + 12345;
+        n = (seed >> 8) % DPI_BENCH_NUM_HANDLES;
+        if (useOldList) {
+            oldList.handles[slotNums[n]] = NULL;
+            oldList.numUsedSlots--;
+            dpiBench__oldAddHandle(&oldList, &handle, &slotNums[n]);
+        } else {
+            dpiHandleList__removeHandle(list, slotNums[n]);
+            dpiHandleList__addHandle(list, &handle, &slotNums[n], NULL);
+        }
+    }
+    *cycleTime = dpiBench__getTime() - startTime;
+
+    free(oldList.handles);
+    dpiHandleList__free(list);
+}
+
+
+//-----------------------------------------------------------------------------
+// main()
+//-----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    double oldAddTime, oldCycleTime, addTime, cycleTime;
+    uint32_t *slotNums;
+
+    slotNums = malloc(DPI_BENCH_NUM_HANDLES * sizeof(uint32_t));
+    dpiBench__measure(1, slotNums, &oldAddTime, &oldCycleTime);
+    dpiBench__measure(0, slotNums, &addTime, &cycleTime);
+    printf("%-36s %14s %14s\n", "", "Previous (s)", "Free list (s)");
+    printf("Add %-32u %14.4f %14.4f\n", DPI_BENCH_NUM_HANDLES, oldAddTime,
+            addTime);
+    printf("Close/open %-25u %14.4f %14.4f\n", DPI_BENCH_NUM_CYCLES,
+            oldCycleTime, cycleTime);
+    free(slotNums);
+    return 0;
+}
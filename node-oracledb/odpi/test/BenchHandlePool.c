@@ -0,0 +1,183 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+// This program is free software: you can modify it and/or redistribute it
+// under the terms of:
+//
+// (i)  the Universal Permissive License v 1.0 or at your option, any
+//      later version (http://oss.oracle.com/licenses/upl); and/or
+//
+// (ii) the Apache License v 2.0. (http://www.apache.org/licenses/LICENSE-2.0)
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// BenchHandlePool.c
+//   Measures the throughput of acquiring and releasing error handles from the
+// handle pool with increasing numbers of threads, the pattern followed by
+// every public function call. A pool protected by a single mutex (the
+// previous implementation) is measured alongside for comparison. The ODPI-C
+// source is embedded; neither the Oracle Client libraries nor a database are
+// required.
+//-----------------------------------------------------------------------------
+
+#include "../embed/dpi.c"
+#include <time.h>
+
+// maximum number of threads and number of iterations performed by each thread
+#define DPI_BENCH_MAX_THREADS           64
+#define DPI_BENCH_NUM_ITERS             1000000
+
+// a pool of handles protected by a single mutex
+typedef struct {
+    void *handles[DPI_BENCH_MAX_THREADS * 2];
+    uint32_t numHandles;
+    dpiMutexType mutex;
+} dpiBenchMutexPool;
+
+// state shared by the threads taking part in a run
+typedef struct {
+    dpiHandlePool *pool;
+    dpiBenchMutexPool mutexPool;
+    char fakeHandles[DPI_BENCH_MAX_THREADS * 16];
+    uint32_t numFakeHandles;
+    int useMutexPool;
+} dpiBenchState;
+
+
+//-----------------------------------------------------------------------------
+// dpiBench__getTime()
+//   Return a monotonic time in seconds.
+//-----------------------------------------------------------------------------
+static double dpiBench__getTime(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, frequency;
+
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double) count.QuadPart / (double) frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiBench__newHandle()
+//   Return a new fake handle, as the caller would create a new OCI handle
+// when the pool is empty.
+//-----------------------------------------------------------------------------
+static void *dpiBench__newHandle(dpiBenchState *state)
+{
+    void *handle;
+
+    dpiMutex__acquire(state->mutexPool.mutex);
+    if (state->numFakeHandles == sizeof(state->fakeHandles)) {
+        fprintf(stderr, "Too many handles created\n");
+        exit(1);
+    }
+    handle = &state->fakeHandles[state->numFakeHandles++];
+    dpiMutex__release(state->mutexPool.mutex);
+    return handle;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiBench__run()
+//   Acquire and release a handle repeatedly.
+//-----------------------------------------------------------------------------
+static void *dpiBench__run(dpiBenchState *state)
+{
+    dpiBenchMutexPool *mutexPool = &state->mutexPool;
+    void *handle;
+    uint32_t i;
+
+    for (i = 0; i < DPI_BENCH_NUM_ITERS; i++) {
+        if (state->useMutexPool) {
+            dpiMutex__acquire(mutexPool->mutex);
+            handle = (mutexPool->numHandles > 0) ?
+                    mutexPool->handles[--mutexPool->numHandles] : NULL;
+            dpiMutex__release(mutexPool->mutex);
+            if (!handle)
+                handle = dpiBench__newHandle(state);
+            dpiMutex__acquire(mutexPool->mutex);
+            mutexPool->handles[mutexPool->numHandles++] = handle;
+            dpiMutex__release(mutexPool->mutex);
+        } else {
+            dpiHandlePool__acquire(state->pool, &handle);
+            if (!handle)
+                handle = dpiBench__newHandle(state);
+            dpiHandlePool__release(state->pool, &handle);
+        }
+    }
+    return NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiBench__measure()
+//   Run the benchmark with the given number of threads and return the number
+// of acquire/release pairs performed per second.
+//-----------------------------------------------------------------------------
+static double dpiBench__measure(uint32_t numThreads, int useMutexPool)
+{
+#ifdef _WIN32
+    HANDLE threads[DPI_BENCH_MAX_THREADS];
+#else
+    pthread_t threads[DPI_BENCH_MAX_THREADS];
+#endif
+    dpiBenchState state;
+    double startTime;
+    uint32_t i;
+
+    memset(&state, 0, sizeof(state));
+    dpiMutex__initialize(state.mutexPool.mutex);
+    state.useMutexPool = useMutexPool;
+    if (dpiHandlePool__create(&state.pool, NULL) < 0) {
+        fprintf(stderr, "Unable to create pool\n");
+        exit(1);
+    }
+    startTime = dpiBench__getTime();
+    for (i = 0; i < numThreads; i++) {
+#ifdef _WIN32
+        threads[i] = CreateThread(NULL, 0,
+                (LPTHREAD_START_ROUTINE) dpiBench__run, &state, 0, NULL);
+#else
+        pthread_create(&threads[i], NULL, (void *(*)(void*)) dpiBench__run,
+                &state);
+#endif
+    }
+    for (i = 0; i < numThreads; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+    dpiHandlePool__free(state.pool);
+    dpiMutex__destroy(state.mutexPool.mutex);
+    return (double) numThreads * DPI_BENCH_NUM_ITERS /
+            (dpiBench__getTime() - startTime);
+}
+
+
+//-----------------------------------------------------------------------------
+// main()
+//-----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    double mutexRate, poolRate;
+    uint32_t numThreads;
+
+    printf("%8s %18s %18s\n", "Threads", "Mutex (ops/s)", "Lock-free (ops/s)");
+    for (numThreads = 1; numThreads <= DPI_BENCH_MAX_THREADS;
+            numThreads *= 2) {
+        mutexRate = dpiBench__measure(numThreads, 1);
+        poolRate = dpiBench__measure(numThreads, 0);
+        printf("%8u %18.0f %18.0f\n", numThreads, mutexRate, poolRate);
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+// This program is free software: you can modify it and/or redistribute it
+// under the terms of:
+//
+// (i)  the Universal Permissive License v 1.0 or at your option, any
+//      later version (http://oss.oracle.com/licenses/upl); and/or
+//
+// (ii) the Apache License v 2.0. (http://www.apache.org/licenses/LICENSE-2.0)
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// TestBindIndex.c
+//   Test suite for testing the index used to look up the bind variables of a
+// statement by position or name. The ODPI-C source is embedded so that
+// internal functions can be called; neither the Oracle Client libraries nor a
+// database are required.
+//-----------------------------------------------------------------------------
+
+#include "../embed/dpi.c"
+#include "TestLib.h"
+
+// number of bind variables added by name and by position
+#define DPI_TEST_NUM_BIND_VARS          300
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__addBindVars() [INTERNAL]
+//   Add the specified number of bind variables by name and by position. Each
+// name is built from the number and a prefix that differs only in case.
+//-----------------------------------------------------------------------------
+static int dpiTest__addBindVars(dpiTestCase *testCase, dpiStmt *stmt,
+        uint32_t numBindVars)
+{
+    dpiBindVar *entry;
+    char name[20];
+    uint32_t i;
+
+    for (i = 0; i < numBindVars; i++) {
+        sprintf(name, "%s%u", (i % 2) ? "VAL" : "val", i);
+        if (dpiStmt__addBindVar(stmt, 0, name, (uint32_t) strlen(name),
+                &entry, NULL) < 0)
+            return dpiTestCase_setFailed(testCase, "Unable to add name.");
+        if (dpiStmt__addBindVar(stmt, i + 1, NULL, 0, &entry, NULL) < 0)
+            return dpiTestCase_setFailed(testCase, "Unable to add pos.");
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__findBindVar() [INTERNAL]
+//   Return the bind variable with the given position or name or NULL if no
+// such bind variable exists.
+//-----------------------------------------------------------------------------
+static dpiBindVar *dpiTest__findBindVar(dpiStmt *stmt, uint32_t pos,
+        const char *name)
+{
+    uint32_t nameLength, *indexSlot;
+
+    nameLength = (name) ? (uint32_t) strlen(name) : 0;
+    indexSlot = dpiStmt__getBindVarIndexSlot(stmt, pos, name, nameLength);
+    return (*indexSlot) ? &stmt->bindVars[*indexSlot - 1] : NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__freeBindVars() [INTERNAL]
+//   Free the bind variables added to the statement. No variables are bound so
+// the names and arrays are freed directly.
+//-----------------------------------------------------------------------------
+static void dpiTest__freeBindVars(dpiStmt *stmt)
+{
+    uint32_t i;
+
+    for (i = 0; i < stmt->numBindVars; i++) {
+        if (stmt->bindVars[i].name)
+            dpiUtils__freeMemory((void*) stmt->bindVars[i].name);
+    }
+    dpiUtils__freeMemory(stmt->bindVars);
+    dpiUtils__freeMemory(stmt->bindVarIndex);
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3800_verifyBindVarsFound()
+//   Add bind variables by name and by position and verify that each one is
+// found in the index; verify that names which differ only in case are
+// distinct and that positions and names are not confused (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3800_verifyBindVarsFound(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    dpiBindVar *entry;
+    char name[20];
+    dpiStmt stmt;
+    uint32_t i;
+
+    memset(&stmt, 0, sizeof(stmt));
+    if (dpiTest__addBindVars(testCase, &stmt, DPI_TEST_NUM_BIND_VARS) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectUintEqual(testCase, stmt.numBindVars,
+            DPI_TEST_NUM_BIND_VARS * 2) < 0)
+        return DPI_FAILURE;
+    for (i = 0; i < DPI_TEST_NUM_BIND_VARS; i++) {
+        sprintf(name, "%s%u", (i % 2) ? "VAL" : "val", i);
+        entry = dpiTest__findBindVar(&stmt, 0, name);
+        if (entry != &stmt.bindVars[i * 2])
+            return dpiTestCase_setFailed(testCase, "Name not found.");
+        entry = dpiTest__findBindVar(&stmt, i + 1, NULL);
+        if (entry != &stmt.bindVars[i * 2 + 1])
+            return dpiTestCase_setFailed(testCase, "Position not found.");
+        sprintf(name, "%s%u", (i % 2) ? "val" : "VAL", i);
+        if (dpiTest__findBindVar(&stmt, 0, name))
+            return dpiTestCase_setFailed(testCase, "Name matched other case.");
+    }
+    if (dpiTest__findBindVar(&stmt, DPI_TEST_NUM_BIND_VARS + 1, NULL))
+        return dpiTestCase_setFailed(testCase, "Unknown position found.");
+    if (dpiTest__findBindVar(&stmt, 0, "val"))
+        return dpiTestCase_setFailed(testCase, "Name prefix found.");
+    dpiTest__freeBindVars(&stmt);
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3801_verifyBindVarIndexGrowth()
+//   Verify that the list of bind variables doubles in size as it fills and
+// that the index always has twice as many slots as there are allocated bind
+// variables, with one occupied slot for each bind variable (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3801_verifyBindVarIndexGrowth(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    uint32_t i, numOccupied;
+    dpiStmt stmt;
+
+    memset(&stmt, 0, sizeof(stmt));
+    if (dpiTest__addBindVars(testCase, &stmt, 4) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectUintEqual(testCase, stmt.allocatedBindVars, 8) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__addBindVars(testCase, &stmt, 1) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectUintEqual(testCase, stmt.allocatedBindVars, 16) < 0)
+        return DPI_FAILURE;
+    dpiTest__freeBindVars(&stmt);
+    memset(&stmt, 0, sizeof(stmt));
+    if (dpiTest__addBindVars(testCase, &stmt, DPI_TEST_NUM_BIND_VARS) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectUintEqual(testCase, stmt.allocatedBindVars,
+            1024) < 0)
+        return DPI_FAILURE;
+    numOccupied = 0;
+    for (i = 0; i < stmt.allocatedBindVars * 2; i++) {
+        if (stmt.bindVarIndex[i] > stmt.numBindVars)
+            return dpiTestCase_setFailed(testCase, "Invalid index slot.");
+        if (stmt.bindVarIndex[i])
+            numOccupied++;
+    }
+    if (dpiTestCase_expectUintEqual(testCase, numOccupied,
+            stmt.numBindVars) < 0)
+        return DPI_FAILURE;
+    dpiTest__freeBindVars(&stmt);
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// main()
+//-----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    dpiTestSuite_initializeWithoutContext(3800);
+    dpiTestSuite_addCase(dpiTest_3800_verifyBindVarsFound,
+            "verify bind variables are found by name and position");
+    dpiTestSuite_addCase(dpiTest_3801_verifyBindVarIndexGrowth,
+            "verify bind variable list and index growth");
+    return dpiTestSuite_run();
+}
@@ -0,0 +1,826 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+// This program is free software: you can modify it and/or redistribute it
+// under the terms of:
+//
+// (i)  the Universal Permissive License v 1.0 or at your option, any
+//      later version (http://oss.oracle.com/licenses/upl); and/or
+//
+// (ii) the Apache License v 2.0. (http://www.apache.org/licenses/LICENSE-2.0)
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// TestConversions.c
+//   Test suite for testing the internal conversion routines directly. The
+// ODPI-C source is embedded so that internal functions can be called; neither
+// the Oracle Client libraries nor a database are required.
+//-----------------------------------------------------------------------------
+
+#include "../embed/dpi.c"
+#include "TestLib.h"
+
+// number of rows used when testing column conversions
+#define DPI_TEST_COLUMN_ROWS            50
+
+//-----------------------------------------------------------------------------
+// dpiTest__encodeNumber() [INTERNAL]
+//   Encode the string as an Oracle number using the same routine that is used
+// when binding numbers as strings.
+//-----------------------------------------------------------------------------
+static int dpiTest__encodeNumber(dpiTestCase *testCase, const char *value,
+        dpiOciNumber *oracleValue)
+{
+    dpiErrorBuffer errorBuffer;
+    dpiDataBuffer data;
+    char message[512];
+    dpiError error;
+    dpiEnv env;
+
+    memset(&env, 0, sizeof(env));
+    env.charsetId = DPI_CHARSET_ID_UTF8;
+    error.buffer = &errorBuffer;
+    error.handle = NULL;
+    error.env = NULL;
+    data.asBytes.ptr = (char*) value;
+    data.asBytes.length = (uint32_t) strlen(value);
+    if (dpiDataBuffer__toOracleNumberFromText(&data, &env, &error,
+            oracleValue) < 0) {
+        snprintf(message, sizeof(message), "Unable to encode %s: %.*s\n",
+                value, errorBuffer.messageLength, errorBuffer.message);
+        return dpiTestCase_setFailed(testCase, message);
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__expectDateAsDouble() [INTERNAL]
+//   Convert the date to a double (number of milliseconds since January 1,
+// 1970) and verify that it matches the expected value. No environment is
+// passed so that a failure results if OCI would be required.
+//-----------------------------------------------------------------------------
+static int dpiTest__expectDateAsDouble(dpiTestCase *testCase, int16_t year,
+        uint8_t month, uint8_t day, uint8_t hour, uint8_t minute,
+        uint8_t second, double expectedValue)
+{
+    dpiOciDate oracleValue;
+    dpiDataBuffer data;
+
+    oracleValue.year = year;
+    oracleValue.month = month;
+    oracleValue.day = day;
+    oracleValue.hour = hour;
+    oracleValue.minute = minute;
+    oracleValue.second = second;
+    if (dpiDataBuffer__fromOracleDateAsDouble(&data, NULL, NULL,
+            &oracleValue) < 0)
+        return dpiTestCase_setFailed(testCase, "Date was not calculated.");
+    return dpiTestCase_expectDoubleEqual(testCase, data.asDouble,
+            expectedValue);
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__expectDoubleDecoded() [INTERNAL]
+//   Encode the string as an Oracle number, decode it as a double and verify
+// that it matches the value returned by strtod().
+//-----------------------------------------------------------------------------
+static int dpiTest__expectDoubleDecoded(dpiTestCase *testCase,
+        const char *value)
+{
+    dpiOciNumber oracleValue;
+    char message[512];
+    double decoded;
+
+    if (dpiTest__encodeNumber(testCase, value, &oracleValue) < 0)
+        return DPI_FAILURE;
+    if (!dpiUtils__decodeOracleNumberAsDouble(&oracleValue, &decoded)) {
+        snprintf(message, sizeof(message), "Value %s was not decoded.\n",
+                value);
+        return dpiTestCase_setFailed(testCase, message);
+    }
+    return dpiTestCase_expectDoubleEqual(testCase, decoded,
+            strtod(value, NULL));
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__expectEpochMs() [INTERNAL]
+//   Calculate the number of milliseconds since January 1, 1970 for the given
+// timestamp and verify that it matches the expected value.
+//-----------------------------------------------------------------------------
+static int dpiTest__expectEpochMs(dpiTestCase *testCase, int16_t year,
+        uint8_t month, uint8_t day, uint8_t hour, uint8_t minute,
+        uint8_t second, uint32_t fsecond, int32_t tzOffset,
+        double expectedValue)
+{
+    double value;
+
+    if (!dpiDataBuffer__getEpochMs(year, month, day, hour, minute, second,
+            fsecond, tzOffset, &value))
+        return dpiTestCase_setFailed(testCase,
+                "Timestamp was not calculated.");
+    return dpiTestCase_expectDoubleEqual(testCase, value, expectedValue);
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__expectIntDecoded() [INTERNAL]
+//   Encode the string as an Oracle number, decode it as a signed or unsigned
+// integer and verify that it matches the value parsed from the string.
+//-----------------------------------------------------------------------------
+static int dpiTest__expectIntDecoded(dpiTestCase *testCase, const char *value,
+        int isUnsigned)
+{
+    dpiOciNumber oracleValue;
+    char message[512];
+    uint64_t decoded;
+
+    if (dpiTest__encodeNumber(testCase, value, &oracleValue) < 0)
+        return DPI_FAILURE;
+    if (!dpiUtils__decodeOracleNumberAsInteger(&oracleValue, isUnsigned,
+            &decoded)) {
+        snprintf(message, sizeof(message), "Value %s was not decoded.\n",
+                value);
+        return dpiTestCase_setFailed(testCase, message);
+    }
+    if (isUnsigned)
+        return dpiTestCase_expectUintEqual(testCase, decoded,
+                strtoull(value, NULL, 10));
+    return dpiTestCase_expectIntEqual(testCase, (int64_t) decoded,
+            strtoll(value, NULL, 10));
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__expectNotDecoded() [INTERNAL]
+//   Encode the string as an Oracle number and verify that it is rejected by
+// the integer decoder (isUnsigned = 0 or 1) or the double decoder
+// (isUnsigned = -1) so that the OCI routines will be used instead.
+//-----------------------------------------------------------------------------
+static int dpiTest__expectNotDecoded(dpiTestCase *testCase, const char *value,
+        int isUnsigned)
+{
+    dpiOciNumber oracleValue;
+    char message[512];
+    uint64_t intValue;
+    double dblValue;
+    int decoded;
+
+    if (dpiTest__encodeNumber(testCase, value, &oracleValue) < 0)
+        return DPI_FAILURE;
+    if (isUnsigned < 0)
+        decoded = dpiUtils__decodeOracleNumberAsDouble(&oracleValue,
+                &dblValue);
+    else decoded = dpiUtils__decodeOracleNumberAsInteger(&oracleValue,
+            isUnsigned, &intValue);
+    if (decoded) {
+        snprintf(message, sizeof(message),
+                "Value %s should not have been decoded.\n", value);
+        return dpiTestCase_setFailed(testCase, message);
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__nextRandom() [INTERNAL]
+//   Return the next value from a simple deterministic pseudo-random generator
+// so that failures are reproducible.
+//-----------------------------------------------------------------------------
+static uint64_t dpiTest__nextRandom(uint64_t *state)
+{
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *state;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__verifyColumnValues() [INTERNAL]
+//   Populate the external data of the variable for the entire column and
+// verify that it matches the external data populated one row at a time by
+// dpiVar__getValue().
+//-----------------------------------------------------------------------------
+static int dpiTest__verifyColumnValues(dpiTestCase *testCase, dpiVar *var,
+        uint32_t numRows)
+{
+    dpiData columnData[DPI_TEST_COLUMN_ROWS], *rowData;
+    dpiErrorBuffer errorBuffer;
+    dpiError error;
+    uint32_t i;
+
+    error.buffer = &errorBuffer;
+    error.handle = NULL;
+    error.env = NULL;
+    rowData = var->buffer.externalData;
+    var->buffer.externalData = columnData;
+    memcpy(columnData, rowData, numRows * sizeof(dpiData));
+    if (dpiVar__getColumnValues(var, numRows, &error) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to get column.");
+    var->buffer.externalData = rowData;
+    for (i = 0; i < numRows; i++) {
+        if (dpiVar__getValue(var, &var->buffer, i, 1, &error) < 0)
+            return dpiTestCase_setFailed(testCase, "Unable to get value.");
+        if (dpiTestCase_expectIntEqual(testCase, columnData[i].isNull,
+                rowData[i].isNull) < 0)
+            return DPI_FAILURE;
+        if (rowData[i].isNull)
+            continue;
+        if (var->nativeTypeNum == DPI_NATIVE_TYPE_BYTES) {
+            if (dpiTestCase_expectStringEqual(testCase,
+                    columnData[i].value.asBytes.ptr,
+                    columnData[i].value.asBytes.length,
+                    rowData[i].value.asBytes.ptr,
+                    rowData[i].value.asBytes.length) < 0)
+                return DPI_FAILURE;
+        } else if (var->nativeTypeNum == DPI_NATIVE_TYPE_DOUBLE) {
+            if (dpiTestCase_expectDoubleEqual(testCase,
+                    columnData[i].value.asDouble,
+                    rowData[i].value.asDouble) < 0)
+                return DPI_FAILURE;
+        } else if (dpiTestCase_expectIntEqual(testCase,
+                columnData[i].value.asInt64, rowData[i].value.asInt64) < 0)
+            return DPI_FAILURE;
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3600_decodeSignedIntegers()
+//   Encode a set of signed integers covering the boundaries of the base-100
+// digits and of the 64-bit range and verify that each one is decoded
+// correctly (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3600_decodeSignedIntegers(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    const char *values[] = {
+        "0", "1", "-1", "9", "10", "99", "100", "-100", "101", "-101",
+        "1000000", "-1000000", "123456789", "-123456789", "1000000000000",
+        "9007199254740993", "-9007199254740993", "100000000000000000",
+        "1000000000000000000", "-1000000000000000000",
+        "9223372036854775807", "-9223372036854775807",
+        "-9223372036854775808", NULL
+    };
+    int i;
+
+    for (i = 0; values[i]; i++) {
+        if (dpiTest__expectIntDecoded(testCase, values[i], 0) < 0)
+            return DPI_FAILURE;
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3601_decodeUnsignedIntegers()
+//   Encode a set of unsigned integers including those larger than can be
+// represented by a signed integer and verify that each one is decoded
+// correctly (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3601_decodeUnsignedIntegers(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    const char *values[] = {
+        "0", "1", "99", "100", "9223372036854775807", "9223372036854775808",
+        "10000000000000000000", "18446744073709551600",
+        "18446744073709551614", "18446744073709551615", NULL
+    };
+    int i;
+
+    for (i = 0; values[i]; i++) {
+        if (dpiTest__expectIntDecoded(testCase, values[i], 1) < 0)
+            return DPI_FAILURE;
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3602_verifyIntegersNotDecoded()
+//   Verify that values which are out of range or which have a fractional
+// part are not decoded as integers so that OCI is used for them (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3602_verifyIntegersNotDecoded(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    const char *signedValues[] = {
+        "9223372036854775808", "-9223372036854775809", "1e19", "-1e20",
+        "0.5", "-0.5", "1.25", "12345.678", "1e125", "-1e-10", NULL
+    };
+    const char *unsignedValues[] = {
+        "-1", "18446744073709551616", "1e20", "0.01", "99.9", NULL
+    };
+    int i;
+
+    for (i = 0; signedValues[i]; i++) {
+        if (dpiTest__expectNotDecoded(testCase, signedValues[i], 0) < 0)
+            return DPI_FAILURE;
+    }
+    for (i = 0; unsignedValues[i]; i++) {
+        if (dpiTest__expectNotDecoded(testCase, unsignedValues[i], 1) < 0)
+            return DPI_FAILURE;
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3603_decodeDoubles()
+//   Encode a set of values which can be represented exactly by the fast path
+// and verify that each one is decoded to the same double as returned by
+// strtod() (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3603_decodeDoubles(dpiTestCase *testCase, dpiTestParams *params)
+{
+    const char *values[] = {
+        "0", "1", "-1", "0.1", "-0.1", "0.5", "1.5", "3.14159265358979",
+        "-2.718281828459", "123.456", "0.000001", "-1e-22", "1e22",
+        "12345678.9", "9007199254740992", "-9007199254740992", "1e23",
+        "-123e30",
+        "4503599627370497", "0.3", "1.7976931348", "9999999999999.99",
+        NULL
+    };
+    int i;
+
+    for (i = 0; values[i]; i++) {
+        if (dpiTest__expectDoubleDecoded(testCase, values[i]) < 0)
+            return DPI_FAILURE;
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3604_verifyDoublesNotDecoded()
+//   Verify that values which cannot be guaranteed to be correctly rounded by
+// the fast path are not decoded so that OCI is used for them (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3604_verifyDoublesNotDecoded(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    const char *values[] = {
+        "9007199254740993", "-9007199254740993", "1e40", "1e-24",
+        "1.23456789012345678", "1e125", "-1e-129",
+        "1234567890123456789012345678901234567890", NULL
+    };
+    int i;
+
+    for (i = 0; values[i]; i++) {
+        if (dpiTest__expectNotDecoded(testCase, values[i], -1) < 0)
+            return DPI_FAILURE;
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3605_verifySpecialValuesNotDecoded()
+//   Verify that the special values for +/-1e126 and corrupt values are not
+// decoded (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3605_verifySpecialValuesNotDecoded(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    dpiOciNumber positiveInfinity = { { 2, 255, 101 } };
+    dpiOciNumber negativeInfinity = { { 1, 0 } };
+    dpiOciNumber corrupt = { { 22, 193, 2 } };
+    dpiOciNumber *values[3];
+    uint64_t intValue;
+    double dblValue;
+    int i;
+
+    values[0] = &positiveInfinity;
+    values[1] = &negativeInfinity;
+    values[2] = &corrupt;
+    for (i = 0; i < 3; i++) {
+        if (dpiUtils__decodeOracleNumberAsDouble(values[i], &dblValue) ||
+                dpiUtils__decodeOracleNumberAsInteger(values[i], 0,
+                        &intValue) ||
+                dpiUtils__decodeOracleNumberAsInteger(values[i], 1,
+                        &intValue))
+            return dpiTestCase_setFailed(testCase,
+                    "Special value should not have been decoded.");
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3606_roundTripRandomIntegers()
+//   Encode a large number of pseudo-random signed integers of varying
+// magnitude and verify that each one is decoded back to the original value
+// (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3606_roundTripRandomIntegers(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    uint64_t state = 3606;
+    char value[32];
+    int64_t num;
+    int i;
+
+    for (i = 0; i < 100000; i++) {
+        num = (int64_t) (dpiTest__nextRandom(&state) >> (i % 63 + 1));
+        if (i % 2)
+            num = -num;
+        snprintf(value, sizeof(value), "%" PRId64, num);
+        if (dpiTest__expectIntDecoded(testCase, value, 0) < 0)
+            return DPI_FAILURE;
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3607_roundTripRandomDoubles()
+//   Encode a large number of pseudo-random decimal values with up to 15
+// significant digits and scales up to 10^(+/-22) and verify that each one is
+// decoded to the same double as returned by strtod() (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3607_roundTripRandomDoubles(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    uint64_t state = 3607, mantissa;
+    int exponent, i;
+    char value[64];
+
+    for (i = 0; i < 100000; i++) {
+        mantissa = dpiTest__nextRandom(&state) % 1000000000000000ULL;
+        exponent = (int) (dpiTest__nextRandom(&state) % 45) - 22;
+        snprintf(value, sizeof(value), "%s%" PRIu64 "e%d",
+                (i % 2) ? "-" : "", mantissa, exponent);
+        if (dpiTest__expectDoubleDecoded(testCase, value) < 0)
+            return DPI_FAILURE;
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3608_verifyDatesAsDoubles()
+//   Verify that dates at well known points in time are converted to the
+// expected number of milliseconds since January 1, 1970 without OCI, including
+// dates on either side of the change from the Julian to the Gregorian
+// calendar (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3608_verifyDatesAsDoubles(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    if (dpiTest__expectDateAsDouble(testCase, 1970, 1, 1, 0, 0, 0, 0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectDateAsDouble(testCase, 1969, 12, 31, 23, 59, 59,
+            -1000) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectDateAsDouble(testCase, 2000, 1, 1, 0, 0, 0,
+            946684800000.0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectDateAsDouble(testCase, 2000, 2, 29, 12, 34, 56,
+            951827696000.0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectDateAsDouble(testCase, 2038, 1, 19, 3, 14, 8,
+            2147483648000.0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectDateAsDouble(testCase, 1900, 3, 1, 0, 0, 0,
+            -2203891200000.0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectDateAsDouble(testCase, 9999, 12, 31, 23, 59, 59,
+            253402300799000.0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectDateAsDouble(testCase, 1582, 10, 15, 0, 0, 0,
+            -12219292800000.0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectDateAsDouble(testCase, 1582, 10, 4, 0, 0, 0,
+            -12219379200000.0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectDateAsDouble(testCase, 1, 1, 1, 0, 0, 0,
+            -62135769600000.0) < 0)
+        return DPI_FAILURE;
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3609_verifyConsecutiveDays()
+//   Walk through every day from January 1, 1 to December 31, 9999 using the
+// Julian calendar up to October 4, 1582 and the Gregorian calendar from
+// October 15, 1582 and verify that each day is converted to exactly one day
+// after the previous one (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3609_verifyConsecutiveDays(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    static const uint8_t daysInMonth[12] =
+            { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    double expectedValue = -62135769600000.0;
+    uint8_t month, day, lastDay;
+    int16_t year;
+    int isLeap;
+
+    for (year = 1; year <= 9999; year++) {
+        if (year < 1582)
+            isLeap = (year % 4 == 0);
+        else isLeap = (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0));
+        for (month = 1; month <= 12; month++) {
+            lastDay = daysInMonth[month - 1];
+            if (month == 2 && isLeap)
+                lastDay++;
+            for (day = 1; day <= lastDay; day++) {
+                if (year == 1582 && month == 10 && day == 5)
+                    day = 15;
+                if (dpiTest__expectDateAsDouble(testCase, year, month, day,
+                        0, 0, 0, expectedValue) < 0)
+                    return DPI_FAILURE;
+                expectedValue += 86400000.0;
+            }
+        }
+    }
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3610_verifyTimestampsAsDoubles()
+//   Verify that fractional seconds are truncated toward zero and that time
+// zone offsets are applied when timestamps are converted to the number of
+// milliseconds since January 1, 1970 (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3610_verifyTimestampsAsDoubles(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    if (dpiTest__expectEpochMs(testCase, 1970, 1, 1, 0, 0, 0, 999999, 0,
+            0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectEpochMs(testCase, 1970, 1, 1, 0, 0, 1, 123456789, 0,
+            1123) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectEpochMs(testCase, 1969, 12, 31, 23, 59, 59, 999500000,
+            0, 0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectEpochMs(testCase, 1969, 12, 31, 23, 59, 58, 500000000,
+            0, -1500) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectEpochMs(testCase, 1970, 1, 1, 5, 30, 0, 0, 330,
+            0) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectEpochMs(testCase, 1969, 12, 31, 14, 15, 0, 250000000,
+            -585, 250) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__expectEpochMs(testCase, 2021, 3, 14, 2, 30, 0, 0, -480,
+            1615717800000.0) < 0)
+        return DPI_FAILURE;
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3611_verifyDatesBeforeYearOneNotCalculated()
+//   Verify that dates prior to year 1 are not calculated directly so that OCI
+// date arithmetic will be used instead (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3611_verifyDatesBeforeYearOneNotCalculated(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    double value;
+
+    if (dpiDataBuffer__getEpochMs(-1, 12, 31, 23, 59, 59, 0, 0, &value) ||
+            dpiDataBuffer__getEpochMs(-4712, 1, 1, 0, 0, 0, 0, 0, &value))
+        return dpiTestCase_setFailed(testCase,
+                "Date prior to year 1 should not have been calculated.");
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3612_verifyColumnValues()
+//   Populate buffers for columns of various types containing null values and
+// verify that converting each column at once gives the same results as
+// converting each row separately (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3612_verifyColumnValues(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    char strings[DPI_TEST_COLUMN_ROWS][16];
+    dpiData externalData[DPI_TEST_COLUMN_ROWS];
+    int16_t indicator[DPI_TEST_COLUMN_ROWS];
+    uint16_t actualLength16[DPI_TEST_COLUMN_ROWS];
+    dpiOciNumber numbers[DPI_TEST_COLUMN_ROWS];
+    dpiOciDate dates[DPI_TEST_COLUMN_ROWS];
+    int64_t ints[DPI_TEST_COLUMN_ROWS];
+    double doubles[DPI_TEST_COLUMN_ROWS];
+    dpiErrorBuffer errorBuffer;
+    dpiError error;
+    uint32_t i;
+    dpiVar var;
+
+    // populate buffers; every third row is null
+    error.buffer = &errorBuffer;
+    error.handle = NULL;
+    error.env = NULL;
+    memset(&var, 0, sizeof(var));
+    memset(externalData, 0, sizeof(externalData));
+    for (i = 0; i < DPI_TEST_COLUMN_ROWS; i++) {
+        indicator[i] = (i % 3 == 0) ? DPI_OCI_IND_NULL : DPI_OCI_IND_NOTNULL;
+        ints[i] = (int64_t) i * 1000003 - 25000000;
+        doubles[i] = ints[i] / 7.0;
+        snprintf(strings[i], sizeof(strings[i]), "%" PRId64, ints[i]);
+        actualLength16[i] = (uint16_t) strlen(strings[i]);
+        if (dpiTest__encodeNumber(testCase, strings[i], &numbers[i]) < 0)
+            return DPI_FAILURE;
+        dates[i].year = (int16_t) (1 + i * 199);
+        dates[i].month = (uint8_t) (i % 12 + 1);
+        dates[i].day = (uint8_t) (i % 28 + 1);
+        dates[i].hour = (uint8_t) (i % 24);
+        dates[i].minute = (uint8_t) (i % 60);
+        dates[i].second = (uint8_t) ((i * 7) % 60);
+    }
+    var.buffer.maxArraySize = DPI_TEST_COLUMN_ROWS;
+    var.buffer.indicator = indicator;
+    var.buffer.externalData = externalData;
+
+    // native integers
+    var.type = dpiOracleType__getFromNum(DPI_ORACLE_TYPE_NATIVE_INT, &error);
+    var.nativeTypeNum = DPI_NATIVE_TYPE_INT64;
+    var.buffer.data.asInt64 = ints;
+    if (dpiTest__verifyColumnValues(testCase, &var, DPI_TEST_COLUMN_ROWS) < 0)
+        return DPI_FAILURE;
+
+    // native doubles
+    var.type = dpiOracleType__getFromNum(DPI_ORACLE_TYPE_NATIVE_DOUBLE,
+            &error);
+    var.nativeTypeNum = DPI_NATIVE_TYPE_DOUBLE;
+    var.buffer.data.asDouble = doubles;
+    if (dpiTest__verifyColumnValues(testCase, &var, DPI_TEST_COLUMN_ROWS) < 0)
+        return DPI_FAILURE;
+
+    // numbers as integers and doubles
+    var.type = dpiOracleType__getFromNum(DPI_ORACLE_TYPE_NUMBER, &error);
+    var.nativeTypeNum = DPI_NATIVE_TYPE_INT64;
+    var.buffer.data.asNumber = numbers;
+    if (dpiTest__verifyColumnValues(testCase, &var, DPI_TEST_COLUMN_ROWS) < 0)
+        return DPI_FAILURE;
+    var.nativeTypeNum = DPI_NATIVE_TYPE_DOUBLE;
+    if (dpiTest__verifyColumnValues(testCase, &var, DPI_TEST_COLUMN_ROWS) < 0)
+        return DPI_FAILURE;
+
+    // dates as doubles
+    var.type = dpiOracleType__getFromNum(DPI_ORACLE_TYPE_DATE, &error);
+    var.buffer.data.asDate = dates;
+    if (dpiTest__verifyColumnValues(testCase, &var, DPI_TEST_COLUMN_ROWS) < 0)
+        return DPI_FAILURE;
+
+    // strings as bytes
+    for (i = 0; i < DPI_TEST_COLUMN_ROWS; i++)
+        externalData[i].value.asBytes.ptr = strings[i];
+    var.type = dpiOracleType__getFromNum(DPI_ORACLE_TYPE_VARCHAR, &error);
+    var.nativeTypeNum = DPI_NATIVE_TYPE_BYTES;
+    var.buffer.actualLength16 = actualLength16;
+    var.buffer.data.asRaw = strings;
+    if (dpiTest__verifyColumnValues(testCase, &var, DPI_TEST_COLUMN_ROWS) < 0)
+        return DPI_FAILURE;
+
+    // a column containing only null values
+    for (i = 0; i < DPI_TEST_COLUMN_ROWS; i++)
+        indicator[i] = DPI_OCI_IND_NULL;
+    return dpiTest__verifyColumnValues(testCase, &var, DPI_TEST_COLUMN_ROWS);
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3613_verifyColumnBuffers()
+//   Populate buffers for columns of various types containing null values and
+// verify that they are transferred to column buffers correctly, including
+// limiting the number of rows to those whose strings fit (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3613_verifyColumnBuffers(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    char strings[DPI_TEST_COLUMN_ROWS][16], bytes[100];
+    uint32_t offsets[DPI_TEST_COLUMN_ROWS + 1], numRows, i;
+    uint8_t nullBitmap[(DPI_TEST_COLUMN_ROWS + 7) / 8];
+    uint32_t actualLength32[DPI_TEST_COLUMN_ROWS];
+    int16_t indicator[DPI_TEST_COLUMN_ROWS];
+    int64_t ints[DPI_TEST_COLUMN_ROWS];
+    int64_t values[DPI_TEST_COLUMN_ROWS];
+    dpiErrorBuffer errorBuffer;
+    dpiColumnBuffer column;
+    dpiError error;
+    dpiVar var;
+
+    // populate buffers; every third row is null
+    error.buffer = &errorBuffer;
+    error.handle = NULL;
+    error.env = NULL;
+    memset(&var, 0, sizeof(var));
+    memset(&column, 0, sizeof(column));
+    for (i = 0; i < DPI_TEST_COLUMN_ROWS; i++) {
+        indicator[i] = (i % 3 == 0) ? DPI_OCI_IND_NULL : DPI_OCI_IND_NOTNULL;
+        ints[i] = (int64_t) i * i - 100;
+        snprintf(strings[i], sizeof(strings[i]), "Row %u", i);
+        actualLength32[i] = (uint32_t) strlen(strings[i]);
+    }
+    var.buffer.maxArraySize = DPI_TEST_COLUMN_ROWS;
+    var.buffer.indicator = indicator;
+
+    // native integers, starting part way through the buffer
+    var.type = dpiOracleType__getFromNum(DPI_ORACLE_TYPE_NATIVE_INT, &error);
+    var.nativeTypeNum = DPI_NATIVE_TYPE_INT64;
+    var.buffer.data.asInt64 = ints;
+    column.nativeTypeNum = DPI_NATIVE_TYPE_INT64;
+    column.nullBitmap = nullBitmap;
+    column.asInt64 = values;
+    numRows = DPI_TEST_COLUMN_ROWS - 5;
+    if (dpiVar__checkColumnBuffer(&var, &column, 5, &numRows, &error) < 0 ||
+            dpiVar__getColumnBuffer(&var, &column, 5, numRows, &error) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to get column.");
+    if (dpiTestCase_expectUintEqual(testCase, numRows,
+            DPI_TEST_COLUMN_ROWS - 5) < 0)
+        return DPI_FAILURE;
+    for (i = 0; i < numRows; i++) {
+        if (dpiTestCase_expectUintEqual(testCase,
+                (nullBitmap[i / 8] & (1 << (i % 8))) != 0,
+                (i + 5) % 3 == 0) < 0)
+            return DPI_FAILURE;
+        if (dpiTestCase_expectIntEqual(testCase, values[i], ints[i + 5]) < 0)
+            return DPI_FAILURE;
+    }
+
+    // a mismatched native type is rejected
+    column.nativeTypeNum = DPI_NATIVE_TYPE_DOUBLE;
+    if (dpiVar__checkColumnBuffer(&var, &column, 0, &numRows, &error) == 0)
+        return dpiTestCase_setFailed(testCase,
+                "Mismatched native type should have been rejected.");
+
+    // strings, limited to the rows that fit in the buffer
+    var.type = dpiOracleType__getFromNum(DPI_ORACLE_TYPE_VARCHAR, &error);
+    var.nativeTypeNum = DPI_NATIVE_TYPE_BYTES;
+    var.sizeInBytes = sizeof(strings[0]);
+    var.buffer.actualLength32 = actualLength32;
+    var.buffer.data.asRaw = strings;
+    column.nativeTypeNum = DPI_NATIVE_TYPE_BYTES;
+    column.offsets = offsets;
+    column.bytes = bytes;
+    column.bytesLength = sizeof(bytes);
+    numRows = DPI_TEST_COLUMN_ROWS;
+    if (dpiVar__checkColumnBuffer(&var, &column, 0, &numRows, &error) < 0 ||
+            dpiVar__getColumnBuffer(&var, &column, 0, numRows, &error) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to get column.");
+    if (dpiTestCase_expectUintEqual(testCase, numRows, 26) < 0)
+        return DPI_FAILURE;
+    for (i = 0; i < numRows; i++) {
+        if (i % 3 == 0) {
+            if (dpiTestCase_expectUintEqual(testCase, offsets[i + 1],
+                    offsets[i]) < 0)
+                return DPI_FAILURE;
+        } else if (dpiTestCase_expectStringEqual(testCase, bytes + offsets[i],
+                offsets[i + 1] - offsets[i], strings[i],
+                strlen(strings[i])) < 0)
+            return DPI_FAILURE;
+    }
+
+    // a buffer that cannot hold a single string is rejected
+    column.bytesLength = 3;
+    if (dpiVar__checkColumnBuffer(&var, &column, 1, &numRows, &error) == 0)
+        return dpiTestCase_setFailed(testCase,
+                "Buffer too small should have been rejected.");
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// main()
+//-----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    dpiTestSuite_initializeWithoutContext(3600);
+    dpiTestSuite_addCase(dpiTest_3600_decodeSignedIntegers,
+            "decode signed integers without OCI");
+    dpiTestSuite_addCase(dpiTest_3601_decodeUnsignedIntegers,
+            "decode unsigned integers without OCI");
+    dpiTestSuite_addCase(dpiTest_3602_verifyIntegersNotDecoded,
+            "verify out of range and fractional integers are not decoded");
+    dpiTestSuite_addCase(dpiTest_3603_decodeDoubles,
+            "decode doubles without OCI");
+    dpiTestSuite_addCase(dpiTest_3604_verifyDoublesNotDecoded,
+            "verify inexact doubles are not decoded");
+    dpiTestSuite_addCase(dpiTest_3605_verifySpecialValuesNotDecoded,
+            "verify special and corrupt values are not decoded");
+    dpiTestSuite_addCase(dpiTest_3606_roundTripRandomIntegers,
+            "round trip pseudo-random integers");
+    dpiTestSuite_addCase(dpiTest_3607_roundTripRandomDoubles,
+            "round trip pseudo-random doubles");
+    dpiTestSuite_addCase(dpiTest_3608_verifyDatesAsDoubles,
+            "convert dates to doubles without OCI");
+    dpiTestSuite_addCase(dpiTest_3609_verifyConsecutiveDays,
+            "convert every day from year 1 to 9999 to doubles");
+    dpiTestSuite_addCase(dpiTest_3610_verifyTimestampsAsDoubles,
+            "convert timestamps with fractional seconds and offsets");
+    dpiTestSuite_addCase(dpiTest_3611_verifyDatesBeforeYearOneNotCalculated,
+            "verify dates prior to year 1 are not calculated directly");
+    dpiTestSuite_addCase(dpiTest_3612_verifyColumnValues,
+            "verify column conversions match row conversions");
+    dpiTestSuite_addCase(dpiTest_3613_verifyColumnBuffers,
+            "verify values are transferred to column buffers");
+    return dpiTestSuite_run();
+}
@@ -1725,6 +1725,94 @@ int dpiTest_1208_verifyDatesCollection(dpiTestCase *testCase,
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiTest_1209_verifyDatesAsDoubles()
+//   Fetch dates and timestamps of each type covering the full range of years
+// as doubles and verify that each value matches the number of milliseconds
+// since January 1, 1970 calculated by the database (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_1209_verifyDatesAsDoubles(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    const char *sql =
+            "select d,"
+            "       cast(d as timestamp(9)) + numtodsinterval(fs, 'second'),"
+            "       from_tz(cast(d as timestamp(9)) + "
+            "           numtodsinterval(fs, 'second'), '+05:30'),"
+            "       cast(from_tz(cast(d as timestamp(9)) + "
+            "           numtodsinterval(fs, 'second'), 'UTC') as "
+            "           timestamp with local time zone),"
+            "       round((d - date '1970-01-01') * 86400) * 1000,"
+            "       trunc((round((d - date '1970-01-01') * 86400) + fs) * "
+            "           1000) "
+            "from ( select date '0001-01-01' + (level - 1) * 36 + "
+            "             mod(level * 7919, 86400) / 86400 d,"
+            "             mod(level * 104729, 1000000000) / 1000000000 fs "
+            "       from dual connect by level <= 100000 )";
+    dpiOracleTypeNum oracleTypeNums[4] = { DPI_ORACLE_TYPE_DATE,
+            DPI_ORACLE_TYPE_TIMESTAMP, DPI_ORACLE_TYPE_TIMESTAMP_TZ,
+            DPI_ORACLE_TYPE_TIMESTAMP_LTZ };
+    double expectedValues[4], offset = 330 * 60000;
+    dpiNativeTypeNum nativeTypeNum;
+    uint32_t bufferRowIndex, i;
+    dpiData *data;
+    dpiStmt *stmt;
+    dpiConn *conn;
+    int found;
+
+    // get connection
+    if (dpiTestCase_getConnection(testCase, &conn) < 0)
+        return DPI_FAILURE;
+    if (dpiTest__setTimeZone(testCase, conn) < 0)
+        return DPI_FAILURE;
+
+    // prepare and execute query, fetching all date columns as doubles
+    if (dpiConn_prepareStmt(conn, 0, sql, strlen(sql), NULL, 0, &stmt) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    if (dpiStmt_execute(stmt, 0, NULL) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    for (i = 0; i < 4; i++) {
+        if (dpiStmt_defineValue(stmt, i + 1, oracleTypeNums[i],
+                DPI_NATIVE_TYPE_DOUBLE, 0, 0, NULL) < 0)
+            return dpiTestCase_setFailedFromError(testCase);
+    }
+    for (i = 4; i < 6; i++) {
+        if (dpiStmt_defineValue(stmt, i + 1, DPI_ORACLE_TYPE_NUMBER,
+                DPI_NATIVE_TYPE_DOUBLE, 0, 0, NULL) < 0)
+            return dpiTestCase_setFailedFromError(testCase);
+    }
+
+    // verify each row
+    while (1) {
+        if (dpiStmt_fetch(stmt, &found, &bufferRowIndex) < 0)
+            return dpiTestCase_setFailedFromError(testCase);
+        if (!found)
+            break;
+        if (dpiStmt_getQueryValue(stmt, 5, &nativeTypeNum, &data) < 0)
+            return dpiTestCase_setFailedFromError(testCase);
+        expectedValues[0] = data->value.asDouble;
+        if (dpiStmt_getQueryValue(stmt, 6, &nativeTypeNum, &data) < 0)
+            return dpiTestCase_setFailedFromError(testCase);
+        expectedValues[1] = data->value.asDouble;
+        expectedValues[2] = expectedValues[1] - offset;
+        expectedValues[3] = expectedValues[1];
+        for (i = 0; i < 4; i++) {
+            if (dpiStmt_getQueryValue(stmt, i + 1, &nativeTypeNum,
+                    &data) < 0)
+                return dpiTestCase_setFailedFromError(testCase);
+            if (dpiTestCase_expectDoubleEqual(testCase, data->value.asDouble,
+                    expectedValues[i]) < 0)
+                return DPI_FAILURE;
+        }
+    }
+
+    if (dpiStmt_release(stmt) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // main()
 //-----------------------------------------------------------------------------
@@ -1749,5 +1837,7 @@ int main(int argc, char **argv)
             "test conversion of string to number for invalid values");
     dpiTestSuite_addCase(dpiTest_1208_verifyDatesCollection,
             "verify collection containing dates works as expected");
+    dpiTestSuite_addCase(dpiTest_1209_verifyDatesAsDoubles,
+            "verify dates and timestamps fetched as doubles");
     return dpiTestSuite_run();
 }
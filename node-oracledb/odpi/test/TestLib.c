@@ -835,6 +835,22 @@ void dpiTestSuite_initialize(uint32_t minTestCaseId)
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiTestSuite_initializeWithoutContext() [PUBLIC]
+//   Initializes the global test suite for test cases that exercise internal
+// routines directly. No context is created so neither the Oracle Client
+// libraries nor a database are required.
+//-----------------------------------------------------------------------------
+void dpiTestSuite_initializeWithoutContext(uint32_t minTestCaseId)
+{
+    gTestSuite.numTestCases = 0;
+    gTestSuite.allocatedTestCases = 0;
+    gTestSuite.testCases = NULL;
+    gTestSuite.logFile = stderr;
+    gTestSuite.minTestCaseId = minTestCaseId;
+}
+
+
 //-----------------------------------------------------------------------------
 // dpiTestSuite_run() [PUBLIC]
 //   Runs the test cases in the test suite and reports to stderr the success
@@ -864,7 +880,8 @@ int dpiTestSuite_run()
         }
         dpiTestCase__cleanUp(testCase);
     }
-    dpiContext_destroy(gContext);
+    if (gContext)
+        dpiContext_destroy(gContext);
     if (numSkipped > 0)
         fprintf(gTestSuite.logFile, "%d / %d tests passed (%d skipped)\n",
                 numPassed, gTestSuite.numTestCases - numSkipped, numSkipped);
@@ -186,5 +186,8 @@ void dpiTestSuite_getErrorInfo(dpiErrorInfo *errorInfo);
 // initialize test suite
 void dpiTestSuite_initialize(uint32_t minTestCaseId);
 
+// initialize test suite without creating a context (no database required)
+void dpiTestSuite_initializeWithoutContext(uint32_t minTestCaseId);
+
 // run test suite
 int dpiTestSuite_run();
@@ -607,6 +607,200 @@ int dpiTest_712_fetchDataToSmallLenStrVar(dpiTestCase *testCase,
 }
 
 
+//-----------------------------------------------------------------------------
+// dpiTest_713_fetchColumns()
+//   Prepare and execute a query returning integers, doubles, strings and null
+// values; call dpiStmt_fetchColumns() repeatedly and verify that the values
+// transferred to the column buffers are correct (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_713_fetchColumns(dpiTestCase *testCase, dpiTestParams *params)
+{
+    const char *sql = "select level, level / 4, 'String ' || level, "
+            "case when mod(level, 3) != 0 then level end "
+            "from dual connect by level <= 250";
+    uint32_t offsets[101], numRowsFetched, rowNum, i;
+    uint8_t nullBitmap1[13], nullBitmap4[13];
+    int64_t ints1[100], ints4[100];
+    dpiColumnBuffer columns[4];
+    char bytes[2000], str[20];
+    double doubles[100];
+    dpiConn *conn;
+    dpiStmt *stmt;
+    int moreRows;
+
+    // prepare and execute query
+    if (dpiTestCase_getConnection(testCase, &conn) < 0)
+        return DPI_FAILURE;
+    if (dpiConn_prepareStmt(conn, 0, sql, strlen(sql), NULL, 0, &stmt) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    if (dpiStmt_execute(stmt, 0, NULL) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    if (dpiStmt_defineValue(stmt, 1, DPI_ORACLE_TYPE_NUMBER,
+            DPI_NATIVE_TYPE_INT64, 0, 0, NULL) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    if (dpiStmt_defineValue(stmt, 2, DPI_ORACLE_TYPE_NUMBER,
+            DPI_NATIVE_TYPE_DOUBLE, 0, 0, NULL) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    if (dpiStmt_defineValue(stmt, 4, DPI_ORACLE_TYPE_NUMBER,
+            DPI_NATIVE_TYPE_INT64, 0, 0, NULL) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+
+    // populate column buffers
+    memset(columns, 0, sizeof(columns));
+    columns[0].nativeTypeNum = DPI_NATIVE_TYPE_INT64;
+    columns[0].nullBitmap = nullBitmap1;
+    columns[0].asInt64 = ints1;
+    columns[1].nativeTypeNum = DPI_NATIVE_TYPE_DOUBLE;
+    columns[1].asDouble = doubles;
+    columns[2].nativeTypeNum = DPI_NATIVE_TYPE_BYTES;
+    columns[2].offsets = offsets;
+    columns[2].bytes = bytes;
+    columns[2].bytesLength = sizeof(bytes);
+    columns[3].nativeTypeNum = DPI_NATIVE_TYPE_INT64;
+    columns[3].nullBitmap = nullBitmap4;
+    columns[3].asInt64 = ints4;
+
+    // fetch all rows and verify each one
+    rowNum = 0;
+    moreRows = 1;
+    while (moreRows) {
+        if (dpiStmt_fetchColumns(stmt, 100, 4, columns, &numRowsFetched,
+                &moreRows) < 0)
+            return dpiTestCase_setFailedFromError(testCase);
+        for (i = 0; i < numRowsFetched; i++) {
+            rowNum++;
+            if (dpiTestCase_expectUintEqual(testCase,
+                    nullBitmap1[i / 8] & (1 << (i % 8)), 0) < 0)
+                return DPI_FAILURE;
+            if (dpiTestCase_expectIntEqual(testCase, ints1[i], rowNum) < 0)
+                return DPI_FAILURE;
+            if (dpiTestCase_expectDoubleEqual(testCase, doubles[i],
+                    rowNum / 4.0) < 0)
+                return DPI_FAILURE;
+            snprintf(str, sizeof(str), "String %u", rowNum);
+            if (dpiTestCase_expectStringEqual(testCase, bytes + offsets[i],
+                    offsets[i + 1] - offsets[i], str, strlen(str)) < 0)
+                return DPI_FAILURE;
+            if (dpiTestCase_expectUintEqual(testCase,
+                    (nullBitmap4[i / 8] & (1 << (i % 8))) != 0,
+                    rowNum % 3 == 0) < 0)
+                return DPI_FAILURE;
+            if (rowNum % 3 != 0 && dpiTestCase_expectIntEqual(testCase,
+                    ints4[i], rowNum) < 0)
+                return DPI_FAILURE;
+        }
+    }
+    if (dpiTestCase_expectUintEqual(testCase, rowNum, 250) < 0)
+        return DPI_FAILURE;
+    if (dpiStmt_release(stmt) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+
+    return DPI_SUCCESS;
+}
+
+//-----------------------------------------------------------------------------
+// dpiTest_714_fetchColumnsNullBuffer()
+//   Prepare and execute a query returning integers; call
+// dpiStmt_fetchColumns() with a column buffer that has no array for the
+// values (error DPI-1046).
+//-----------------------------------------------------------------------------
+int dpiTest_714_fetchColumnsNullBuffer(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    const char *sql = "select level from dual connect by level <= 10";
+    uint32_t numRowsFetched;
+    dpiColumnBuffer column;
+    uint8_t nullBitmap[2];
+    dpiConn *conn;
+    dpiStmt *stmt;
+    int moreRows;
+
+    // prepare and execute query
+    if (dpiTestCase_getConnection(testCase, &conn) < 0)
+        return DPI_FAILURE;
+    if (dpiConn_prepareStmt(conn, 0, sql, strlen(sql), NULL, 0, &stmt) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    if (dpiStmt_execute(stmt, 0, NULL) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    if (dpiStmt_defineValue(stmt, 1, DPI_ORACLE_TYPE_NUMBER,
+            DPI_NATIVE_TYPE_INT64, 0, 0, NULL) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+
+    // attempt to fetch into a column buffer without an array for the values
+    memset(&column, 0, sizeof(column));
+    column.nativeTypeNum = DPI_NATIVE_TYPE_INT64;
+    column.nullBitmap = nullBitmap;
+    dpiStmt_fetchColumns(stmt, 10, 1, &column, &numRowsFetched, &moreRows);
+    if (dpiTestCase_expectError(testCase, "DPI-1046:") < 0)
+        return DPI_FAILURE;
+    if (dpiStmt_release(stmt) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_715_fetchColumnsWithTrailingLob()
+//   Prepare and execute a query returning integers and CLOBs; call
+// dpiStmt_fetchColumns() repeatedly for the integer column only, with an
+// array size that requires several fetches, and verify that the values
+// transferred are correct (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_715_fetchColumnsWithTrailingLob(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    const char *sql = "select level, to_clob('Clob ' || level) "
+            "from dual connect by level <= 35";
+    uint32_t numRowsFetched, rowNum, i;
+    dpiColumnBuffer column;
+    uint8_t nullBitmap[2];
+    int64_t ints[10];
+    dpiConn *conn;
+    dpiStmt *stmt;
+    int moreRows;
+
+    // prepare and execute query
+    if (dpiTestCase_getConnection(testCase, &conn) < 0)
+        return DPI_FAILURE;
+    if (dpiConn_prepareStmt(conn, 0, sql, strlen(sql), NULL, 0, &stmt) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    if (dpiStmt_setFetchArraySize(stmt, 10) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    if (dpiStmt_execute(stmt, 0, NULL) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+    if (dpiStmt_defineValue(stmt, 1, DPI_ORACLE_TYPE_NUMBER,
+            DPI_NATIVE_TYPE_INT64, 0, 0, NULL) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+
+    // populate column buffer
+    memset(&column, 0, sizeof(column));
+    column.nativeTypeNum = DPI_NATIVE_TYPE_INT64;
+    column.nullBitmap = nullBitmap;
+    column.asInt64 = ints;
+
+    // fetch all rows and verify each one
+    rowNum = 0;
+    moreRows = 1;
+    while (moreRows) {
+        if (dpiStmt_fetchColumns(stmt, 10, 1, &column, &numRowsFetched,
+                &moreRows) < 0)
+            return dpiTestCase_setFailedFromError(testCase);
+        for (i = 0; i < numRowsFetched; i++) {
+            rowNum++;
+            if (dpiTestCase_expectIntEqual(testCase, ints[i], rowNum) < 0)
+                return DPI_FAILURE;
+        }
+    }
+    if (dpiTestCase_expectUintEqual(testCase, rowNum, 35) < 0)
+        return DPI_FAILURE;
+    if (dpiStmt_release(stmt) < 0)
+        return dpiTestCase_setFailedFromError(testCase);
+
+    return DPI_SUCCESS;
+}
+
+
 //-----------------------------------------------------------------------------
 // main()
 //-----------------------------------------------------------------------------
@@ -639,5 +833,11 @@ int main(int argc, char **argv)
             "dpiStmt_fetchRows() increments rowcount");
     dpiTestSuite_addCase(dpiTest_712_fetchDataToSmallLenStrVar,
             "fetch data to a string variable which is smaller and verify");
+    dpiTestSuite_addCase(dpiTest_713_fetchColumns,
+            "dpiStmt_fetchColumns() transfers values to column buffers");
+    dpiTestSuite_addCase(dpiTest_714_fetchColumnsNullBuffer,
+            "dpiStmt_fetchColumns() with column buffer missing array");
+    dpiTestSuite_addCase(dpiTest_715_fetchColumnsWithTrailingLob,
+            "dpiStmt_fetchColumns() with LOB column not transferred");
     return dpiTestSuite_run();
 }
@@ -0,0 +1,777 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+// This program is free software: you can modify it and/or redistribute it
+// under the terms of:
+//
+// (i)  the Universal Permissive License v 1.0 or at your option, any
+//      later version (http://oss.oracle.com/licenses/upl); and/or
+//
+// (ii) the Apache License v 2.0. (http://www.apache.org/licenses/LICENSE-2.0)
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// TestThreading.c
+//   Test suite for testing internal routines which are called concurrently
+// from multiple threads. The ODPI-C source is embedded so that internal
+// functions can be called; neither the Oracle Client libraries nor a database
+// are required.
+//-----------------------------------------------------------------------------
+
+#include "../embed/dpi.c"
+#include "TestLib.h"
+
+// number of threads and iterations used when testing concurrent access
+#define DPI_TEST_NUM_THREADS            32
+#define DPI_TEST_NUM_ITERS              20000
+
+// number of fake handles which may be created by threads using a pool
+#define DPI_TEST_MAX_HANDLES            (DPI_TEST_NUM_THREADS * 16)
+
+// number of handles added to a handle list by each thread
+#define DPI_TEST_NUM_LIST_HANDLES       1000
+
+// number of calls traced by each thread
+#define DPI_TEST_NUM_TRACED_CALLS       1000
+
+// thread creation and joining
+#ifdef _WIN32
+typedef HANDLE dpiTestThread;
+#define dpiTestThread_create(thread, fn, arg) \
+    ((*(thread) = CreateThread(NULL, 0, \
+            (LPTHREAD_START_ROUTINE) (fn), (arg), 0, NULL)) ? 0 : -1)
+#define dpiTestThread_join(thread) \
+    (WaitForSingleObject((thread), INFINITE), CloseHandle(thread))
+#else
+typedef pthread_t dpiTestThread;
+#define dpiTestThread_create(thread, fn, arg) \
+    pthread_create((thread), NULL, (void *(*)(void*)) (fn), (arg))
+#define dpiTestThread_join(thread)      pthread_join((thread), NULL)
+#endif
+
+// a fake handle which records whether it is currently acquired by a thread
+typedef struct {
+    dpiAtomicPtr inUse;
+} dpiTestHandle;
+
+// state shared by the threads acquiring and releasing handles from a pool
+typedef struct {
+    dpiHandlePool *pool;
+    dpiTestHandle handles[DPI_TEST_MAX_HANDLES];
+    uint32_t numHandles;
+    dpiMutexType mutex;
+    int failed;
+} dpiTestPoolState;
+
+// state shared by the threads adding and removing handles from a list
+typedef struct {
+    dpiHandleList *list;
+    int failed;
+} dpiTestListState;
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__countPoolHandles() [INTERNAL]
+//   Return the number of handles held by the pool in all of its slots and in
+// its overflow stack. This is only valid when no threads are using the pool.
+//-----------------------------------------------------------------------------
+static uint32_t dpiTest__countPoolHandles(dpiHandlePool *pool)
+{
+    dpiHandlePoolNode *node;
+    uint32_t i, count = 0;
+
+    for (i = 0; i < DPI_HANDLE_POOL_NUM_SLOTS; i++) {
+        if (pool->slots[i].handle)
+            count++;
+    }
+    for (node = pool->overflow; node; node = node->next)
+        count++;
+    return count;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__hammerRefCount() [INTERNAL]
+//   Repeatedly add and release references to the handle, alternating between
+// the two ways of adding a reference.
+//-----------------------------------------------------------------------------
+static void *dpiTest__hammerRefCount(dpiRowid *rowid)
+{
+    dpiError error;
+    uint32_t i;
+
+    for (i = 0; i < DPI_TEST_NUM_ITERS; i++) {
+        if (i % 2 == 0)
+            dpiGen__setRefCount(rowid, &error, 1);
+        else if (dpiGen__addRefIfValid(rowid, DPI_HTYPE_ROWID) < 0)
+            return rowid;
+        dpiGen__setRefCount(rowid, &error, -1);
+    }
+    return NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__findTraceStats() [INTERNAL]
+//   Return the aggregated trace statistics for the given function or NULL if
+// no calls to it have been traced.
+//-----------------------------------------------------------------------------
+static dpiTraceStats *dpiTest__findTraceStats(const char *fnName,
+        dpiTraceStats *stats, uint32_t numStats)
+{
+    uint32_t i;
+
+    for (i = 0; i < numStats; i++) {
+        if (stats[i].fnName == fnName)
+            return &stats[i];
+    }
+    return NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__traceCalls() [INTERNAL]
+//   Trace calls to a function from a thread, as is done by every public
+// function when DPI_DEBUG_LEVEL_TRACE is enabled, using an error buffer local
+// to the thread. Every tenth call fails. The trace buffer is released when
+// done, as happens when the thread exits.
+//-----------------------------------------------------------------------------
+static void *dpiTest__traceCalls(const char *fnName)
+{
+    dpiErrorBuffer buffer;
+    uint32_t i;
+
+    memset(&buffer, 0, sizeof(buffer));
+    for (i = 0; i < DPI_TEST_NUM_TRACED_CALLS; i++) {
+        dpiTrace__start(&buffer, fnName, &buffer);
+        dpiTrace__end(&buffer, &buffer,
+                (i % 10 == 0) ? DPI_FAILURE : DPI_SUCCESS);
+    }
+    if (buffer.traceBuffer)
+        dpiTrace__releaseBuffer(buffer.traceBuffer);
+    return NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__useList() [INTERNAL]
+//   Add handles to the list, remove every other one and add them again,
+// verifying that each handle is still found in the slot it was given.
+//-----------------------------------------------------------------------------
+static void *dpiTest__useList(dpiTestListState *state)
+{
+    uint32_t slotNums[DPI_TEST_NUM_LIST_HANDLES], i;
+    char handles[DPI_TEST_NUM_LIST_HANDLES];
+    dpiHandleList *list = state->list;
+
+    for (i = 0; i < DPI_TEST_NUM_LIST_HANDLES; i++) {
+        if (dpiHandleList__addHandle(list, &handles[i], &slotNums[i],
+                NULL) < 0)
+            break;
+    }
+    for (i = 0; i < DPI_TEST_NUM_LIST_HANDLES; i += 2)
+        dpiHandleList__removeHandle(list, slotNums[i]);
+    for (i = 0; i < DPI_TEST_NUM_LIST_HANDLES; i += 2) {
+        if (dpiHandleList__addHandle(list, &handles[i], &slotNums[i],
+                NULL) < 0)
+            break;
+    }
+    dpiMutex__acquire(list->mutex);
+    for (i = 0; i < DPI_TEST_NUM_LIST_HANDLES; i++) {
+        if (list->handles[slotNums[i]] != &handles[i])
+            state->failed = 1;
+    }
+    dpiMutex__release(list->mutex);
+    for (i = 0; i < DPI_TEST_NUM_LIST_HANDLES; i++)
+        dpiHandleList__removeHandle(list, slotNums[i]);
+    return NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest__usePool() [INTERNAL]
+//   Repeatedly acquire a handle from the pool (creating a new one if the pool
+// is empty) and release it back to the pool, occasionally holding two handles
+// at the same time. Each handle is marked as in use while it is acquired so
+// that a handle given to two threads at the same time is detected.
+//-----------------------------------------------------------------------------
+static void *dpiTest__usePool(dpiTestPoolState *state)
+{
+    dpiTestHandle *handles[2];
+    uint32_t i, j, numHeld;
+
+    for (i = 0; i < DPI_TEST_NUM_ITERS && !state->failed; i++) {
+        numHeld = (i % 7 == 0) ? 2 : 1;
+        for (j = 0; j < numHeld; j++) {
+            dpiHandlePool__acquire(state->pool, (void**) &handles[j]);
+            if (!handles[j]) {
+                dpiMutex__acquire(state->mutex);
+                if (state->numHandles < DPI_TEST_MAX_HANDLES)
+                    handles[j] = &state->handles[state->numHandles++];
+                dpiMutex__release(state->mutex);
+                if (!handles[j]) {
+                    state->failed = 1;
+                    return NULL;
+                }
+            }
+            if (dpiAtomic__exchangePtr(&handles[j]->inUse, state)) {
+                state->failed = 1;
+                return NULL;
+            }
+        }
+        for (j = numHeld; j > 0; j--) {
+            (void) dpiAtomic__exchangePtr(&handles[j - 1]->inUse, NULL);
+            dpiHandlePool__release(state->pool, (void**) &handles[j - 1]);
+        }
+    }
+    return NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3700_verifyHandlePoolSingleThread()
+//   Verify that an empty pool returns no handle, that a released handle is
+// acquired again by the same thread and that handles which do not fit in the
+// slot for the thread are kept in the overflow stack (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3700_verifyHandlePoolSingleThread(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    dpiTestHandle handles[10];
+    int found[10], numFound;
+    dpiHandlePool *pool;
+    void *handle;
+    uint32_t i;
+
+    if (dpiHandlePool__create(&pool, NULL) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to create pool.");
+
+    // empty pool returns no handle
+    dpiHandlePool__acquire(pool, &handle);
+    if (handle)
+        return dpiTestCase_setFailed(testCase, "Empty pool returned handle.");
+
+    // released handle is acquired again
+    handle = &handles[0];
+    dpiHandlePool__release(pool, &handle);
+    if (handle)
+        return dpiTestCase_setFailed(testCase, "Handle not cleared.");
+    dpiHandlePool__acquire(pool, &handle);
+    if (handle != &handles[0])
+        return dpiTestCase_setFailed(testCase, "Released handle not reused.");
+
+    // all released handles are acquired again, exactly once each
+    for (i = 0; i < 10; i++) {
+        handle = &handles[i];
+        dpiHandlePool__release(pool, &handle);
+    }
+    if (dpiTestCase_expectUintEqual(testCase,
+            dpiTest__countPoolHandles(pool), 10) < 0)
+        return DPI_FAILURE;
+    memset(found, 0, sizeof(found));
+    for (numFound = 0; ; numFound++) {
+        dpiHandlePool__acquire(pool, &handle);
+        if (!handle)
+            break;
+        i = (uint32_t) ((dpiTestHandle*) handle - handles);
+        if (i >= 10 || found[i])
+            return dpiTestCase_setFailed(testCase, "Unexpected handle.");
+        found[i] = 1;
+    }
+    if (dpiTestCase_expectUintEqual(testCase, numFound, 10) < 0)
+        return DPI_FAILURE;
+
+    dpiHandlePool__free(pool);
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3701_verifyHandlePoolConcurrency()
+//   Acquire and release handles concurrently from many threads and verify
+// that no handle is ever held by two threads at the same time and that every
+// handle created is returned to the pool (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3701_verifyHandlePoolConcurrency(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    dpiTestThread threads[DPI_TEST_NUM_THREADS];
+    dpiTestPoolState state;
+    uint32_t i;
+
+    memset(&state, 0, sizeof(state));
+    dpiMutex__initialize(state.mutex);
+    if (dpiHandlePool__create(&state.pool, NULL) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to create pool.");
+    for (i = 0; i < DPI_TEST_NUM_THREADS; i++) {
+        if (dpiTestThread_create(&threads[i], dpiTest__usePool, &state) != 0)
+            return dpiTestCase_setFailed(testCase, "Unable to create thread.");
+    }
+    for (i = 0; i < DPI_TEST_NUM_THREADS; i++)
+        dpiTestThread_join(threads[i]);
+    if (state.failed)
+        return dpiTestCase_setFailed(testCase,
+                "Handle shared between threads or too many handles created.");
+    if (dpiTestCase_expectUintEqual(testCase,
+            dpiTest__countPoolHandles(state.pool), state.numHandles) < 0)
+        return DPI_FAILURE;
+    dpiHandlePool__free(state.pool);
+    dpiMutex__destroy(state.mutex);
+    return DPI_SUCCESS;
+}
+
+
+#ifdef DPI_THREAD_LOCAL
+//-----------------------------------------------------------------------------
+// dpiTest__getThreadErrorBuffer() [INTERNAL]
+//   Store the error buffer cached for the calling thread in the location
+// provided.
+//-----------------------------------------------------------------------------
+static void *dpiTest__getThreadErrorBuffer(dpiErrorBuffer **errorBuffer)
+{
+    *errorBuffer = dpiGlobalThreadErrorBuffer;
+    return NULL;
+}
+#endif
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3702_verifyThreadLocalErrorBuffer()
+//   Verify that the error buffer cached for a thread is used without
+// consulting the OCI thread key, that it is not visible to other threads and
+// that error information is cleared at the start of the next function only
+// after it has been populated (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3702_verifyThreadLocalErrorBuffer(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+#ifdef DPI_THREAD_LOCAL
+    dpiErrorBuffer errorBuffer, *otherErrorBuffer = &errorBuffer;
+    dpiTestThread thread;
+    dpiError error;
+    int status;
+
+    // the OCI thread key is never used (the global environment is not created)
+    memset(&errorBuffer, 0, sizeof(errorBuffer));
+    strcpy(errorBuffer.encoding, DPI_CHARSET_NAME_UTF8);
+    dpiGlobalThreadErrorBuffer = &errorBuffer;
+    dpiGlobalInitialized = 1;
+    status = dpiGlobal__initError("fn1", &error);
+    if (status == DPI_SUCCESS)
+        status = dpiError__set(&error, "test", DPI_ERR_NOT_SUPPORTED);
+    dpiGlobalInitialized = 0;
+    dpiGlobalThreadErrorBuffer = NULL;
+    if (error.buffer != &errorBuffer)
+        return dpiTestCase_setFailed(testCase, "Cached buffer not used.");
+    if (dpiTestCase_expectIntEqual(testCase, status, DPI_FAILURE) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectUintEqual(testCase, errorBuffer.errorNum,
+            DPI_ERR_NOT_SUPPORTED) < 0)
+        return DPI_FAILURE;
+
+    // error information is retained when no function name is specified
+    dpiGlobalThreadErrorBuffer = &errorBuffer;
+    dpiGlobalInitialized = 1;
+    dpiGlobal__initError(NULL, &error);
+    if (dpiTestCase_expectUintEqual(testCase, errorBuffer.errorNum,
+            DPI_ERR_NOT_SUPPORTED) < 0)
+        return DPI_FAILURE;
+
+    // error information is cleared at the start of the next function
+    dpiGlobal__initError("fn2", &error);
+    dpiGlobalInitialized = 0;
+    dpiGlobalThreadErrorBuffer = NULL;
+    if (dpiTestCase_expectUintEqual(testCase, errorBuffer.errorNum, 0) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectUintEqual(testCase, errorBuffer.messageLength,
+            0) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectUintEqual(testCase, errorBuffer.hasInfo, 0) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectStringEqual(testCase, errorBuffer.fnName,
+            strlen(errorBuffer.fnName), "fn2", 3) < 0)
+        return DPI_FAILURE;
+
+    // the cached buffer is not visible to other threads
+    dpiGlobalThreadErrorBuffer = &errorBuffer;
+    if (dpiTestThread_create(&thread, dpiTest__getThreadErrorBuffer,
+            &otherErrorBuffer) != 0)
+        return dpiTestCase_setFailed(testCase, "Unable to create thread.");
+    dpiTestThread_join(thread);
+    dpiGlobalThreadErrorBuffer = NULL;
+    if (otherErrorBuffer)
+        return dpiTestCase_setFailed(testCase, "Buffer visible to thread.");
+    return DPI_SUCCESS;
+#else
+    return dpiTestCase_setSkipped(testCase,
+            "thread-local variables not supported");
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3703_verifyRefCountConcurrency()
+//   Add and release references to a handle concurrently from many threads and
+// verify that the reference count is consistent afterwards and that a handle
+// whose reference count has reached zero cannot have a reference added to it
+// (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3703_verifyRefCountConcurrency(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    dpiTestThread threads[DPI_TEST_NUM_THREADS];
+    dpiErrorBuffer errorBuffer;
+    dpiRowid *rowid;
+    dpiError error;
+    uint32_t i;
+    dpiEnv env;
+
+    memset(&env, 0, sizeof(env));
+    env.threaded = 1;
+    error.buffer = &errorBuffer;
+    error.handle = NULL;
+    error.env = &env;
+    if (dpiGen__allocate(DPI_HTYPE_ROWID, &env, (void**) &rowid, &error) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to allocate handle.");
+    for (i = 0; i < DPI_TEST_NUM_THREADS; i++) {
+        if (dpiTestThread_create(&threads[i], dpiTest__hammerRefCount,
+                rowid) != 0)
+            return dpiTestCase_setFailed(testCase, "Unable to create thread.");
+    }
+    for (i = 0; i < DPI_TEST_NUM_THREADS; i++)
+        dpiTestThread_join(threads[i]);
+    if (dpiTestCase_expectIntEqual(testCase, rowid->refCount, 1) < 0)
+        return DPI_FAILURE;
+
+    // a handle with no references is not revived
+    rowid->refCount = 0;
+    if (dpiGen__addRefIfValid(rowid, DPI_HTYPE_ROWID) == DPI_SUCCESS)
+        return dpiTestCase_setFailed(testCase, "Reference added to handle.");
+    rowid->refCount = 1;
+    dpiGen__setRefCount(rowid, &error, -1);
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3704_verifyHandleListSlots()
+//   Verify that slots in a handle list are allocated lowest numbered first,
+// that the most recently emptied slot is reused and that the list grows when
+// all slots are in use (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3704_verifyHandleListSlots(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    uint32_t slotNums[20], slotNum, i;
+    dpiHandleList *list;
+    char handles[20];
+
+    if (dpiHandleList__create(&list, NULL) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to create list.");
+    for (i = 0; i < 20; i++) {
+        if (dpiHandleList__addHandle(list, &handles[i], &slotNums[i],
+                NULL) < 0)
+            return dpiTestCase_setFailed(testCase, "Unable to add handle.");
+        if (dpiTestCase_expectUintEqual(testCase, slotNums[i], i) < 0)
+            return DPI_FAILURE;
+    }
+    if (dpiTestCase_expectUintEqual(testCase, list->numSlots, 32) < 0)
+        return DPI_FAILURE;
+    dpiHandleList__removeHandle(list, 5);
+    dpiHandleList__removeHandle(list, 11);
+    if (list->handles[5] || list->handles[11])
+        return dpiTestCase_setFailed(testCase, "Slot not emptied.");
+    if (dpiHandleList__addHandle(list, &handles[11], &slotNum, NULL) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to add handle.");
+    if (dpiTestCase_expectUintEqual(testCase, slotNum, 11) < 0)
+        return DPI_FAILURE;
+    if (dpiHandleList__addHandle(list, &handles[5], &slotNum, NULL) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to add handle.");
+    if (dpiTestCase_expectUintEqual(testCase, slotNum, 5) < 0)
+        return DPI_FAILURE;
+    if (dpiHandleList__addHandle(list, &handles[0], &slotNum, NULL) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to add handle.");
+    if (dpiTestCase_expectUintEqual(testCase, slotNum, 20) < 0)
+        return DPI_FAILURE;
+    for (i = 0; i < 20; i++) {
+        if (list->handles[i] != &handles[i])
+            return dpiTestCase_setFailed(testCase, "Handle in wrong slot.");
+    }
+    dpiHandleList__free(list);
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3705_verifyHandleListConcurrency()
+//   Add and remove handles from a handle list concurrently from many threads
+// and verify that no slot is given out twice and that all slots are free
+// afterwards (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3705_verifyHandleListConcurrency(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    dpiTestThread threads[DPI_TEST_NUM_THREADS];
+    dpiTestListState state;
+    dpiHandleList *list;
+    uint32_t i;
+
+    if (dpiHandleList__create(&list, NULL) < 0)
+        return dpiTestCase_setFailed(testCase, "Unable to create list.");
+    state.list = list;
+    state.failed = 0;
+    for (i = 0; i < DPI_TEST_NUM_THREADS; i++) {
+        if (dpiTestThread_create(&threads[i], dpiTest__useList, &state) != 0)
+            return dpiTestCase_setFailed(testCase, "Unable to create thread.");
+    }
+    for (i = 0; i < DPI_TEST_NUM_THREADS; i++)
+        dpiTestThread_join(threads[i]);
+    if (state.failed)
+        return dpiTestCase_setFailed(testCase, "Handle in wrong slot.");
+    if (dpiTestCase_expectUintEqual(testCase, list->numFreeSlots,
+            list->numSlots) < 0)
+        return DPI_FAILURE;
+    for (i = 0; i < list->numSlots; i++) {
+        if (list->handles[i])
+            return dpiTestCase_setFailed(testCase, "Slot not emptied.");
+    }
+    dpiHandleList__free(list);
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3706_verifyTraceRecords()
+//   Trace nested calls in a single thread and verify the records written to
+// the ring buffer and the statistics accumulated for each function (no
+// error).
+//-----------------------------------------------------------------------------
+int dpiTest_3706_verifyTraceRecords(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    static const char outerFnName[] = "dpiTest_outer";
+    static const char innerFnName[] = "dpiTest_inner";
+    dpiTraceStats stats[DPI_TRACE_MAX_FNS], *outerStats, *innerStats;
+    dpiTraceBuffer *traceBuffer;
+    dpiTraceRecord *record;
+    dpiErrorBuffer buffer;
+    uint64_t numBucketCalls;
+    uint32_t numStats, i;
+
+    memset(&buffer, 0, sizeof(buffer));
+    dpiTrace__start(&buffer, outerFnName, &buffer);
+    traceBuffer = buffer.traceBuffer;
+    if (!traceBuffer)
+        return dpiTestCase_setFailed(testCase, "Trace buffer not acquired.");
+    dpiTrace__start(&buffer, innerFnName, NULL);
+    dpiTrace__end(&buffer, NULL, DPI_FAILURE);
+    dpiTrace__end(&buffer, &buffer, DPI_SUCCESS);
+    dpiTrace__end(&buffer, &buffer, DPI_SUCCESS);
+
+    // verify records (the unmatched end is ignored)
+    if (dpiTestCase_expectUintEqual(testCase, traceBuffer->numRecords, 4) < 0)
+        return DPI_FAILURE;
+    record = traceBuffer->records;
+    if (record[0].recordType != DPI_TRACE_RECORD_START ||
+            record[0].depth != 0 ||
+            record[0].handle != (uint64_t) (uintptr_t) &buffer ||
+            record[1].recordType != DPI_TRACE_RECORD_START ||
+            record[1].depth != 1 || record[1].fnId == record[0].fnId ||
+            record[2].recordType != DPI_TRACE_RECORD_END ||
+            record[2].depth != 1 || record[2].fnId != record[1].fnId ||
+            record[2].status != DPI_FAILURE ||
+            record[3].recordType != DPI_TRACE_RECORD_END ||
+            record[3].depth != 0 || record[3].fnId != record[0].fnId ||
+            record[3].status != DPI_SUCCESS)
+        return dpiTestCase_setFailed(testCase, "Unexpected trace record.");
+    for (i = 1; i < 4; i++) {
+        if (record[i].timestamp < record[i - 1].timestamp ||
+                record[i].threadId != traceBuffer->threadId)
+            return dpiTestCase_setFailed(testCase, "Unexpected trace record.");
+    }
+
+    // verify statistics
+    numStats = DPI_TRACE_MAX_FNS;
+    dpiTrace__getStats(&numStats, stats);
+    outerStats = dpiTest__findTraceStats(outerFnName, stats, numStats);
+    innerStats = dpiTest__findTraceStats(innerFnName, stats, numStats);
+    if (!outerStats || !innerStats)
+        return dpiTestCase_setFailed(testCase, "Statistics not found.");
+    if (dpiTestCase_expectUintEqual(testCase, outerStats->numCalls, 1) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectUintEqual(testCase, outerStats->numFailures, 0) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectUintEqual(testCase, innerStats->numFailures, 1) < 0)
+        return DPI_FAILURE;
+    if (outerStats->totalNanoseconds < innerStats->totalNanoseconds ||
+            outerStats->maxNanoseconds != outerStats->totalNanoseconds)
+        return dpiTestCase_setFailed(testCase, "Unexpected elapsed time.");
+    numBucketCalls = 0;
+    for (i = 0; i < DPI_TRACE_NUM_BUCKETS; i++)
+        numBucketCalls += outerStats->latencyBuckets[i];
+    if (dpiTestCase_expectUintEqual(testCase, numBucketCalls, 1) < 0)
+        return DPI_FAILURE;
+
+    // verify that only the number of statistics is returned when requested
+    numStats = 0;
+    dpiTrace__getStats(&numStats, NULL);
+    if (numStats < 2)
+        return dpiTestCase_setFailed(testCase, "Statistics not counted.");
+
+    dpiTrace__releaseBuffer(traceBuffer);
+    return DPI_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3707_verifyTraceConcurrency()
+//   Trace calls from many threads and verify that the statistics aggregated
+// across all trace buffers account for every call and that released trace
+// buffers are reused (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3707_verifyTraceConcurrency(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    static const char fnName[] = "dpiTest_concurrent";
+    dpiTestThread threads[DPI_TEST_NUM_THREADS];
+    dpiTraceStats stats[DPI_TRACE_MAX_FNS], *fnStats;
+    uint32_t numStats, numBuffers, i;
+    dpiTraceBuffer *traceBuffer;
+
+    for (i = 0; i < DPI_TEST_NUM_THREADS; i++) {
+        if (dpiTestThread_create(&threads[i], dpiTest__traceCalls,
+                (void*) fnName) != 0)
+            return dpiTestCase_setFailed(testCase, "Unable to create thread.");
+    }
+    for (i = 0; i < DPI_TEST_NUM_THREADS; i++)
+        dpiTestThread_join(threads[i]);
+    numStats = DPI_TRACE_MAX_FNS;
+    dpiTrace__getStats(&numStats, stats);
+    fnStats = dpiTest__findTraceStats(fnName, stats, numStats);
+    if (!fnStats)
+        return dpiTestCase_setFailed(testCase, "Statistics not found.");
+    if (dpiTestCase_expectUintEqual(testCase, fnStats->numCalls,
+            DPI_TEST_NUM_THREADS * DPI_TEST_NUM_TRACED_CALLS) < 0)
+        return DPI_FAILURE;
+    if (dpiTestCase_expectUintEqual(testCase, fnStats->numFailures,
+            DPI_TEST_NUM_THREADS * DPI_TEST_NUM_TRACED_CALLS / 10) < 0)
+        return DPI_FAILURE;
+
+    // all buffers have been released, so tracing from another thread must not
+    // allocate a new one
+    numBuffers = 0;
+    for (traceBuffer = dpiTraceBuffers; traceBuffer;
+            traceBuffer = traceBuffer->next)
+        numBuffers++;
+    dpiTest__traceCalls(fnName);
+    for (traceBuffer = dpiTraceBuffers; traceBuffer;
+            traceBuffer = traceBuffer->next)
+        numBuffers--;
+    return dpiTestCase_expectUintEqual(testCase, numBuffers, 0);
+}
+
+
+//-----------------------------------------------------------------------------
+// dpiTest_3708_verifyTraceFile()
+//   Write the trace buffers to a file and verify the header, the table of
+// traced functions and the number of records written (no error).
+//-----------------------------------------------------------------------------
+int dpiTest_3708_verifyTraceFile(dpiTestCase *testCase,
+        dpiTestParams *params)
+{
+    static const char fnName[] = "dpiTest_written";
+    uint32_t header[4], numItems, numRecords, i;
+    uint64_t numExpected, numFound;
+    dpiTraceBuffer *traceBuffer;
+    uint16_t fnId, nameLength;
+    const char *fileName;
+    dpiTraceRecord record;
+    char name[256];
+    dpiErrorBuffer buffer;
+    dpiError error;
+    int foundName;
+    FILE *fp;
+
+    // write the file
+    dpiTest__traceCalls(fnName);
+    fileName = "build/TestThreading.trc";
+    memset(&buffer, 0, sizeof(buffer));
+    error.buffer = &buffer;
+    if (dpiTrace__write(fileName, &error) < 0)
+        return dpiTestCase_setFailed(testCase, buffer.message);
+    numExpected = 0;
+    for (traceBuffer = dpiTraceBuffers; traceBuffer;
+            traceBuffer = traceBuffer->next)
+        numExpected += (traceBuffer->numRecords > DPI_TRACE_NUM_RECORDS) ?
+                DPI_TRACE_NUM_RECORDS : traceBuffer->numRecords;
+
+    // read and verify the header and table of functions
+    fp = fopen(fileName, "rb");
+    if (!fp)
+        return dpiTestCase_setFailed(testCase, "Unable to open trace file.");
+    if (fread(name, 8, 1, fp) != 1 || memcmp(name, "DPITRACE", 8) != 0 ||
+            fread(header, sizeof(uint32_t), 4, fp) != 4 || header[0] != 1 ||
+            header[1] != 0x01020304 || header[2] != sizeof(dpiTraceRecord)) {
+        fclose(fp);
+        return dpiTestCase_setFailed(testCase, "Invalid trace file header.");
+    }
+    foundName = 0;
+    for (i = 0; i < header[3]; i++) {
+        if (fread(&fnId, sizeof(fnId), 1, fp) != 1 ||
+                fread(&nameLength, sizeof(nameLength), 1, fp) != 1 ||
+                nameLength >= sizeof(name) ||
+                fread(name, nameLength, 1, fp) != 1) {
+            fclose(fp);
+            return dpiTestCase_setFailed(testCase, "Invalid function table.");
+        }
+        name[nameLength] = '\0';
+        if (strcmp(name, fnName) == 0)
+            foundName = 1;
+    }
+
+    // read the records of each buffer
+    numFound = 0;
+    if (fread(&numItems, sizeof(numItems), 1, fp) != 1)
+        numItems = 0;
+    for (i = 0; i < numItems; i++) {
+        if (fread(&numRecords, sizeof(numRecords), 1, fp) != 1)
+            break;
+        for (; numRecords > 0; numRecords--) {
+            if (fread(&record, sizeof(record), 1, fp) != 1)
+                break;
+            numFound++;
+        }
+    }
+    fclose(fp);
+    remove(fileName);
+    if (!foundName)
+        return dpiTestCase_setFailed(testCase, "Function name not written.");
+    return dpiTestCase_expectUintEqual(testCase, numFound, numExpected);
+}
+
+
+//-----------------------------------------------------------------------------
+// main()
+//-----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    dpiTestSuite_initializeWithoutContext(3700);
+    dpiTestSuite_addCase(dpiTest_3700_verifyHandlePoolSingleThread,
+            "verify handle pool acquire and release in a single thread");
+    dpiTestSuite_addCase(dpiTest_3701_verifyHandlePoolConcurrency,
+            "verify handle pool acquire and release from many threads");
+    dpiTestSuite_addCase(dpiTest_3702_verifyThreadLocalErrorBuffer,
+            "verify thread-local error buffer is used and cleared lazily");
+    dpiTestSuite_addCase(dpiTest_3703_verifyRefCountConcurrency,
+            "verify reference counting from many threads");
+    dpiTestSuite_addCase(dpiTest_3704_verifyHandleListSlots,
+            "verify handle list slot allocation");
+    dpiTestSuite_addCase(dpiTest_3705_verifyHandleListConcurrency,
+            "verify handle list add and remove from many threads");
+    dpiTestSuite_addCase(dpiTest_3706_verifyTraceRecords,
+            "verify trace records and statistics in a single thread");
+    dpiTestSuite_addCase(dpiTest_3707_verifyTraceConcurrency,
+            "verify trace statistics from many threads");
+    dpiTestSuite_addCase(dpiTest_3708_verifyTraceFile,
+            "verify trace buffers are written to a file");
+    return dpiTestSuite_run();
+}
@@ -0,0 +1,156 @@
+#! /usr/bin/env python
+#-----------------------------------------------------------------------------
+# Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+# This program is free software: you can modify it and/or redistribute it
+# under the terms of:
+#
+# (i)  the Universal Permissive License v 1.0 or at your option, any
+#      later version (http://oss.oracle.com/licenses/upl); and/or
+#
+# (ii) the Apache License v 2.0. (http://www.apache.org/licenses/LICENSE-2.0)
+#-----------------------------------------------------------------------------
+
+"""
+A script to decode the binary trace files written by dpiContext_writeTrace().
+
+The public function calls are only recorded when DPI_DEBUG_LEVEL includes
+DPI_DEBUG_LEVEL_TRACE (128):
+
+    export DPI_DEBUG_LEVEL=128
+    ./myprog                        # calls dpiContext_writeTrace("fn.trc")
+    python fn_trace.py fn.trc       # prints each call in time order
+    python fn_trace.py -s fn.trc    # prints a summary by function
+"""
+
+import struct
+import sys
+
+MAGIC = b"DPITRACE"
+BYTE_ORDER_MARK = 0x01020304
+RECORD_FORMAT = "QQQHBbI"
+
+RECORD_TYPE_START = 1
+RECORD_TYPE_END = 2
+
+def read_trace(file_name):
+    """
+    Reads the trace file and returns a dictionary mapping function identifiers
+    to function names and the list of records (as tuples of timestamp, thread
+    id, handle, function id, record type, status and depth) sorted by time.
+    """
+    with open(file_name, "rb") as f:
+        data = f.read()
+    if data[:8] != MAGIC:
+        raise Exception("%s is not an ODPI-C trace file" % file_name)
+    for prefix in ("<", ">"):
+        version, mark, record_size = struct.unpack_from(prefix + "III",
+                                                        data, 8)
+        if mark == BYTE_ORDER_MARK:
+            break
+    else:
+        raise Exception("byte order of %s not recognized" % file_name)
+    record_format = prefix + RECORD_FORMAT
+    if version != 1 or record_size != struct.calcsize(record_format):
+        raise Exception("trace file version %d not supported" % version)
+    pos = 20
+    fn_names = {}
+    num_fns, = struct.unpack_from(prefix + "I", data, pos)
+    pos += 4
+    for i in range(num_fns):
+        fn_id, name_length = struct.unpack_from(prefix + "HH", data, pos)
+        pos += 4
+        fn_names[fn_id] = data[pos:pos + name_length].decode()
+        pos += name_length
+    records = []
+    num_buffers, = struct.unpack_from(prefix + "I", data, pos)
+    pos += 4
+    for i in range(num_buffers):
+        num_records, = struct.unpack_from(prefix + "I", data, pos)
+        pos += 4
+        for j in range(num_records):
+            records.append(struct.unpack_from(record_format, data, pos))
+            pos += record_size
+    records.sort()
+    return fn_names, records
+
+def match_calls(records):
+    """
+    Matches the start and end records of each call made by each thread and
+    returns a list of tuples of start record, end record and elapsed time in
+    nanoseconds. Calls which started before the oldest record retained in the
+    ring buffer of the thread are not returned.
+    """
+    calls = []
+    in_progress = {}
+    for record in records:
+        timestamp, thread_id, handle, fn_id, record_type, status, depth = \
+                record
+        key = (thread_id, depth)
+        if record_type == RECORD_TYPE_START:
+            in_progress[key] = record
+        else:
+            start_record = in_progress.pop(key, None)
+            if start_record is not None and start_record[3] == fn_id:
+                calls.append((start_record, record,
+                              timestamp - start_record[0]))
+    return calls
+
+def print_records(fn_names, records):
+    """
+    Prints each record in time order, with the time relative to the first
+    record.
+    """
+    calls = dict((id(r), elapsed) for s, r, elapsed in match_calls(records))
+    base_timestamp = records[0][0] if records else 0
+    for record in records:
+        timestamp, thread_id, handle, fn_id, record_type, status, depth = \
+                record
+        fn_name = fn_names.get(fn_id, "(unknown)")
+        relative_time = (timestamp - base_timestamp) / 1000.0
+        indent = "  " * depth
+        if record_type == RECORD_TYPE_START:
+            print("%14.3f us [%x] %sstart %s(0x%x)" % \
+                    (relative_time, thread_id, indent, fn_name, handle))
+        else:
+            elapsed = calls.get(id(record))
+            elapsed_str = "" if elapsed is None \
+                    else " in %.3f us" % (elapsed / 1000.0)
+            print("%14.3f us [%x] %send %s(0x%x) -> %d%s" % \
+                    (relative_time, thread_id, indent, fn_name, handle,
+                     status, elapsed_str))
+
+def print_summary(fn_names, records):
+    """
+    Prints the number of calls, number of failures and latency percentiles of
+    each function, calculated from the calls found in the records.
+    """
+    elapsed_by_fn = {}
+    failures_by_fn = {}
+    for start_record, end_record, elapsed in match_calls(records):
+        fn_name = fn_names.get(end_record[3], "(unknown)")
+        elapsed_by_fn.setdefault(fn_name, []).append(elapsed)
+        if end_record[5] < 0:
+            failures_by_fn[fn_name] = failures_by_fn.get(fn_name, 0) + 1
+    print("%-40s %8s %8s %12s %12s %12s" % \
+            ("Function", "Calls", "Failed", "p50 (us)", "p99 (us)",
+             "Max (us)"))
+    for fn_name in sorted(elapsed_by_fn):
+        values = sorted(elapsed_by_fn[fn_name])
+        p50 = values[len(values) // 2]
+        p99 = values[min(len(values) - 1, len(values) * 99 // 100)]
+        print("%-40s %8d %8d %12.3f %12.3f %12.3f" % \
+                (fn_name, len(values), failures_by_fn.get(fn_name, 0),
+                 p50 / 1000.0, p99 / 1000.0, values[-1] / 1000.0))
+
+args = sys.argv[1:]
+summary = "-s" in args
+if summary:
+    args.remove("-s")
+if len(args) != 1:
+    print("Usage: python fn_trace.py [-s] trace_file")
+    sys.exit(1)
+fn_names, records = read_trace(args[0])
+if summary:
+    print_summary(fn_names, records)
+else:
+    print_records(fn_names, records)
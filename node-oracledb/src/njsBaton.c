@@ -28,6 +28,14 @@
 // methods used internally
 static bool njsBaton_completeAsyncHelper(njsBaton *baton, napi_env env,
         napi_value *resolution);
+static void njsBaton_completeThreadPoolWork(napi_env env, napi_value callback,
+        void *context, void *data);
+static napi_value njsBaton_completionFn(napi_env env, napi_callback_info info);
+static void njsBaton_finalizeThreadPoolWork(napi_env env, void *finalizeData,
+        void *finalizeHint);
+static void njsBaton_freeCompleted(njsOracleDb *oracleDb, napi_env env);
+static bool njsBaton_queueThreadPoolWork(njsBaton *baton, napi_env env,
+        bool *queued);
 static void njsBaton_freeShardingKeys(uint8_t *numShardingKeyColumns,
         dpiShardingKeyColumn **shardingKeyColumns);
 
@@ -126,6 +134,79 @@ bool njsBaton_createDate(njsBaton *baton, napi_env env, double value,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsBaton_completeThreadPoolWork()
+//   Callback used by the threadsafe function of the OracleDb instance when
+// work queued on the thread pool used for database calls has been completed.
+// All of the batons completed since the last call are taken from the list in
+// one step and completed in the order in which they were posted, so that a
+// single wakeup of the main thread resolves many promises. Each baton is
+// completed in its own handle scope and an exception raised by one of them is
+// reported as an uncaught exception so that the others are still completed.
+// The threadsafe function is no longer referenced once all outstanding work
+// has been completed so that it does not prevent Node.js from exiting.
+//-----------------------------------------------------------------------------
+static void njsBaton_completeThreadPoolWork(napi_env env, napi_value callback,
+        void *context, void *data)
+{
+    njsOracleDb *oracleDb = (njsOracleDb*) context;
+    njsBaton *baton, *nextBaton, *batons = NULL;
+    napi_handle_scope scope;
+    napi_value error;
+    bool isPending;
+
+    // nothing can be done if the environment is being torn down; this is
+    // only called after the finalize callback of the threadsafe function,
+    // which has already freed the batons (and possibly the instance as well),
+    // see njsBaton_finalizeThreadPoolWork()
+    if (!env)
+        return;
+
+    // take all of the completed batons; they are posted in reverse order
+    baton = (njsBaton*) njsAtomic_exchangePtr(&oracleDb->completedBatons,
+            NULL);
+    while (baton) {
+        nextBaton = baton->nextCompleted;
+        baton->nextCompleted = batons;
+        batons = baton;
+        baton = nextBaton;
+    }
+
+    // complete each of them
+    while (batons) {
+        baton = batons;
+        batons = baton->nextCompleted;
+        baton->nextCompleted = NULL;
+        oracleDb->numQueuedWork--;
+        if (napi_open_handle_scope(env, &scope) != napi_ok)
+            scope = NULL;
+        njsBaton_completeAsync(env, napi_ok, baton);
+        if (napi_is_exception_pending(env, &isPending) == napi_ok &&
+                isPending &&
+                napi_get_and_clear_last_exception(env, &error) == napi_ok)
+            napi_fatal_exception(env, error);
+        if (scope)
+            napi_close_handle_scope(env, scope);
+    }
+
+    if (oracleDb->numQueuedWork == 0)
+        napi_unref_threadsafe_function(env, oracleDb->completionFn);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsBaton_completionFn()
+//   JavaScript function associated with the threadsafe function of the
+// OracleDb instance. It is never called since the work is completed directly
+// by njsBaton_completeThreadPoolWork() but older versions of Node.js require
+// that a function be specified.
+//-----------------------------------------------------------------------------
+static napi_value njsBaton_completionFn(napi_env env, napi_callback_info info)
+{
+    return NULL;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsBaton_executeAsync()
 //   Callback used during asynchronous processing that takes place on a
@@ -141,12 +222,39 @@ static void njsBaton_executeAsync(napi_env env, void *data)
 }
 
 
+//-----------------------------------------------------------------------------
+// njsBaton_finalizeThreadPoolWork()
+//   Finalize callback of the threadsafe function of the OracleDb instance,
+// which is invoked when the environment is being torn down. The thread pool
+// used for database calls is waited on until it has finished all of the work
+// queued for the instance, since the threads refer to both the instance and
+// the threadsafe function; the batons that were completed but not yet
+// processed can then no longer be completed and are freed. The instance
+// itself is freed here if it has already been finalized (see
+// njsOracleDb_finalize()).
+//-----------------------------------------------------------------------------
+static void njsBaton_finalizeThreadPoolWork(napi_env env, void *finalizeData,
+        void *finalizeHint)
+{
+    njsOracleDb *oracleDb = (njsOracleDb*) finalizeData;
+
+    njsThreadPool_waitForWork(oracleDb);
+    njsBaton_freeCompleted(oracleDb, env);
+    oracleDb->completionFn = NULL;
+    if (oracleDb->isFinalized)
+        njsOracleDb_free(oracleDb, env);
+}
+
+
 //-----------------------------------------------------------------------------
 // njsBaton_free()
-//   Frees the memory allocated for the baton.
+//   Frees the memory allocated for the baton. The baton itself is kept on the
+// free list of its OracleDb instance, if there is room, so that it can be
+// reused without allocating memory.
 //-----------------------------------------------------------------------------
 void njsBaton_free(njsBaton *baton, napi_env env)
 {
+    njsOracleDb *oracleDb;
     uint32_t i;
 
     // if this baton is considered the active baton, clear it
@@ -281,6 +389,23 @@ void njsBaton_free(njsBaton *baton, napi_env env)
     // free batch errors
     NJS_FREE_AND_CLEAR(baton->batchErrorInfos);
 
+    // free rows buffered when fetching all rows
+    if (baton->fetchBuffers) {
+        for (i = 0; i < baton->numFetchBuffers; i++) {
+            NJS_FREE_AND_CLEAR(baton->fetchBuffers[i].dpiVarData);
+            NJS_FREE_AND_CLEAR(baton->fetchBuffers[i].blocks);
+        }
+        free(baton->fetchBuffers);
+        baton->fetchBuffers = NULL;
+    }
+    if (baton->fetchBlocks) {
+        for (i = 0; i < baton->numFetchBlocks; i++)
+            njsUtils_releaseBlock(baton->fetchBlocks[i]);
+        free(baton->fetchBlocks);
+        baton->fetchBlocks = NULL;
+    }
+    NJS_FREE_AND_CLEAR(baton->jsonText);
+
     // free implicit results
     while (baton->implicitResults) {
         if (baton->implicitResults->stmt) {
@@ -324,10 +449,50 @@ void njsBaton_free(njsBaton *baton, napi_env env)
     njsBaton_freeShardingKeys(&baton->numSuperShardingKeyColumns,
             &baton->superShardingKeyColumns);
 
+    // keep the baton for reuse by a subsequent call, if permitted; everything
+    // that refers to other memory has been cleared above, so only the values
+    // need to be reset; the error message is a null terminated string so only
+    // its first byte needs to be cleared
+    oracleDb = baton->oracleDb;
+    if (oracleDb && oracleDb->numFreeBatons < NJS_MAX_FREE_BATONS) {
+        memset(baton, 0, offsetof(njsBaton, error));
+        baton->error[0] = '\0';
+        memset(&baton->errorInfo, 0,
+                sizeof(njsBaton) - offsetof(njsBaton, errorInfo));
+        baton->nextQueued = oracleDb->freeBatons;
+        oracleDb->freeBatons = baton;
+        oracleDb->numFreeBatons++;
+        return;
+    }
+
     free(baton);
 }
 
 
+//-----------------------------------------------------------------------------
+// njsBaton_freeCompleted()
+//   Frees the batons posted back to the main thread by the thread pool used
+// for database calls without completing them. This is only done when the
+// environment is being torn down; the instances that called the methods may
+// already have been freed so they are not referenced.
+//-----------------------------------------------------------------------------
+static void njsBaton_freeCompleted(njsOracleDb *oracleDb, napi_env env)
+{
+    njsBaton *baton, *nextBaton;
+
+    baton = (njsBaton*) njsAtomic_exchangePtr(&oracleDb->completedBatons,
+            NULL);
+    while (baton) {
+        nextBaton = baton->nextCompleted;
+        baton->nextCompleted = NULL;
+        baton->callingInstance = NULL;
+        oracleDb->numQueuedWork--;
+        njsBaton_free(baton, env);
+        baton = nextBaton;
+    }
+}
+
+
 //-----------------------------------------------------------------------------
 // njsBaton_freeShardingKeys()
 //   To clean up array of ShardingKeys
@@ -424,7 +589,7 @@ bool njsBaton_getFetchInfoFromArg(njsBaton *baton, napi_env env,
     napi_value value, keys, key, element, tempArgs[3];
     njsFetchInfo *tempFetchInfo;
     uint32_t i, numElements;
-    bool tempFound;
+    bool tempFound, internFound;
 
     // get the value from the object and verify it is an object
     if (!njsBaton_getValueFromArg(baton, env, args, argIndex, propertyName,
@@ -457,12 +622,18 @@ bool njsBaton_getFetchInfoFromArg(njsBaton *baton, napi_env env,
                 &tempFetchInfo[i].nameLength))
             return false;
 
-        // get type
+        // get whether strings should be interned; the type is optional when
+        // interning is specified
         tempArgs[2] = element;
+        if (!njsBaton_getBoolFromArg(baton, env, tempArgs, 2, "intern",
+                &tempFetchInfo[i].intern, &internFound))
+            return false;
+
+        // get type
         if (!njsBaton_getUnsignedIntFromArg(baton, env, tempArgs, 2,
                 "type", &tempFetchInfo[i].type, &tempFound))
             return false;
-        if (!tempFound)
+        if (!tempFound && !internFound)
             return njsBaton_setError(baton, errNoTypeForConversion);
         if (tempFetchInfo[i].type != NJS_DATATYPE_DEFAULT &&
                     tempFetchInfo[i].type != NJS_DATATYPE_STR &&
@@ -943,6 +1114,31 @@ bool njsBaton_isDate(njsBaton *baton, napi_env env, napi_value value,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsBaton_postCompleted()
+//   Posts a baton whose work has been completed by the thread pool used for
+// database calls back to the main thread. The baton is pushed onto a
+// lock-free list held by the OracleDb instance and the main thread is only
+// woken if the list was empty; otherwise a wakeup is already pending and it
+// will complete this baton as well. This is called on the thread that
+// performed the work.
+//-----------------------------------------------------------------------------
+void njsBaton_postCompleted(njsBaton *baton)
+{
+    njsOracleDb *oracleDb = baton->oracleDb;
+    njsBaton *head;
+
+    do {
+        head = (njsBaton*) njsAtomic_loadPtr(&oracleDb->completedBatons);
+        baton->nextCompleted = head;
+    } while (!njsAtomic_compareExchangePtr(&oracleDb->completedBatons, head,
+            baton));
+    if (!head)
+        napi_call_threadsafe_function(oracleDb->completionFn, NULL,
+                napi_tsfn_nonblocking);
+}
+
+
 //-----------------------------------------------------------------------------
 // njsBaton_queueWork()
 //   Queue work on a separate thread. The baton is passed as context. If this
@@ -954,6 +1150,7 @@ napi_value njsBaton_queueWork(njsBaton *baton, napi_env env,
         bool (*afterWorkCallback)(njsBaton*, napi_env, napi_value*))
 {
     napi_value asyncResourceName, promise;
+    bool queued;
 
     // save the methods that will be used to perform the asynchronous work
     baton->workCallback = workCallback;
@@ -967,17 +1164,31 @@ napi_value njsBaton_queueWork(njsBaton *baton, napi_env env,
         return NULL;
     }
 
-    // create the asynchronous work handle
-    if (napi_create_async_work(env, NULL, asyncResourceName,
-            njsBaton_executeAsync, njsBaton_completeAsync, baton,
-            &baton->asyncWork) != napi_ok) {
+    // create a promise which will be returned to JavaScript
+    if (napi_create_promise(env, &baton->deferred, &promise) != napi_ok) {
         njsUtils_genericThrowError(env);
         njsBaton_free(baton, env);
         return NULL;
     }
 
-    // create a promise which will be returned to JavaScript
-    if (napi_create_promise(env, &baton->deferred, &promise) != napi_ok) {
+    // queue the work on the thread pool used for database calls, unless it
+    // has been disabled by setting its size to zero
+    if (njsThreadPool_getSize() > 0) {
+        if (!njsBaton_queueThreadPoolWork(baton, env, &queued)) {
+            napi_reject_deferred(env, baton->deferred, NULL);
+            njsUtils_genericThrowError(env);
+            njsBaton_free(baton, env);
+            return NULL;
+        }
+        if (queued)
+            return promise;
+    }
+
+    // create the asynchronous work handle
+    if (napi_create_async_work(env, NULL, asyncResourceName,
+            njsBaton_executeAsync, njsBaton_completeAsync, baton,
+            &baton->asyncWork) != napi_ok) {
+        napi_reject_deferred(env, baton->deferred, NULL);
         njsUtils_genericThrowError(env);
         njsBaton_free(baton, env);
         return NULL;
@@ -995,6 +1206,51 @@ napi_value njsBaton_queueWork(njsBaton *baton, napi_env env,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsBaton_queueThreadPoolWork()
+//   Queues the work on the thread pool used for database calls. The
+// threadsafe function used to post completed work back to the main thread is
+// created the first time work is queued for the OracleDb instance and is only
+// referenced while work is outstanding. The queued flag is cleared if no
+// thread is available in the pool, in which case the caller is expected to
+// queue the work on the libuv thread pool instead.
+//-----------------------------------------------------------------------------
+static bool njsBaton_queueThreadPoolWork(njsBaton *baton, napi_env env,
+        bool *queued)
+{
+    njsOracleDb *oracleDb = baton->oracleDb;
+    napi_value fn, name;
+
+    // create the threadsafe function, if needed
+    if (!oracleDb->completionFn) {
+        NJS_CHECK_NAPI(env, napi_create_function(env, "completionFn",
+                NAPI_AUTO_LENGTH, njsBaton_completionFn, NULL, &fn))
+        NJS_CHECK_NAPI(env, napi_create_string_utf8(env, "oracledb",
+                NAPI_AUTO_LENGTH, &name))
+        NJS_CHECK_NAPI(env, napi_create_threadsafe_function(env, fn, NULL,
+                name, 0, 1, oracleDb, njsBaton_finalizeThreadPoolWork,
+                oracleDb, njsBaton_completeThreadPoolWork,
+                &oracleDb->completionFn))
+        NJS_CHECK_NAPI(env, napi_unref_threadsafe_function(env,
+                oracleDb->completionFn))
+    }
+
+    // reference the threadsafe function while work is outstanding
+    if (oracleDb->numQueuedWork == 0)
+        NJS_CHECK_NAPI(env, napi_ref_threadsafe_function(env,
+                oracleDb->completionFn))
+    *queued = njsThreadPool_queueWork(baton);
+    if (*queued) {
+        oracleDb->numQueuedWork++;
+    } else if (oracleDb->numQueuedWork == 0) {
+        NJS_CHECK_NAPI(env, napi_unref_threadsafe_function(env,
+                oracleDb->completionFn))
+    }
+
+    return true;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsBaton_reportError()
 //   Reports the error on the baton. When this is called it is expected that
@@ -179,6 +179,8 @@ const njsClassDef njsClassDefConnection = {
 // other methods used internally
 static bool njsConnection_createBaton(napi_env env, napi_callback_info info,
         size_t numArgs, napi_value *args, njsBaton **baton);
+static bool njsConnection_fetchOnExecute(njsConnection *conn,
+        njsBaton *baton);
 static bool njsConnection_getBatchErrors(njsBaton *baton, napi_env env,
         napi_value *batchErrors);
 static bool njsConnection_getBindInfoFromArray(njsBaton *baton,
@@ -576,6 +578,12 @@ static bool njsConnection_executeAsync(njsBaton *baton)
                 baton->dpiStmtHandle, baton))
             return false;
 
+        // if all rows are going to be fetched, fetch the first batch now in
+        // order to avoid a separate trip to the thread pool for it
+        if (baton->fetchOnExecute &&
+                !njsConnection_fetchOnExecute(conn, baton))
+            return false;
+
     // for all other statements, determine the number of rows affected, process
     // variables (to manage LOBs, REF cursors, PL/SQL arrays, etc.) and process
     // implicit results
@@ -603,9 +611,10 @@ static bool njsConnection_executePostAsync(njsBaton *baton, napi_env env,
         napi_value *result)
 {
     napi_value metadata, resultSet, rowsAffected, outBinds, lastRowid;
-    napi_value implicitResults;
+    napi_value implicitResults, rows, internStats;
     uint32_t rowidValueLength;
     const char *rowidValue;
+    njsResultSet *rs;
     dpiRowid *rowid;
 
     // set JavaScript values to simplify creation of returned objects
@@ -640,6 +649,29 @@ static bool njsConnection_executePostAsync(njsBaton *baton, napi_env env,
         baton->dpiStmtHandle = NULL;
         baton->queryVars = NULL;
         baton->numQueryVars = 0;
+
+        // if the first batch of rows was fetched during execute, create the
+        // rows; the result set is only returned if more rows remain to be
+        // fetched, so the statistics for any interned strings, which were
+        // saved when the result set was closed, are returned directly
+        if (baton->fetchedOnExecute) {
+            NJS_CHECK_NAPI(env, napi_unwrap(env, resultSet, (void**) &rs))
+            rs->varsDefined = true;
+            if (!njsResultSet_createRows(rs, resultSet, NULL, baton, env,
+                    &rows))
+                return false;
+            NJS_CHECK_NAPI(env, napi_set_named_property(env, *result, "rows",
+                    rows))
+            if (!rs->handle) {
+                if (rs->jsInternStats) {
+                    NJS_CHECK_NAPI(env, napi_get_reference_value(env,
+                            rs->jsInternStats, &internStats))
+                    NJS_CHECK_NAPI(env, napi_set_named_property(env, *result,
+                            "internStatistics", internStats))
+                }
+                return true;
+            }
+        }
         NJS_CHECK_NAPI(env, napi_set_named_property(env, *result, "resultSet",
                 resultSet))
 
@@ -708,6 +740,7 @@ static bool njsConnection_executeProcessArgs(njsBaton *baton,
     baton->autoCommit = baton->oracleDb->autoCommit;
     baton->dbObjectAsPojo = baton->oracleDb->dbObjectAsPojo;
     baton->fetchArraySize = baton->oracleDb->fetchArraySize;
+    baton->fetchAhead = baton->oracleDb->fetchAhead;
     baton->maxRows = baton->oracleDb->maxRows;
     baton->outFormat = baton->oracleDb->outFormat;
     baton->extendedMetaData = baton->oracleDb->extendedMetaData;
@@ -740,6 +773,9 @@ static bool njsConnection_executeProcessArgs(njsBaton *baton,
     if (!njsBaton_getUnsignedIntFromArg(baton, env, args, 2, "prefetchRows",
             &baton->prefetchRows, NULL))
         return false;
+    if (!njsBaton_getUnsignedIntFromArg(baton, env, args, 2, "fetchAhead",
+            &baton->fetchAhead, NULL))
+        return false;
     if (baton->fetchArraySize == 0)
         return njsBaton_setError(baton, errInvalidPropertyValueInParam,
                 "fetchArraySize", 3);
@@ -747,11 +783,20 @@ static bool njsConnection_executeProcessArgs(njsBaton *baton,
             &baton->outFormat, NULL))
         return false;
     if (baton->outFormat != NJS_ROWS_ARRAY &&
-            baton->outFormat != NJS_ROWS_OBJECT)
+            baton->outFormat != NJS_ROWS_OBJECT &&
+            baton->outFormat != NJS_ROWS_COLUMNS &&
+            baton->outFormat != NJS_ROWS_JSON &&
+            baton->outFormat != NJS_ROWS_NDJSON)
         return njsBaton_setError(baton, errInvalidPropertyValue, "outFormat");
     if (!njsBaton_getBoolFromArg(baton, env, args, 2, "resultSet",
             &getResultSet, NULL))
         return false;
+    if (!njsBaton_getBoolFromArg(baton, env, args, 2, "lazyRows",
+            &baton->lazyRows, NULL))
+        return false;
+    baton->fetchOnExecute = !getResultSet && !baton->lazyRows &&
+            baton->outFormat != NJS_ROWS_JSON &&
+            baton->outFormat != NJS_ROWS_NDJSON;
     if (!njsBaton_getBoolFromArg(baton, env, args, 2, "autoCommit",
             &baton->autoCommit, NULL))
         return false;
@@ -953,6 +998,50 @@ static bool njsConnection_executeManyProcessArgs(njsBaton *baton,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsConnection_fetchOnExecute()
+//   Fetches the first batch of rows of a query in the same worker function
+// that executed it, when all of the rows are going to be fetched. If all of
+// the rows were fetched, the statement is closed immediately. Queries with
+// nested cursors are skipped since the nested result sets must be created by
+// the result set of the parent.
+//-----------------------------------------------------------------------------
+static bool njsConnection_fetchOnExecute(njsConnection *conn,
+        njsBaton *baton)
+{
+    uint32_t fetchArraySize = baton->fetchArraySize, i;
+    bool varsDefined = false, closeOnFetch = false, moreRows;
+
+    // no fetch is performed if nested cursors are present
+    for (i = 0; i < baton->numQueryVars; i++) {
+        if (baton->queryVars[i].varTypeNum == DPI_ORACLE_TYPE_STMT)
+            return true;
+    }
+
+    // if the maximum number of rows can be fetched in a single fetch, only
+    // fetch that many rows
+    if (baton->maxRows > 0 && fetchArraySize >= baton->maxRows) {
+        fetchArraySize = baton->maxRows;
+        closeOnFetch = true;
+    }
+
+    // perform fetch
+    if (!njsResultSet_fetchRows(conn, baton->dpiStmtHandle, baton->queryVars,
+            baton->numQueryVars, fetchArraySize, &varsDefined, baton,
+            &moreRows))
+        return false;
+    baton->fetchedOnExecute = true;
+
+    // close the statement if no further rows are to be fetched
+    if (closeOnFetch || !moreRows) {
+        dpiStmt_release(baton->dpiStmtHandle);
+        baton->dpiStmtHandle = NULL;
+    }
+
+    return true;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsConnection_finalize()
 //   Invoked when the njsConnection object is garbage collected.
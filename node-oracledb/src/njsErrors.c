@@ -90,6 +90,8 @@ static const char *njsErrorMessages[] = {
     "NJS-081: concurrent operations on a connection are disabled", //errConcurrentOps
     "NJS-082: connection pool is being reconfigured", // errPoolReconfiguring
     "NJS-083: pool statistics not enabled", // errPoolStatisticsDisabled
+    "NJS-084: rows cannot be fetched individually when outFormat is OUT_FORMAT_COLUMNS, OUT_FORMAT_JSON or OUT_FORMAT_NDJSON", // errRowsNotIndividual
+    "NJS-085: column %d cannot be fetched as JSON text", // errJsonTextNotSupported
 };
 
 
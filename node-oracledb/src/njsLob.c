@@ -338,9 +338,9 @@ static bool njsLob_getDataPostAsync(njsBaton *baton, napi_env env,
             lob->dataType == DPI_ORACLE_TYPE_NCLOB) {
         NJS_CHECK_NAPI(env, napi_create_string_utf8(env, baton->bufferPtr,
                 baton->bufferSize, result))
-    } else {
-        NJS_CHECK_NAPI(env, napi_create_buffer_copy(env, baton->bufferSize,
-                baton->bufferPtr, NULL, result))
+    } else if (!njsUtils_transferToBuffer(env, &baton->bufferPtr,
+            baton->bufferSize, result)) {
+        return false;
     }
 
     return true;
@@ -483,9 +483,9 @@ static bool njsLob_readPostAsync(njsBaton *baton, napi_env env,
             lob->dataType == DPI_ORACLE_TYPE_NCLOB) {
         NJS_CHECK_NAPI(env, napi_create_string_utf8(env, lob->bufferPtr,
                 baton->bufferSize, result))
-    } else {
-        NJS_CHECK_NAPI(env, napi_create_buffer_copy(env, baton->bufferSize,
-                lob->bufferPtr, NULL, result))
+    } else if (!njsUtils_transferToBuffer(env, &lob->bufferPtr,
+            baton->bufferSize, result)) {
+        return false;
     }
 
     return true;
@@ -33,7 +33,7 @@
 //-----------------------------------------------------------------------------
 static napi_value njsModule_externalInit(napi_env env, napi_callback_info info)
 {
-    napi_value instance, thisArg;
+    napi_value instance, thisArg, global, temp;
     njsOracleDb *oracleDb;
     size_t actualArgs = 1;
 
@@ -100,6 +100,15 @@ static napi_value njsModule_externalInit(napi_env env, napi_callback_info info)
             &njsClassDefSodaOperation, &oracleDb->jsSodaOperationConstructor))
         return NULL;
 
+    // retain the Date constructor for converting values outside of a baton
+    if (napi_get_global(env, &global) != napi_ok ||
+            napi_get_named_property(env, global, "Date", &temp) != napi_ok ||
+            napi_create_reference(env, temp, 1,
+                    &oracleDb->jsDateConstructor) != napi_ok) {
+        njsUtils_genericThrowError(env);
+        return NULL;
+    }
+
     return NULL;
 }
 
@@ -29,7 +29,9 @@
 #define NAPI_VERSION 4
 
 #include <node_api.h>
+#include <math.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -67,6 +69,14 @@
 #define NJS_POOL_INCR                   1
 #define NJS_POOL_TIMEOUT                60
 #define NJS_LOB_PREFETCH_SIZE           16384
+#define NJS_DB_THREAD_POOL_SIZE         4
+
+// maximum number of batons kept for reuse by each OracleDb instance
+#define NJS_MAX_FREE_BATONS             128
+
+// minimum size of Buffers that refer to memory allocated by node-oracledb
+// instead of copying it; smaller values are cheaper to copy
+#define NJS_EXTERNAL_BUFFER_MIN_SIZE    1024
 #define NJS_POOL_DEFAULT_PING_INTERVAL  60
 
 // maximum length of error messages
@@ -89,6 +99,36 @@
     if ((status) != napi_ok) \
         return njsUtils_genericThrowError(env);
 
+// define atomic pointer operations; these are used for the lock-free list of
+// batons completed by the thread pool used for database calls and follow the
+// definitions used by ODPI-C
+#if defined(_WIN32)
+    typedef PVOID volatile njsAtomicPtr;
+    #define njsAtomic_loadPtr(p) \
+        InterlockedCompareExchangePointer((p), NULL, NULL)
+    #define njsAtomic_exchangePtr(p, v) \
+        InterlockedExchangePointer((p), (PVOID) (v))
+    #define njsAtomic_compareExchangePtr(p, e, v) \
+        (InterlockedCompareExchangePointer((p), (PVOID) (v), (PVOID) (e)) == \
+                (PVOID) (e))
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+        !defined(__STDC_NO_ATOMICS__)
+    #include <stdatomic.h>
+    typedef _Atomic(void*) njsAtomicPtr;
+    #define njsAtomic_loadPtr(p)        atomic_load(p)
+    #define njsAtomic_exchangePtr(p, v) atomic_exchange((p), (void*) (v))
+    #define njsAtomic_compareExchangePtr(p, e, v) \
+        atomic_compare_exchange_strong((p), (void**) &(e), (void*) (v))
+#else
+    typedef void *njsAtomicPtr;
+    #define njsAtomic_loadPtr(p)        __atomic_load_n((p), __ATOMIC_SEQ_CST)
+    #define njsAtomic_exchangePtr(p, v) \
+        __atomic_exchange_n((p), (void*) (v), __ATOMIC_SEQ_CST)
+    #define njsAtomic_compareExchangePtr(p, e, v) \
+        __atomic_compare_exchange_n((p), (void**) &(e), (void*) (v), 0, \
+                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#endif
+
 // define macros for defining Node-API functions; many are identical but different
 // names are used to make it easier to read
 #define NJS_NAPI_GETTER(name) \
@@ -113,6 +153,18 @@
 // fetchInfo
 #define NJS_MAX_FETCH_AS_STRING_SIZE    200
 
+// limits for the strings interned for each column with fetchInfo "intern";
+// longer values and values seen once the cache is full are not interned
+#define NJS_STRING_CACHE_MAX_ENTRIES    4096
+#define NJS_STRING_CACHE_MAX_VALUE_SIZE 256
+#define NJS_STRING_CACHE_INITIAL_SLOTS  64
+
+// space reserved when writing rows as JSON text: the maximum size of a number,
+// date or other value that is not a byte string and the initial size of the
+// text
+#define NJS_JSON_TEXT_MAX_SCALAR_SIZE   40
+#define NJS_JSON_TEXT_INITIAL_SIZE      65536
+
 // encoding name to use for all strings
 #define NJS_ENCODING                    "UTF-8"
 
@@ -206,6 +258,8 @@ typedef enum {
     errConcurrentOps,
     errPoolReconfiguring,
     errPoolStatisticsDisabled,
+    errRowsNotIndividual,
+    errJsonTextNotSupported,
 
     // New ones should be added here
 
@@ -221,6 +275,9 @@ typedef enum {
 // values used for "outFormat"
 #define NJS_ROWS_ARRAY                  4001
 #define NJS_ROWS_OBJECT                 4002
+#define NJS_ROWS_COLUMNS                4003
+#define NJS_ROWS_JSON                   4004
+#define NJS_ROWS_NDJSON                 4005
 
 // values used for SODA collection creation mode
 #define NJS_SODA_COLL_CREATE_MODE_DEFAULT   0
@@ -242,6 +299,7 @@ typedef struct njsAqMessage njsAqMessage;
 typedef struct njsAqQueue njsAqQueue;
 typedef struct njsBaseInstance njsBaseInstance;
 typedef struct njsBaton njsBaton;
+typedef struct njsBlock njsBlock;
 typedef struct njsClassDef njsClassDef;
 typedef struct njsConnection njsConnection;
 typedef struct njsConstant njsConstant;
@@ -249,6 +307,7 @@ typedef struct njsDataTypeInfo njsDataTypeInfo;
 typedef struct njsFetchInfo njsFetchInfo;
 typedef struct njsImplicitResult njsImplicitResult;
 typedef struct njsJsonBuffer njsJsonBuffer;
+typedef struct njsLazyRows njsLazyRows;
 typedef struct njsLob njsLob;
 typedef struct njsLobBuffer njsLobBuffer;
 typedef struct njsOracleDb njsOracleDb;
@@ -259,6 +318,8 @@ typedef struct njsSodaDatabase njsSodaDatabase;
 typedef struct njsSodaDocCursor njsSodaDocCursor;
 typedef struct njsSodaDocument njsSodaDocument;
 typedef struct njsSodaOperation njsSodaOperation;
+typedef struct njsStringCache njsStringCache;
+typedef struct njsStringCacheEntry njsStringCacheEntry;
 typedef struct njsSubscription njsSubscription;
 typedef struct njsVariable njsVariable;
 typedef struct njsVariableBuffer njsVariableBuffer;
@@ -430,6 +491,20 @@ struct njsBaton {
     uint32_t numRowCounts;
     uint64_t *rowCounts;
 
+    // rows buffered when fetching all rows (requires free)
+    uint32_t numFetchBuffers;
+    njsVariableBuffer *fetchBuffers;
+    uint32_t fetchBuffersAllocated;
+    uint32_t numFetchBlocks;
+    uint32_t fetchBlocksAllocated;
+    njsBlock **fetchBlocks;
+    uint64_t fetchMemoryUsed;
+
+    // text of rows fetched as JSON text (requires free)
+    char *jsonText;
+    size_t jsonTextLength;
+    size_t jsonTextAllocated;
+
     // mapping types (requires free)
     uint32_t numFetchInfo;
     njsFetchInfo *fetchInfo;
@@ -477,12 +552,18 @@ struct njsBaton {
     uint32_t shutdownMode;
     uint32_t startupMode;
     uint32_t prefetchRows;
+    uint32_t fetchMemoryLimit;
+    uint32_t fetchAhead;
 
     // boolean values
     bool externalAuth;
     bool homogeneous;
     bool closeOnFetch;
     bool closeOnAllRowsFetched;
+    bool fetchOnExecute;
+    bool fetchedOnExecute;
+    bool lazyRows;
+    bool moreRows;
     bool autoCommit;
     bool extendedMetaData;
     bool events;
@@ -535,11 +616,22 @@ struct njsBaton {
 
     // asynchronous work parameters
     napi_async_work asyncWork;
+    njsBaton *nextQueued;
+    njsBaton *nextCompleted;
     bool (*workCallback)(njsBaton*);
     bool (*afterWorkCallback)(njsBaton*, napi_env, napi_value*);
     napi_deferred deferred;
 };
 
+// data for a block of memory holding byte strings fetched from the database;
+// Buffers created for the larger values refer to the memory in the block
+// directly, so it is only freed once the baton that fetched the rows and all
+// of those Buffers have released it
+struct njsBlock {
+    uint32_t refCount;
+    char *data;
+};
+
 // data for class definitions exposed to JS
 struct njsClassDef {
     const char *name;
@@ -571,6 +663,7 @@ struct njsFetchInfo {
     char *name;
     size_t nameLength;
     uint32_t type;
+    bool intern;
 };
 
 // data for acquiring implicit results
@@ -605,6 +698,19 @@ struct njsLob {
     bool dirtyLength;
 };
 
+// data for rows returned with the execute() option lazyRows; the buffered
+// rows are retained and each value is only converted to JavaScript when it is
+// first accessed; the variables contain only the type information needed for
+// the conversion
+struct njsLazyRows {
+    njsOracleDb *oracleDb;
+    uint32_t numQueryVars;
+    njsVariable *queryVars;
+    njsVariableBuffer *buffers;
+    uint32_t numBlocks;
+    njsBlock **blocks;
+};
+
 // data for keeping track of LOBs in the worker thread
 struct njsLobBuffer {
     dpiLob *handle;
@@ -622,6 +728,7 @@ struct njsOracleDb {
     uint32_t outFormat;
     uint32_t stmtCacheSize;
     uint32_t fetchArraySize;
+    uint32_t fetchAhead;
     uint32_t poolMin;
     uint32_t poolMax;
     uint32_t poolMaxPerShard;
@@ -659,6 +766,15 @@ struct njsOracleDb {
     napi_ref jsSodaDocumentConstructor;
     napi_ref jsSodaOperationConstructor;
     napi_ref jsSubscriptions;
+    napi_threadsafe_function completionFn;
+    njsAtomicPtr completedBatons;
+    uint32_t numQueuedWork;
+    uint32_t numThreadPoolWork;
+    bool isFinalized;
+    njsBaton *freeBatons;
+    uint32_t numFreeBatons;
+    uint64_t numBatonsAllocated;
+    uint64_t numBatonsReused;
 };
 
 // data for class Pool exposed to JS.
@@ -673,6 +789,7 @@ struct njsPool {
     uint32_t poolTimeout;
     uint32_t stmtCacheSize;
     int32_t poolPingInterval;
+    uint32_t numDbThreads;
     bool  sodaMetadataCache;
 };
 
@@ -684,10 +801,15 @@ struct njsResultSet {
     uint32_t numQueryVars;
     njsVariable *queryVars;
     uint32_t fetchArraySize;
+    uint32_t fetchAhead;
     uint32_t outFormat;
     bool extendedMetaData;
     bool isNested;
     bool varsDefined;
+    bool lazyRows;
+    napi_ref jsRowConstructor;
+    napi_ref jsInternStats;
+    napi_value *rowValues;
 };
 
 // data for class SodaCollection exposed to JS.
@@ -764,17 +886,40 @@ struct njsVariable {
     njsVariableBuffer *buffer;
     uint32_t numDmlReturningBuffers;
     njsVariableBuffer *dmlReturningBuffers;
+    njsStringCache *stringCache;
 };
 
 // data for keeping track of ODPI-C buffers and LOBs
 struct njsVariableBuffer {
     uint32_t numElements;
     dpiData *dpiVarData;
+    njsBlock **blocks;
     njsLobBuffer *lobs;
     uint32_t numQueryVars;
     njsVariable *queryVars;
 };
 
+// data for the strings interned for a column; the strings are held in a
+// JavaScript array and the hash table maps the bytes of each value to its
+// index in that array
+struct njsStringCache {
+    napi_env env;
+    napi_ref jsValues;
+    uint32_t numSlots;
+    uint32_t numEntries;
+    uint64_t numHits;
+    uint64_t numMisses;
+    njsStringCacheEntry *slots;
+};
+
+// data for a single interned string
+struct njsStringCacheEntry {
+    uint32_t hash;
+    uint32_t length;
+    uint32_t index;
+    char *data;
+};
+
 
 // data for DbObject class exposed to JS
 struct njsDbObject {
@@ -869,6 +1014,7 @@ bool njsBaton_getValueFromArg(njsBaton *baton, napi_env env, napi_value *args,
 bool njsBaton_isBindValue(njsBaton *baton, napi_env env, napi_value value);
 bool njsBaton_isDate(njsBaton *baton, napi_env env, napi_value value,
         bool *isDate);
+void njsBaton_postCompleted(njsBaton *baton);
 napi_value njsBaton_queueWork(njsBaton *baton, napi_env env,
         const char *methodName, bool (*workCallback)(njsBaton*),
         bool (*afterWorkCallback)(njsBaton*, napi_env, napi_value*));
@@ -895,6 +1041,7 @@ bool njsDbObject_toPojo(napi_value obj, napi_env env, napi_value *pojo);
 //-----------------------------------------------------------------------------
 // definition of functions for njsOracleDb class
 //-----------------------------------------------------------------------------
+void njsOracleDb_free(njsOracleDb *oracleDb, napi_env env);
 bool njsOracleDb_new(napi_env env, napi_value instanceObj,
         njsOracleDb **instance);
 bool njsOracleDb_prepareClass(njsOracleDb *oracleDb, napi_env env,
@@ -938,6 +1085,13 @@ bool njsPool_newFromBaton(njsBaton *baton, napi_env env, napi_value *poolObj);
 //-----------------------------------------------------------------------------
 // definition of functions for njsResultSet class
 //-----------------------------------------------------------------------------
+bool njsResultSet_createRows(njsResultSet *rs, napi_value rsObj,
+        njsVariableBuffer *buffers, njsBaton *baton, napi_env env,
+        napi_value *rows);
+bool njsResultSet_fetchRows(njsConnection *conn, dpiStmt *handle,
+        njsVariable *queryVars, uint32_t numQueryVars,
+        uint32_t fetchArraySize, bool *varsDefined, njsBaton *baton,
+        bool *moreRows);
 bool njsResultSet_new(njsBaton *baton, napi_env env, njsConnection *conn,
         dpiStmt *handle, njsVariable *vars, uint32_t numVars,
         napi_value *rsObj);
@@ -990,6 +1144,16 @@ bool njsSubscription_startNotifications(njsSubscription *subscr,
 bool njsSubscription_stopNotifications(njsSubscription *subscr);
 
 
+//-----------------------------------------------------------------------------
+// definition of functions for the thread pool used for database calls
+//-----------------------------------------------------------------------------
+void njsThreadPool_addPoolThreads(int32_t numThreads);
+uint32_t njsThreadPool_getSize(void);
+bool njsThreadPool_queueWork(njsBaton *baton);
+void njsThreadPool_setSize(uint32_t size);
+void njsThreadPool_waitForWork(njsOracleDb *oracleDb);
+
+
 //-----------------------------------------------------------------------------
 // definition of utility functions
 //-----------------------------------------------------------------------------
@@ -1011,6 +1175,9 @@ bool njsUtils_copyStringFromJS(napi_env env, napi_value value, char **result,
         size_t *resultLength);
 bool njsUtils_createBaton(napi_env env, napi_callback_info info,
         size_t numArgs, napi_value *args, njsBaton **baton);
+njsBlock *njsUtils_createBlock(size_t size);
+bool njsUtils_createBufferFromBlock(napi_env env, njsBlock *block,
+        char *ptr, size_t length, napi_value *value);
 bool njsUtils_genericNew(napi_env env, const njsClassDef *classDef,
         napi_ref constructorRef, napi_value *instanceObj,
         njsBaseInstance **instance);
@@ -1036,6 +1203,7 @@ bool njsUtils_getValueFromArg(napi_env env, napi_value *args,
         napi_value *value, bool *found, char *errorBuffer);
 bool njsUtils_isBuffer(napi_env env, napi_value value);
 bool njsUtils_isInstance(napi_env env, napi_value value, const char *name);
+void njsUtils_releaseBlock(njsBlock *block);
 bool njsUtils_setPropBool(napi_env env, napi_value value, const char *name,
         bool *result);
 bool njsUtils_setPropInt(napi_env env, napi_value value, const char *name,
@@ -1049,6 +1217,8 @@ bool njsUtils_setPropUnsignedIntArray(napi_env env, napi_value value,
         const uint32_t *validTypes);
 bool njsUtils_throwError(napi_env env, int errNum, ...);
 bool njsUtils_throwErrorDPI(napi_env env, njsOracleDb *oracleDb);
+bool njsUtils_transferToBuffer(napi_env env, char **ptr, size_t length,
+        napi_value *value);
 bool njsUtils_validateArgs(napi_env env, napi_callback_info info,
         size_t numArgs, napi_value *args, napi_value *callingObj,
         njsBaseInstance **instance);
@@ -1070,6 +1240,14 @@ bool njsVariable_createBuffer(njsVariable *var, njsConnection *conn,
 void njsVariable_free(njsVariable *var);
 bool njsVariable_getArrayValue(njsVariable *var, njsConnection *conn,
         uint32_t pos, njsBaton *baton, napi_env env, napi_value *value);
+bool njsVariable_getBufferedValue(njsVariable *var, njsVariableBuffer *buffer,
+        uint32_t pos, napi_value jsDateConstructor, napi_env env,
+        napi_value *value);
+bool njsVariable_getColumnValues(njsVariable *var, njsConnection *conn,
+        njsVariableBuffer *buffer, uint32_t numRows, njsBaton *baton,
+        napi_env env, napi_value *column);
+bool njsVariable_getInternStats(njsVariable *vars, uint32_t numVars,
+        napi_env env, napi_value *stats);
 bool njsVariable_getMetadataMany(njsVariable *vars, uint32_t numVars,
         napi_env env, bool extended, napi_value *metadata);
 bool njsVariable_getMetadataOne(njsVariable *var, napi_env env, bool extended,
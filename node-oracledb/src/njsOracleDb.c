@@ -44,14 +44,17 @@ static NJS_PROCESS_ARGS_METHOD(njsOracleDb_getConnectionProcessArgs);
 
 // getters
 static NJS_NAPI_GETTER(njsOracleDb_getAutoCommit);
+static NJS_NAPI_GETTER(njsOracleDb_getBatonStatistics);
 static NJS_NAPI_GETTER(njsOracleDb_getConnectionClass);
 static NJS_NAPI_GETTER(njsOracleDb_getEdition);
 static NJS_NAPI_GETTER(njsOracleDb_getEvents);
 static NJS_NAPI_GETTER(njsOracleDb_getExtendedMetaData);
 static NJS_NAPI_GETTER(njsOracleDb_getExternalAuth);
+static NJS_NAPI_GETTER(njsOracleDb_getFetchAhead);
 static NJS_NAPI_GETTER(njsOracleDb_getFetchArraySize);
 static NJS_NAPI_GETTER(njsOracleDb_getFetchAsBuffer);
 static NJS_NAPI_GETTER(njsOracleDb_getDbObjectAsPojo);
+static NJS_NAPI_GETTER(njsOracleDb_getDbThreadPoolSize);
 static NJS_NAPI_GETTER(njsOracleDb_getFetchAsString);
 static NJS_NAPI_GETTER(njsOracleDb_getLobPrefetchSize);
 static NJS_NAPI_GETTER(njsOracleDb_getMaxRows);
@@ -77,9 +80,11 @@ static NJS_NAPI_SETTER(njsOracleDb_setEdition);
 static NJS_NAPI_SETTER(njsOracleDb_setEvents);
 static NJS_NAPI_SETTER(njsOracleDb_setExtendedMetaData);
 static NJS_NAPI_SETTER(njsOracleDb_setExternalAuth);
+static NJS_NAPI_SETTER(njsOracleDb_setFetchAhead);
 static NJS_NAPI_SETTER(njsOracleDb_setFetchArraySize);
 static NJS_NAPI_SETTER(njsOracleDb_setFetchAsBuffer);
 static NJS_NAPI_SETTER(njsOracleDb_setDbObjectAsPojo);
+static NJS_NAPI_SETTER(njsOracleDb_setDbThreadPoolSize);
 static NJS_NAPI_SETTER(njsOracleDb_setFetchAsString);
 static NJS_NAPI_SETTER(njsOracleDb_setLobPrefetchSize);
 static NJS_NAPI_SETTER(njsOracleDb_setMaxRows);
@@ -97,6 +102,8 @@ static NJS_NAPI_SETTER(njsOracleDb_setStmtCacheSize);
 static NJS_NAPI_FINALIZE(njsOracleDb_finalize);
 
 // other methods used internally
+static bool njsOracleDb_getBatonStatisticsHelper(njsOracleDb *oracleDb,
+        napi_env env, napi_value *stats);
 static bool njsOracleDb_initCommonCreateParams(njsBaton *baton,
         dpiCommonCreateParams *params);
 static bool njsOracleDb_initDPI(njsOracleDb *oracleDb, napi_env env,
@@ -231,6 +238,9 @@ static njsConstant njsClassConstants[] = {
     // outFormat values
     { "OUT_FORMAT_ARRAY", NJS_ROWS_ARRAY },
     { "OUT_FORMAT_OBJECT", NJS_ROWS_OBJECT },
+    { "OUT_FORMAT_COLUMNS", NJS_ROWS_COLUMNS },
+    { "OUT_FORMAT_JSON", NJS_ROWS_JSON },
+    { "OUT_FORMAT_NDJSON", NJS_ROWS_NDJSON },
     { "ARRAY", NJS_ROWS_ARRAY },
     { "OBJECT", NJS_ROWS_OBJECT },
 
@@ -292,12 +302,16 @@ static const napi_property_descriptor njsClassProperties[] = {
             njsOracleDb_setExtendedMetaData, NULL, napi_default, NULL },
     { "externalAuth", NULL, NULL, njsOracleDb_getExternalAuth,
             njsOracleDb_setExternalAuth, NULL, napi_default, NULL },
+    { "fetchAhead", NULL, NULL, njsOracleDb_getFetchAhead,
+            njsOracleDb_setFetchAhead, NULL, napi_default, NULL },
     { "fetchArraySize", NULL, NULL, njsOracleDb_getFetchArraySize,
             njsOracleDb_setFetchArraySize, NULL, napi_default, NULL },
     { "fetchAsBuffer", NULL, NULL, njsOracleDb_getFetchAsBuffer,
             njsOracleDb_setFetchAsBuffer, NULL, napi_default, NULL },
     { "dbObjectAsPojo", NULL, NULL, njsOracleDb_getDbObjectAsPojo,
             njsOracleDb_setDbObjectAsPojo, NULL, napi_default, NULL },
+    { "dbThreadPoolSize", NULL, NULL, njsOracleDb_getDbThreadPoolSize,
+            njsOracleDb_setDbThreadPoolSize, NULL, napi_default, NULL },
     { "fetchAsString", NULL, NULL, njsOracleDb_getFetchAsString,
             njsOracleDb_setFetchAsString, NULL, napi_default, NULL },
     { "lobPrefetchSize", NULL, NULL, njsOracleDb_getLobPrefetchSize,
@@ -333,6 +347,8 @@ static const napi_property_descriptor njsClassProperties[] = {
             napi_default, NULL },
     { "versionSuffix", NULL, NULL, njsOracleDb_getVersionSuffix, NULL, NULL,
             napi_default, NULL },
+    { "_batonStatistics", NULL, NULL, njsOracleDb_getBatonStatistics, NULL,
+            NULL, napi_default, NULL },
     { "_createPool", NULL, njsOracleDb_createPool, NULL, NULL, NULL,
             napi_default, NULL },
     { "_getConnection", NULL, njsOracleDb_getConnection, NULL, NULL, NULL,
@@ -560,13 +576,42 @@ static bool njsOracleDb_createPoolProcessArgs(njsBaton *baton, napi_env env,
 
 //-----------------------------------------------------------------------------
 // njsOracleDb_finalize()
-//   Invoked when the njsOracleDb object is garbage collected.
+//   Invoked when the njsOracleDb object is garbage collected. If work has ever
+// been queued on the thread pool used for database calls, the thread pool may
+// still refer to the instance; the threadsafe function used to post completed
+// work is then released and the instance is freed by its finalize callback
+// once the thread pool has finished all of the work for the instance.
 //-----------------------------------------------------------------------------
 static void njsOracleDb_finalize(napi_env env, void *finalizeData,
         void *finalizeHint)
 {
     njsOracleDb *oracleDb = (njsOracleDb*) finalizeData;
 
+    if (oracleDb->completionFn) {
+        oracleDb->isFinalized = true;
+        napi_release_threadsafe_function(oracleDb->completionFn,
+                napi_tsfn_abort);
+        return;
+    }
+    njsOracleDb_free(oracleDb, env);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsOracleDb_free()
+//   Frees the memory allocated for the instance, including the batons kept
+// for reuse. This must only be called once the thread pool used for database
+// calls no longer refers to the instance.
+//-----------------------------------------------------------------------------
+void njsOracleDb_free(njsOracleDb *oracleDb, napi_env env)
+{
+    njsBaton *baton;
+
+    while (oracleDb->freeBatons) {
+        baton = oracleDb->freeBatons;
+        oracleDb->freeBatons = baton->nextQueued;
+        free(baton);
+    }
     NJS_FREE_AND_CLEAR(oracleDb->connectionClass);
     NJS_FREE_AND_CLEAR(oracleDb->edition);
     NJS_DELETE_REF_AND_CLEAR(oracleDb->jsBaseDbObjectConstructor);
@@ -604,6 +649,52 @@ static napi_value njsOracleDb_getAutoCommit(napi_env env,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsOracleDb_getBatonStatistics()
+//   Get accessor of "_batonStatistics" property. This returns the number of
+// batons that have been allocated and reused by the methods of the classes
+// prepared by this instance and the number currently kept for reuse. It is
+// intended for use by tests and benchmarks.
+//-----------------------------------------------------------------------------
+static napi_value njsOracleDb_getBatonStatistics(napi_env env,
+        napi_callback_info info)
+{
+    njsOracleDb *oracleDb;
+    napi_value stats;
+
+    if (!njsUtils_validateGetter(env, info, (njsBaseInstance**) &oracleDb))
+        return NULL;
+    if (!njsOracleDb_getBatonStatisticsHelper(oracleDb, env, &stats))
+        return NULL;
+    return stats;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsOracleDb_getBatonStatisticsHelper()
+//   Helper for njsOracleDb_getBatonStatistics() which creates the object
+// containing the statistics.
+//-----------------------------------------------------------------------------
+static bool njsOracleDb_getBatonStatisticsHelper(njsOracleDb *oracleDb,
+        napi_env env, napi_value *stats)
+{
+    napi_value temp;
+
+    NJS_CHECK_NAPI(env, napi_create_object(env, stats))
+    NJS_CHECK_NAPI(env, napi_create_double(env,
+            (double) oracleDb->numBatonsAllocated, &temp))
+    NJS_CHECK_NAPI(env, napi_set_named_property(env, *stats, "allocated",
+            temp))
+    NJS_CHECK_NAPI(env, napi_create_double(env,
+            (double) oracleDb->numBatonsReused, &temp))
+    NJS_CHECK_NAPI(env, napi_set_named_property(env, *stats, "reused", temp))
+    NJS_CHECK_NAPI(env, napi_create_uint32(env, oracleDb->numFreeBatons,
+            &temp))
+    NJS_CHECK_NAPI(env, napi_set_named_property(env, *stats, "free", temp))
+    return true;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsOracleDb_getConnection()
 //   Create a standalone connection to the database.
@@ -800,6 +891,21 @@ static napi_value njsOracleDb_getExternalAuth(napi_env env,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsOracleDb_getFetchAhead()
+//   Get accessor of "fetchAhead" property.
+//-----------------------------------------------------------------------------
+static napi_value njsOracleDb_getFetchAhead(napi_env env,
+        napi_callback_info info)
+{
+    njsOracleDb *oracleDb;
+
+    if (!njsUtils_validateGetter(env, info, (njsBaseInstance**) &oracleDb))
+        return NULL;
+    return njsUtils_convertToUnsignedInt(env, oracleDb->fetchAhead);
+}
+
+
 //-----------------------------------------------------------------------------
 // njsOracleDb_getFetchArraySize()
 //   Get accessor of "fetchArraySize" property.
@@ -846,6 +952,21 @@ static napi_value njsOracleDb_getDbObjectAsPojo(napi_env env,
     return njsUtils_convertToBoolean(env, oracleDb->dbObjectAsPojo);
 }
 
+//-----------------------------------------------------------------------------
+// njsOracleDb_getDbThreadPoolSize()
+//   Get accessor of "dbThreadPoolSize" property.
+//-----------------------------------------------------------------------------
+static napi_value njsOracleDb_getDbThreadPoolSize(napi_env env,
+        napi_callback_info info)
+{
+    njsOracleDb *oracleDb;
+
+    if (!njsUtils_validateGetter(env, info, (njsBaseInstance**) &oracleDb))
+        return NULL;
+    return njsUtils_convertToUnsignedInt(env, njsThreadPool_getSize());
+}
+
+
 //-----------------------------------------------------------------------------
 // njsOracleDb_getFetchAsString()
 //   Get accessor of "fetchAsString" property.
@@ -1354,13 +1475,14 @@ bool njsOracleDb_prepareClass(njsOracleDb *oracleDb, napi_env env,
             return false;
         }
 
-        // store the instance on each of the properties as a convenience
-        for (i = 0; i < numProperties; i++)
-            allProperties[i].data = oracleDb;
-
         // populate the properties
         memcpy(allProperties, classDef->properties,
                 sizeof(napi_property_descriptor) * numBaseProperties);
+
+        // store the instance on each of the properties as a convenience; this
+        // is used to find the batons that can be reused by its methods
+        for (i = 0; i < numProperties; i++)
+            allProperties[i].data = oracleDb;
         if (classDef->constants) {
             for (i = 0; classDef->constants[i].name; i++) {
                 tempProperty = &allProperties[numBaseProperties + i];
@@ -1521,6 +1643,26 @@ static napi_value njsOracleDb_setExternalAuth(napi_env env,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsOracleDb_setFetchAhead()
+//   Set accessor of "fetchAhead" property.
+//-----------------------------------------------------------------------------
+static napi_value njsOracleDb_setFetchAhead(napi_env env,
+        napi_callback_info info)
+{
+    njsOracleDb *oracleDb;
+    napi_value value;
+
+    if (!njsUtils_validateSetter(env, info, (njsBaseInstance**) &oracleDb,
+            &value))
+        return NULL;
+    if (!njsUtils_setPropUnsignedInt(env, value, "fetchAhead",
+            &oracleDb->fetchAhead))
+        return NULL;
+    return NULL;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsOracleDb_setFetchArraySize()
 //   Set accessor of "fetchArraySize" property.
@@ -1588,6 +1730,29 @@ static napi_value njsOracleDb_setDbObjectAsPojo(napi_env env,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsOracleDb_setDbThreadPoolSize()
+//   Set accessor of "dbThreadPoolSize" property. The thread pool is shared by
+// the whole process so the value is not stored on the OracleDb instance.
+//-----------------------------------------------------------------------------
+static napi_value njsOracleDb_setDbThreadPoolSize(napi_env env,
+        napi_callback_info info)
+{
+    njsOracleDb *oracleDb;
+    napi_value value;
+    uint32_t size;
+
+    if (!njsUtils_validateSetter(env, info, (njsBaseInstance**) &oracleDb,
+            &value))
+        return NULL;
+    if (!njsUtils_setPropUnsignedInt(env, value, "dbThreadPoolSize", &size))
+        return NULL;
+    njsThreadPool_setSize(size);
+
+    return NULL;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsOracleDb_setFetchAsString()
 //   Set accessor of "fetchAsString" property.
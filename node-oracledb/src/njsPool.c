@@ -141,6 +141,10 @@ static bool njsPool_closeAsync(njsBaton *baton)
         return false;
     }
 
+    // the threads reserved for the pool are no longer required
+    njsThreadPool_addPoolThreads(-(int32_t) pool->numDbThreads);
+    pool->numDbThreads = 0;
+
     return true;
 }
 
@@ -200,6 +204,8 @@ static void njsPool_finalize(napi_env env, void *finalizeData,
         dpiPool_release(pool->handle);
         pool->handle = NULL;
     }
+    if (pool->numDbThreads > 0)
+        njsThreadPool_addPoolThreads(-(int32_t) pool->numDbThreads);
     free(pool);
 }
 
@@ -395,10 +401,14 @@ static bool njsPool_reconfigureAsync(njsBaton *baton)
                 baton->poolIncrement) < 0)
             return njsBaton_setErrorDPI(baton);
 
-        // Update the pool creation parameters.
+        // Update the pool creation parameters and the number of threads
+        // reserved for the pool in the thread pool used for database calls.
         pool->poolMin = baton->poolMin;
         pool->poolMax = baton->poolMax;
         pool->poolIncrement = baton->poolIncrement;
+        njsThreadPool_addPoolThreads((int32_t) pool->poolMax -
+                (int32_t) pool->numDbThreads);
+        pool->numDbThreads = pool->poolMax;
     }
 
     // Other pool parameters: poolPingInterval, poolTimeout, poolMaxPerShard,
@@ -692,5 +702,10 @@ bool njsPool_newFromBaton(njsBaton *baton, napi_env env, napi_value *poolObj)
     pool->stmtCacheSize = baton->stmtCacheSize;
     pool->sodaMetadataCache = baton->sodaMetadataCache;
 
+    // reserve a thread in the thread pool used for database calls for each
+    // connection that the pool may contain
+    pool->numDbThreads = pool->poolMax;
+    njsThreadPool_addPoolThreads((int32_t) pool->numDbThreads);
+
     return true;
 }
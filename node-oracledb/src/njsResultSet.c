@@ -27,36 +27,56 @@
 
 // class methods
 static NJS_NAPI_METHOD(njsResultSet_close);
+static NJS_NAPI_METHOD(njsResultSet_fetchAll);
+static NJS_NAPI_METHOD(njsResultSet_getLazyValue);
 static NJS_NAPI_METHOD(njsResultSet_getRows);
 
 // asynchronous methods
 static NJS_ASYNC_METHOD(njsResultSet_closeAsync);
+static NJS_ASYNC_METHOD(njsResultSet_fetchAllAsync);
 static NJS_ASYNC_METHOD(njsResultSet_getRowsAsync);
 
 // post asynchronous methods
+static NJS_ASYNC_POST_METHOD(njsResultSet_fetchAllPostAsync);
 static NJS_ASYNC_POST_METHOD(njsResultSet_getRowsPostAsync);
 
 // processing arguments methods
+static NJS_PROCESS_ARGS_METHOD(njsResultSet_fetchAllProcessArgs);
 static NJS_PROCESS_ARGS_METHOD(njsResultSet_getRowsProcessArgs);
 
 // getters
+static NJS_NAPI_GETTER(njsResultSet_getFetchAhead);
 static NJS_NAPI_GETTER(njsResultSet_getFetchArraySize);
+static NJS_NAPI_GETTER(njsResultSet_getInternStatistics);
 static NJS_NAPI_GETTER(njsResultSet_getMetaData);
 static NJS_NAPI_GETTER(njsResultSet_getNestedCursorIndices);
+static NJS_NAPI_GETTER(njsResultSet_getOutFormat);
 
 // finalize
 static NJS_NAPI_FINALIZE(njsResultSet_finalize);
+static NJS_NAPI_FINALIZE(njsResultSet_finalizeJsonText);
+static NJS_NAPI_FINALIZE(njsResultSet_finalizeLazyRows);
 
 // properties defined by the class
 static const napi_property_descriptor njsClassProperties[] = {
     { "_close", NULL, njsResultSet_close, NULL, NULL, NULL,
             napi_default, NULL },
+    { "_fetchAll", NULL, njsResultSet_fetchAll, NULL, NULL, NULL,
+            napi_default, NULL },
+    { "_getLazyValue", NULL, njsResultSet_getLazyValue, NULL, NULL, NULL,
+            napi_default, NULL },
     { "_getRows", NULL, njsResultSet_getRows, NULL, NULL, NULL,
             napi_default, NULL },
+    { "_fetchAhead", NULL, NULL, njsResultSet_getFetchAhead, NULL, NULL,
+            napi_default, NULL },
     { "_fetchArraySize", NULL, NULL, njsResultSet_getFetchArraySize, NULL,
             NULL, napi_default, NULL },
     { "_nestedCursorIndices", NULL, NULL, njsResultSet_getNestedCursorIndices,
             NULL, NULL, napi_default, NULL },
+    { "_outFormat", NULL, NULL, njsResultSet_getOutFormat, NULL, NULL,
+            napi_default, NULL },
+    { "internStatistics", NULL, NULL, njsResultSet_getInternStatistics,
+            NULL, NULL, napi_default, NULL },
     { "metaData", NULL, NULL, njsResultSet_getMetaData, NULL, NULL,
             napi_default, NULL },
     { NULL, NULL, NULL, NULL, NULL, NULL, napi_default, NULL }
@@ -69,12 +89,301 @@ const njsClassDef njsClassDefResultSet = {
 };
 
 // other methods used internally
+static bool njsResultSet_appendJsonText(njsResultSet *rs, njsBaton *baton);
+static bool njsResultSet_bufferRows(njsResultSet *rs, njsBaton *baton);
+static bool njsResultSet_canBufferRows(njsResultSet *rs);
 static bool njsResultSet_createBaton(napi_env env, napi_callback_info info,
         size_t numArgs, napi_value *args, njsBaton **baton);
-static bool njsResultSet_getRowsHelper(njsResultSet *rs, njsBaton *baton,
-        bool *moreRows);
+static bool njsResultSet_createLazyRows(njsResultSet *rs, napi_value rsObj,
+        njsBaton *baton, napi_env env, napi_value *rows);
+static bool njsResultSet_getRowConstructor(njsResultSet *rs,
+        napi_value rsObj, napi_env env, napi_value *constructor);
 static bool njsResultSet_makeUniqueColumnNames(napi_env env, njsBaton *baton,
         njsVariable *queryVars, uint32_t numQueryVars);
+static char *njsResultSet_reserveJsonText(njsBaton *baton, size_t numBytes);
+static bool njsResultSet_saveInternStats(njsResultSet *rs, napi_env env);
+static size_t njsResultSet_writeJsonBuffer(char *ptr, const char *value,
+        uint32_t valueLength);
+static size_t njsResultSet_writeJsonDate(char *ptr, double value);
+static size_t njsResultSet_writeJsonNumber(char *ptr, double value);
+static size_t njsResultSet_writeJsonString(char *ptr, const char *value,
+        uint32_t valueLength);
+
+//-----------------------------------------------------------------------------
+// njsResultSet_appendJsonText()
+//   Append the rows that were just fetched into the query variables to the
+// JSON text on the baton, as one object for each row with the column names as
+// keys. For outFormat OUT_FORMAT_JSON the objects are separated by commas and
+// the enclosing brackets are added by the JavaScript layer; for
+// OUT_FORMAT_NDJSON each object is followed by a newline. The values are
+// written in the same way that JSON.stringify() writes the values that would
+// otherwise be returned for each column.
+//-----------------------------------------------------------------------------
+static bool njsResultSet_appendJsonText(njsResultSet *rs, njsBaton *baton)
+{
+    size_t initialLength = baton->jsonTextLength, numBytes;
+    uint32_t row, col;
+    njsVariable *var;
+    dpiData *data;
+    char *ptr;
+
+    // only columns containing scalar values can be written
+    for (col = 0; col < rs->numQueryVars; col++) {
+        switch (rs->queryVars[col].nativeTypeNum) {
+            case DPI_NATIVE_TYPE_INT64:
+            case DPI_NATIVE_TYPE_FLOAT:
+            case DPI_NATIVE_TYPE_DOUBLE:
+            case DPI_NATIVE_TYPE_BYTES:
+            case DPI_NATIVE_TYPE_BOOLEAN:
+                break;
+            default:
+                return njsBaton_setError(baton, errJsonTextNotSupported,
+                        col + 1);
+        }
+    }
+
+    for (row = 0; row < baton->rowsFetched; row++) {
+        for (col = 0; col < rs->numQueryVars; col++) {
+            var = &rs->queryVars[col];
+            data = &var->buffer->dpiVarData[baton->bufferRowIndex + row];
+
+            // reserve enough space for the separators, the key and the
+            // value; escaped characters take up to 6 bytes each
+            numBytes = (size_t) var->nameLength * 6 +
+                    NJS_JSON_TEXT_MAX_SCALAR_SIZE;
+            if (!data->isNull && var->nativeTypeNum == DPI_NATIVE_TYPE_BYTES)
+                numBytes += (size_t) data->value.asBytes.length * 6;
+            ptr = njsResultSet_reserveJsonText(baton, numBytes);
+            if (!ptr)
+                return false;
+
+            // write the separator and the key
+            if (col > 0) {
+                *ptr++ = ',';
+            } else {
+                if (rs->outFormat == NJS_ROWS_JSON &&
+                        baton->jsonTextLength > 0)
+                    *ptr++ = ',';
+                *ptr++ = '{';
+            }
+            ptr += njsResultSet_writeJsonString(ptr, var->name,
+                    var->nameLength);
+            *ptr++ = ':';
+
+            // write the value
+            if (data->isNull || (var->nativeTypeNum == DPI_NATIVE_TYPE_BYTES &&
+                    data->value.asBytes.length == 0)) {
+                memcpy(ptr, "null", 4);
+                ptr += 4;
+            } else {
+                switch (var->nativeTypeNum) {
+                    case DPI_NATIVE_TYPE_INT64:
+                        ptr += njsResultSet_writeJsonNumber(ptr,
+                                (double) data->value.asInt64);
+                        break;
+                    case DPI_NATIVE_TYPE_FLOAT:
+                        ptr += njsResultSet_writeJsonNumber(ptr,
+                                data->value.asFloat);
+                        break;
+                    case DPI_NATIVE_TYPE_DOUBLE:
+                        if (var->varTypeNum == DPI_ORACLE_TYPE_TIMESTAMP_LTZ ||
+                                var->varTypeNum == DPI_ORACLE_TYPE_TIMESTAMP ||
+                                var->varTypeNum ==
+                                        DPI_ORACLE_TYPE_TIMESTAMP_TZ ||
+                                var->varTypeNum == DPI_ORACLE_TYPE_DATE) {
+                            ptr += njsResultSet_writeJsonDate(ptr,
+                                    data->value.asDouble);
+                        } else {
+                            ptr += njsResultSet_writeJsonNumber(ptr,
+                                    data->value.asDouble);
+                        }
+                        break;
+                    case DPI_NATIVE_TYPE_BYTES:
+                        if (var->varTypeNum == DPI_ORACLE_TYPE_RAW ||
+                                var->varTypeNum == DPI_ORACLE_TYPE_LONG_RAW) {
+                            ptr += njsResultSet_writeJsonBuffer(ptr,
+                                    data->value.asBytes.ptr,
+                                    data->value.asBytes.length);
+                        } else {
+                            ptr += njsResultSet_writeJsonString(ptr,
+                                    data->value.asBytes.ptr,
+                                    data->value.asBytes.length);
+                        }
+                        break;
+                    case DPI_NATIVE_TYPE_BOOLEAN:
+                        if (data->value.asBoolean) {
+                            memcpy(ptr, "true", 4);
+                            ptr += 4;
+                        } else {
+                            memcpy(ptr, "false", 5);
+                            ptr += 5;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            // terminate the object after the last column
+            if (col == rs->numQueryVars - 1) {
+                *ptr++ = '}';
+                if (rs->outFormat == NJS_ROWS_NDJSON)
+                    *ptr++ = '\n';
+            }
+            baton->jsonTextLength = (size_t) (ptr - baton->jsonText);
+        }
+    }
+    baton->fetchMemoryUsed += baton->jsonTextLength - initialLength;
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_bufferRows()
+//   Append the rows that were just fetched into the query variables to the
+// buffers on the baton, one for each column, so that another fetch can be
+// performed without first converting the rows to JavaScript. Byte strings
+// are copied into a block of memory allocated for each fetch since the
+// ODPI-C buffers are reused by the next fetch. The block is recorded for each
+// row of binary columns so that the Buffers created for them can refer to the
+// block instead of making another copy.
+//-----------------------------------------------------------------------------
+static bool njsResultSet_bufferRows(njsResultSet *rs, njsBaton *baton)
+{
+    uint32_t col, row, numRows, numAllocated, numBlocksAllocated;
+    njsBlock *block, **tempBlocks;
+    njsVariableBuffer *buffer;
+    dpiData *data, *tempData;
+    uint64_t numBytes = 0;
+    njsVariable *var;
+    char *ptr = NULL;
+
+    // allocate the buffers, if needed
+    numRows = baton->rowsFetched;
+    if (!baton->fetchBuffers) {
+        baton->fetchBuffers = calloc(rs->numQueryVars,
+                sizeof(njsVariableBuffer));
+        if (!baton->fetchBuffers)
+            return njsBaton_setError(baton, errInsufficientMemory);
+        baton->numFetchBuffers = rs->numQueryVars;
+    }
+
+    // grow the arrays of data in the buffers, if needed
+    buffer = &baton->fetchBuffers[0];
+    if (buffer->numElements + numRows > baton->fetchBuffersAllocated) {
+        numAllocated = baton->fetchBuffersAllocated * 2;
+        if (numAllocated < buffer->numElements + numRows)
+            numAllocated = buffer->numElements + numRows;
+        for (col = 0; col < rs->numQueryVars; col++) {
+            buffer = &baton->fetchBuffers[col];
+            tempData = realloc(buffer->dpiVarData,
+                    numAllocated * sizeof(dpiData));
+            if (!tempData)
+                return njsBaton_setError(baton, errInsufficientMemory);
+            buffer->dpiVarData = tempData;
+            var = &rs->queryVars[col];
+            if (var->varTypeNum != DPI_ORACLE_TYPE_RAW &&
+                    var->varTypeNum != DPI_ORACLE_TYPE_LONG_RAW)
+                continue;
+            tempBlocks = realloc(buffer->blocks,
+                    numAllocated * sizeof(njsBlock*));
+            if (!tempBlocks)
+                return njsBaton_setError(baton, errInsufficientMemory);
+            buffer->blocks = tempBlocks;
+        }
+        baton->fetchMemoryUsed += (uint64_t) rs->numQueryVars *
+                (numAllocated - baton->fetchBuffersAllocated) *
+                sizeof(dpiData);
+        baton->fetchBuffersAllocated = numAllocated;
+    }
+
+    // determine the amount of memory needed for byte strings
+    for (col = 0; col < rs->numQueryVars; col++) {
+        var = &rs->queryVars[col];
+        if (var->nativeTypeNum != DPI_NATIVE_TYPE_BYTES)
+            continue;
+        data = &var->buffer->dpiVarData[baton->bufferRowIndex];
+        for (row = 0; row < numRows; row++) {
+            if (!data[row].isNull)
+                numBytes += data[row].value.asBytes.length;
+        }
+    }
+
+    // allocate a block of memory for the byte strings, if needed
+    block = NULL;
+    if (numBytes > 0) {
+        if (baton->numFetchBlocks == baton->fetchBlocksAllocated) {
+            numBlocksAllocated = baton->fetchBlocksAllocated + 16;
+            tempBlocks = realloc(baton->fetchBlocks,
+                    numBlocksAllocated * sizeof(njsBlock*));
+            if (!tempBlocks)
+                return njsBaton_setError(baton, errInsufficientMemory);
+            baton->fetchBlocks = tempBlocks;
+            baton->fetchBlocksAllocated = numBlocksAllocated;
+        }
+        block = njsUtils_createBlock(numBytes);
+        if (!block)
+            return njsBaton_setError(baton, errInsufficientMemory);
+        baton->fetchBlocks[baton->numFetchBlocks++] = block;
+        baton->fetchMemoryUsed += numBytes;
+        ptr = block->data;
+    }
+
+    // copy the data into the buffers
+    for (col = 0; col < rs->numQueryVars; col++) {
+        var = &rs->queryVars[col];
+        buffer = &baton->fetchBuffers[col];
+        data = &buffer->dpiVarData[buffer->numElements];
+        memcpy(data, &var->buffer->dpiVarData[baton->bufferRowIndex],
+                numRows * sizeof(dpiData));
+        if (buffer->blocks) {
+            for (row = 0; row < numRows; row++)
+                buffer->blocks[buffer->numElements + row] = block;
+        }
+        buffer->numElements += numRows;
+        if (var->nativeTypeNum != DPI_NATIVE_TYPE_BYTES)
+            continue;
+        for (row = 0; row < numRows; row++) {
+            if (data[row].isNull || data[row].value.asBytes.length == 0)
+                continue;
+            memcpy(ptr, data[row].value.asBytes.ptr,
+                    data[row].value.asBytes.length);
+            data[row].value.asBytes.ptr = ptr;
+            ptr += data[row].value.asBytes.length;
+        }
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_canBufferRows()
+//   Returns whether the rows fetched into the query variables can be copied
+// into buffers. This is only possible if all of the columns contain values
+// that do not refer to other resources (such as LOBs and objects).
+//-----------------------------------------------------------------------------
+static bool njsResultSet_canBufferRows(njsResultSet *rs)
+{
+    uint32_t i;
+
+    for (i = 0; i < rs->numQueryVars; i++) {
+        switch (rs->queryVars[i].nativeTypeNum) {
+            case DPI_NATIVE_TYPE_INT64:
+            case DPI_NATIVE_TYPE_FLOAT:
+            case DPI_NATIVE_TYPE_DOUBLE:
+            case DPI_NATIVE_TYPE_BYTES:
+            case DPI_NATIVE_TYPE_BOOLEAN:
+                break;
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
 
 //-----------------------------------------------------------------------------
 // njsResultSet_close()
@@ -90,6 +399,10 @@ static napi_value njsResultSet_close(napi_env env, napi_callback_info info)
     if (!njsResultSet_createBaton(env, info, 0, NULL, &baton))
         return NULL;
     rs = (njsResultSet*) baton->callingInstance;
+    if (!rs->isNested && !njsResultSet_saveInternStats(rs, env)) {
+        njsBaton_free(baton, env);
+        return NULL;
+    }
     baton->dpiStmtHandle = rs->handle;
     rs->handle = NULL;
     return njsBaton_queueWork(baton, env, "Close", njsResultSet_closeAsync,
@@ -151,6 +464,397 @@ bool njsResultSet_createBaton(napi_env env, napi_callback_info info,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsResultSet_createLazyRows()
+//   Creates the rows returned to JS when the execute() option lazyRows is
+// set. The buffered rows are transferred from the baton to a structure that
+// is wrapped in an external value, and the JavaScript layer creates one
+// object for each row that converts the values using that structure when
+// they are first accessed. The structure (and the blocks containing the byte
+// strings) is freed once the external value has been garbage collected,
+// which occurs once all of the rows created from it are no longer used.
+//-----------------------------------------------------------------------------
+static bool njsResultSet_createLazyRows(njsResultSet *rs, napi_value rsObj,
+        njsBaton *baton, napi_env env, napi_value *rows)
+{
+    napi_value args[3], name, fn;
+    njsLazyRows *lazyRows;
+    njsVariable *var;
+    uint32_t col;
+
+    // allocate the structure and populate the type information needed to
+    // convert the values
+    lazyRows = calloc(1, sizeof(njsLazyRows));
+    if (!lazyRows)
+        return njsUtils_throwError(env, errInsufficientMemory);
+    lazyRows->queryVars = calloc(rs->numQueryVars, sizeof(njsVariable));
+    if (!lazyRows->queryVars) {
+        free(lazyRows);
+        return njsUtils_throwError(env, errInsufficientMemory);
+    }
+    lazyRows->oracleDb = baton->oracleDb;
+    lazyRows->numQueryVars = rs->numQueryVars;
+    for (col = 0; col < rs->numQueryVars; col++) {
+        var = &lazyRows->queryVars[col];
+        var->varTypeNum = rs->queryVars[col].varTypeNum;
+        var->nativeTypeNum = rs->queryVars[col].nativeTypeNum;
+        var->maxSize = rs->queryVars[col].maxSize;
+    }
+
+    // transfer the buffered rows and the blocks of memory containing their
+    // byte strings
+    lazyRows->buffers = baton->fetchBuffers;
+    lazyRows->numBlocks = baton->numFetchBlocks;
+    lazyRows->blocks = baton->fetchBlocks;
+    baton->fetchBuffers = NULL;
+    baton->numFetchBuffers = 0;
+    baton->fetchBlocks = NULL;
+    baton->numFetchBlocks = 0;
+    baton->fetchBlocksAllocated = 0;
+    if (napi_create_external(env, lazyRows, njsResultSet_finalizeLazyRows,
+            NULL, &args[0]) != napi_ok) {
+        njsResultSet_finalizeLazyRows(env, lazyRows, NULL);
+        return njsUtils_genericThrowError(env);
+    }
+
+    // call into JavaScript to create the rows, passing the number of rows and
+    // the (unique) names of the columns
+    NJS_CHECK_NAPI(env, napi_create_uint32(env, baton->rowsFetched, &args[1]))
+    NJS_CHECK_NAPI(env, napi_create_array_with_length(env, rs->numQueryVars,
+            &args[2]))
+    for (col = 0; col < rs->numQueryVars; col++) {
+        var = &rs->queryVars[col];
+        NJS_CHECK_NAPI(env, napi_create_string_utf8(env, var->name,
+                var->nameLength, &name))
+        NJS_CHECK_NAPI(env, napi_set_element(env, args[2], col, name))
+    }
+    NJS_CHECK_NAPI(env, napi_get_named_property(env, rsObj, "_createLazyRows",
+            &fn))
+    NJS_CHECK_NAPI(env, napi_call_function(env, rsObj, fn, 3, args, rows))
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_createRows()
+//   Creates the rows returned to JS from the rows that were fetched into the
+// query variables (or into the buffers, if specified), in the format
+// specified by the outFormat of the result set. This is used for fetches made
+// by the result set as well as for the first fetch made when a query is
+// executed.
+//-----------------------------------------------------------------------------
+bool njsResultSet_createRows(njsResultSet *rs, napi_value rsObj,
+        njsVariableBuffer *buffers, njsBaton *baton, napi_env env,
+        napi_value *rows)
+{
+    napi_value rowObj, colObj, constructor;
+    njsVariableBuffer *buffer;
+    uint32_t row, col, i;
+    njsVariable *var;
+
+    // if outFormat is JSON or NDJSON, the rows were written as JSON text by
+    // the worker thread; the text is transferred to a Buffer
+    if (rs->outFormat == NJS_ROWS_JSON || rs->outFormat == NJS_ROWS_NDJSON) {
+        if (baton->jsonTextLength == 0) {
+            NJS_CHECK_NAPI(env, napi_create_buffer(env, 0, NULL, rows))
+        } else {
+            NJS_CHECK_NAPI(env, napi_create_external_buffer(env,
+                    baton->jsonTextLength, baton->jsonText,
+                    njsResultSet_finalizeJsonText, NULL, rows))
+            baton->jsonText = NULL;
+            baton->jsonTextLength = 0;
+            baton->jsonTextAllocated = 0;
+        }
+
+    // if lazy rows were requested and the rows were buffered, the values are
+    // converted only when they are accessed
+    } else if (rs->lazyRows && buffers && rs->outFormat != NJS_ROWS_COLUMNS) {
+        if (!njsResultSet_createLazyRows(rs, rsObj, baton, env, rows))
+            return false;
+
+    // if outFormat is COLUMNS, create an array containing one object for each
+    // column, populated with the values of all of the rows that were fetched
+    } else if (rs->outFormat == NJS_ROWS_COLUMNS) {
+        NJS_CHECK_NAPI(env, napi_create_array_with_length(env,
+                rs->numQueryVars, rows))
+        for (col = 0; col < rs->numQueryVars; col++) {
+            var = &rs->queryVars[col];
+            buffer = (buffers) ? &buffers[col] : var->buffer;
+            if (!njsVariable_getColumnValues(var, rs->conn, buffer,
+                    baton->rowsFetched, baton, env, &colObj))
+                return false;
+            NJS_CHECK_NAPI(env, napi_set_element(env, *rows, col, colObj))
+        }
+
+    // if outFormat is OBJECT, create an array containing one object for each
+    // row, constructed in a single call with all of the column values so that
+    // each row has the same shape
+    } else if (rs->outFormat == NJS_ROWS_OBJECT) {
+        if (!njsResultSet_getRowConstructor(rs, rsObj, env, &constructor))
+            return false;
+        NJS_CHECK_NAPI(env, napi_create_array_with_length(env,
+                baton->rowsFetched, rows))
+        for (row = 0; row < baton->rowsFetched; row++) {
+            for (col = 0; col < rs->numQueryVars; col++) {
+                var = &rs->queryVars[col];
+                buffer = (buffers) ? &buffers[col] : var->buffer;
+                if (!njsVariable_getScalarValue(var, rs->conn, buffer, row,
+                        baton, env, &rs->rowValues[col]))
+                    return false;
+            }
+            NJS_CHECK_NAPI(env, napi_new_instance(env, constructor,
+                    rs->numQueryVars, rs->rowValues, &rowObj))
+            NJS_CHECK_NAPI(env, napi_set_element(env, *rows, row, rowObj))
+        }
+
+    // otherwise, create an array containing one array for each row
+    } else {
+        NJS_CHECK_NAPI(env, napi_create_array_with_length(env,
+                baton->rowsFetched, rows))
+        for (row = 0; row < baton->rowsFetched; row++) {
+            NJS_CHECK_NAPI(env, napi_create_array_with_length(env,
+                    rs->numQueryVars, &rowObj))
+            for (col = 0; col < rs->numQueryVars; col++) {
+                var = &rs->queryVars[col];
+                buffer = (buffers) ? &buffers[col] : var->buffer;
+                if (!njsVariable_getScalarValue(var, rs->conn, buffer, row,
+                        baton, env, &colObj))
+                    return false;
+                NJS_CHECK_NAPI(env, napi_set_element(env, rowObj, col,
+                        colObj))
+            }
+            NJS_CHECK_NAPI(env, napi_set_element(env, *rows, row, rowObj))
+        }
+    }
+
+    // clear variables if result set was closed
+    if (!rs->handle && !rs->isNested) {
+        if (!njsResultSet_saveInternStats(rs, env))
+            return false;
+        for (i = 0; i < rs->numQueryVars; i++)
+            njsVariable_free(&rs->queryVars[i]);
+        free(rs->queryVars);
+        rs->queryVars = NULL;
+        rs->numQueryVars = 0;
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_fetchAll()
+//   Fetch all of the rows remaining in the result set (or as many as the
+// memory limit permits) in a single call.
+//
+// PARAMETERS
+//   - number of rows to fetch with each fetch
+//   - max number of rows to fetch in total (0 for all rows)
+//   - should the result set be closed after all rows have been fetched?
+//   - max amount of memory (in bytes) to use for buffering rows
+//-----------------------------------------------------------------------------
+static napi_value njsResultSet_fetchAll(napi_env env, napi_callback_info info)
+{
+    napi_value args[4];
+    njsBaton *baton;
+
+    if (!njsResultSet_createBaton(env, info, 4, args, &baton))
+        return NULL;
+    if (!njsResultSet_fetchAllProcessArgs(baton, env, args)) {
+        njsBaton_reportError(baton, env);
+        return NULL;
+    }
+    return njsBaton_queueWork(baton, env, "FetchAll",
+            njsResultSet_fetchAllAsync, njsResultSet_fetchAllPostAsync);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_fetchAllAsync()
+//   Worker function for njsResultSet_fetchAll(). Rows are fetched repeatedly
+// and buffered until the result set is exhausted, the maximum number of rows
+// has been fetched or the memory limit has been reached. If any of the
+// columns contain values that cannot be copied (such as LOBs and objects),
+// only a single fetch is performed. When outFormat is JSON or NDJSON, the
+// rows are written as JSON text after each fetch instead of being buffered.
+// The flag indicating if more rows are available is left unchanged when the
+// maximum number of rows is reached so that the result set can continue to be
+// used by those fetching rows ahead of time.
+//-----------------------------------------------------------------------------
+static bool njsResultSet_fetchAllAsync(njsBaton *baton)
+{
+    njsResultSet *rs = (njsResultSet*) baton->callingInstance;
+    uint32_t fetchArraySize, totalRows = 0;
+    bool canBuffer, jsonText, done = false, ok;
+
+    // fetch rows until no more rows are required or can be buffered
+    jsonText = (rs->outFormat == NJS_ROWS_JSON ||
+            rs->outFormat == NJS_ROWS_NDJSON);
+    canBuffer = !jsonText && njsResultSet_canBufferRows(rs);
+    while (1) {
+        fetchArraySize = baton->fetchArraySize;
+        if (baton->maxRows > 0 && baton->maxRows - totalRows < fetchArraySize)
+            fetchArraySize = baton->maxRows - totalRows;
+        ok = njsResultSet_fetchRows(rs->conn, rs->handle, rs->queryVars,
+                rs->numQueryVars, fetchArraySize, &rs->varsDefined, baton,
+                &baton->moreRows);
+        if (ok && jsonText) {
+            ok = njsResultSet_appendJsonText(rs, baton);
+        } else if (ok && canBuffer) {
+            ok = njsResultSet_bufferRows(rs, baton);
+        }
+        if (!ok)
+            break;
+        totalRows += baton->rowsFetched;
+        done = (!baton->moreRows ||
+                (baton->maxRows > 0 && totalRows == baton->maxRows));
+        if ((!canBuffer && !jsonText) || done ||
+                baton->fetchMemoryUsed >= baton->fetchMemoryLimit)
+            break;
+    }
+
+    // the buffered rows (or the JSON text) are used instead of the rows in
+    // the query variables
+    if (ok && (canBuffer || jsonText)) {
+        baton->rowsFetched = totalRows;
+        baton->bufferRowIndex = 0;
+    }
+
+    // close the result set if requested once all rows have been fetched or
+    // an error has taken place
+    if (baton->closeOnAllRowsFetched && (!ok || done)) {
+        dpiStmt_release(rs->handle);
+        rs->handle = NULL;
+    }
+
+    return ok;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_fetchAllPostAsync()
+//   Defines the value returned to JS.
+//-----------------------------------------------------------------------------
+static bool njsResultSet_fetchAllPostAsync(njsBaton *baton, napi_env env,
+        napi_value *result)
+{
+    njsResultSet *rs = (njsResultSet*) baton->callingInstance;
+    napi_value rows, numRows, moreRows;
+
+    // set JavaScript values to simplify creation of returned objects
+    if (!njsBaton_setJsValues(baton, env))
+        return false;
+
+    // create the rows, from the buffers if rows were buffered
+    if (!njsResultSet_createRows(rs, baton->jsCallingObj, baton->fetchBuffers,
+            baton, env, &rows))
+        return false;
+
+    // return an object containing the rows, the number of rows and whether
+    // more rows remain
+    NJS_CHECK_NAPI(env, napi_create_object(env, result))
+    NJS_CHECK_NAPI(env, napi_set_named_property(env, *result, "rows", rows))
+    NJS_CHECK_NAPI(env, napi_create_uint32(env, baton->rowsFetched, &numRows))
+    NJS_CHECK_NAPI(env, napi_set_named_property(env, *result, "numRows",
+            numRows))
+    NJS_CHECK_NAPI(env, napi_get_boolean(env, baton->moreRows, &moreRows))
+    NJS_CHECK_NAPI(env, napi_set_named_property(env, *result, "moreRows",
+            moreRows))
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_fetchAllProcessArgs()
+//   Processes the arguments provided by the caller and place them on the
+// baton.
+//-----------------------------------------------------------------------------
+static bool njsResultSet_fetchAllProcessArgs(njsBaton *baton, napi_env env,
+        napi_value *args)
+{
+    njsResultSet *rs = (njsResultSet*) baton->callingInstance;
+
+    if (!njsUtils_getUnsignedIntArg(env, args, 0, &baton->fetchArraySize))
+        return false;
+    if (baton->fetchArraySize == 0)
+        return njsUtils_throwError(env, errInvalidParameterValue, 1);
+    if (!njsUtils_getUnsignedIntArg(env, args, 1, &baton->maxRows))
+        return false;
+    if (!njsUtils_getBoolArg(env, args, 2, &baton->closeOnAllRowsFetched))
+        return false;
+    if (!njsUtils_getUnsignedIntArg(env, args, 3, &baton->fetchMemoryLimit))
+        return false;
+    baton->extendedMetaData = rs->extendedMetaData;
+    baton->outFormat = rs->outFormat;
+    baton->fetchAhead = rs->fetchAhead;
+    baton->lazyRows = rs->lazyRows;
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_fetchRows()
+//   Fetch rows from the statement into the query variables and indicate if
+// more rows are available to fetch or not. The query variables are created
+// and defined first, if necessary. This is used by result sets as well as for
+// the first fetch made when a query is executed.
+//-----------------------------------------------------------------------------
+bool njsResultSet_fetchRows(njsConnection *conn, dpiStmt *handle,
+        njsVariable *queryVars, uint32_t numQueryVars,
+        uint32_t fetchArraySize, bool *varsDefined, njsBaton *baton,
+        bool *moreRows)
+{
+    njsVariable *var;
+    int tempMoreRows;
+    uint32_t i;
+
+    // create ODPI-C variables, if necessary
+    for (i = 0; i < numQueryVars; i++) {
+        var = &queryVars[i];
+        if (var->dpiVarHandle && var->maxArraySize >= fetchArraySize)
+            continue;
+        *varsDefined = false;
+        if (var->dpiVarHandle) {
+            if (dpiVar_release(var->dpiVarHandle) < 0)
+                return njsBaton_setErrorDPI(baton);
+            var->dpiVarHandle = NULL;
+        }
+        if (dpiConn_newVar(conn->handle, var->varTypeNum,
+                var->nativeTypeNum, fetchArraySize, var->maxSize, 1, 0,
+                var->dpiObjectTypeHandle, &var->dpiVarHandle,
+                &var->buffer->dpiVarData) < 0)
+            return njsBaton_setErrorDPI(baton);
+        var->maxArraySize = fetchArraySize;
+    }
+
+    // perform define, if necessary
+    if (!*varsDefined) {
+        for (i = 0; i < numQueryVars; i++) {
+            var = &queryVars[i];
+            if (dpiStmt_define(handle, i + 1, var->dpiVarHandle) < 0)
+                return njsBaton_setErrorDPI(baton);
+        }
+        *varsDefined = true;
+    }
+
+    // set fetch array size as requested
+    if (dpiStmt_setFetchArraySize(handle, fetchArraySize) < 0)
+        return njsBaton_setErrorDPI(baton);
+
+    // perform fetch
+    if (dpiStmt_fetchRows(handle, fetchArraySize, &baton->bufferRowIndex,
+            &baton->rowsFetched, &tempMoreRows) < 0)
+        return njsBaton_setErrorDPI(baton);
+    *moreRows = (bool) tempMoreRows;
+
+    return njsVariable_process(queryVars, numQueryVars, baton->rowsFetched,
+            baton);
+}
+
+
 //-----------------------------------------------------------------------------
 // njsResultSet_finalize()
 //   Invoked when the njsResultSet object is garbage collected.
@@ -164,10 +868,67 @@ static void njsResultSet_finalize(napi_env env, void *finalizeData,
         dpiStmt_release(rs->handle);
         rs->handle = NULL;
     }
+    NJS_DELETE_REF_AND_CLEAR(rs->jsRowConstructor);
+    NJS_DELETE_REF_AND_CLEAR(rs->jsInternStats);
+    NJS_FREE_AND_CLEAR(rs->rowValues);
     free(rs);
 }
 
 
+//-----------------------------------------------------------------------------
+// njsResultSet_finalizeJsonText()
+//   Invoked when the Buffer containing rows fetched as JSON text is garbage
+// collected.
+//-----------------------------------------------------------------------------
+static void njsResultSet_finalizeJsonText(napi_env env, void *finalizeData,
+        void *finalizeHint)
+{
+    free(finalizeData);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_finalizeLazyRows()
+//   Invoked when the external value wrapping lazy rows is garbage collected.
+//-----------------------------------------------------------------------------
+static void njsResultSet_finalizeLazyRows(napi_env env, void *finalizeData,
+        void *finalizeHint)
+{
+    njsLazyRows *lazyRows = (njsLazyRows*) finalizeData;
+    uint32_t i;
+
+    if (lazyRows->buffers) {
+        for (i = 0; i < lazyRows->numQueryVars; i++) {
+            NJS_FREE_AND_CLEAR(lazyRows->buffers[i].dpiVarData);
+            NJS_FREE_AND_CLEAR(lazyRows->buffers[i].blocks);
+        }
+        free(lazyRows->buffers);
+    }
+    if (lazyRows->blocks) {
+        for (i = 0; i < lazyRows->numBlocks; i++)
+            njsUtils_releaseBlock(lazyRows->blocks[i]);
+        free(lazyRows->blocks);
+    }
+    free(lazyRows->queryVars);
+    free(lazyRows);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_getFetchAhead()
+//   Get accessor of "_fetchAhead" property.
+//-----------------------------------------------------------------------------
+static napi_value njsResultSet_getFetchAhead(napi_env env,
+        napi_callback_info info)
+{
+    njsResultSet *rs;
+
+    if (!njsUtils_validateGetter(env, info, (njsBaseInstance**) &rs))
+        return NULL;
+    return njsUtils_convertToUnsignedInt(env, rs->fetchAhead);
+}
+
+
 //-----------------------------------------------------------------------------
 // njsResultSet_getFetchArraySize()
 //   Get accessor of "_fetchArraySize" property.
@@ -183,6 +944,87 @@ static napi_value njsResultSet_getFetchArraySize(napi_env env,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsResultSet_getInternStatistics()
+//   Get accessor of "internStatistics" property. Once the result set has been
+// closed, the statistics saved at that time are returned.
+//-----------------------------------------------------------------------------
+static napi_value njsResultSet_getInternStatistics(napi_env env,
+        napi_callback_info info)
+{
+    napi_value stats;
+    njsResultSet *rs;
+
+    if (!njsUtils_validateGetter(env, info, (njsBaseInstance**) &rs))
+        return NULL;
+    if (rs->queryVars) {
+        if (!njsVariable_getInternStats(rs->queryVars, rs->numQueryVars, env,
+                &stats))
+            return NULL;
+        return stats;
+    }
+    if (!rs->jsInternStats)
+        return NULL;
+    if (napi_get_reference_value(env, rs->jsInternStats,
+            &stats) != napi_ok) {
+        njsUtils_genericThrowError(env);
+        return NULL;
+    }
+    return stats;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_getLazyValue()
+//   Converts a single value of the lazy rows to JavaScript. This does not
+// require the result set to be open since the lazy rows retain all of the
+// data they need; no baton is needed either since only values that could be
+// buffered are converted.
+//
+// PARAMETERS
+//   - external value wrapping the lazy rows
+//   - index of the row
+//   - index of the column
+//-----------------------------------------------------------------------------
+static napi_value njsResultSet_getLazyValue(napi_env env,
+        napi_callback_info info)
+{
+    napi_value args[3], dateConstructor, value;
+    njsLazyRows *lazyRows;
+    uint32_t row, col;
+    njsResultSet *rs;
+
+    if (!njsUtils_validateArgs(env, info, 3, args, NULL,
+            (njsBaseInstance**) &rs))
+        return NULL;
+    if (napi_get_value_external(env, args[0],
+            (void**) &lazyRows) != napi_ok) {
+        njsUtils_genericThrowError(env);
+        return NULL;
+    }
+    if (!njsUtils_getUnsignedIntArg(env, args, 1, &row))
+        return NULL;
+    if (!njsUtils_getUnsignedIntArg(env, args, 2, &col))
+        return NULL;
+    if (col >= lazyRows->numQueryVars ||
+            row >= lazyRows->buffers[col].numElements) {
+        njsUtils_throwError(env, errInvalidParameterValue, 2);
+        return NULL;
+    }
+
+    if (napi_get_reference_value(env, lazyRows->oracleDb->jsDateConstructor,
+            &dateConstructor) != napi_ok) {
+        njsUtils_genericThrowError(env);
+        return NULL;
+    }
+    if (!njsVariable_getBufferedValue(&lazyRows->queryVars[col],
+            &lazyRows->buffers[col], row, dateConstructor, env, &value))
+        return NULL;
+
+    return value;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsResultSet_getMetaData()
 //   Get accessor of "metaData" property.
@@ -225,6 +1067,69 @@ static napi_value njsResultSet_getNestedCursorIndices(napi_env env,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsResultSet_getOutFormat()
+//   Get accessor of "_outFormat" property.
+//-----------------------------------------------------------------------------
+static napi_value njsResultSet_getOutFormat(napi_env env,
+        napi_callback_info info)
+{
+    njsResultSet *rs;
+
+    if (!njsUtils_validateGetter(env, info, (njsBaseInstance**) &rs))
+        return NULL;
+    return njsUtils_convertToUnsignedInt(env, rs->outFormat);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_getRowConstructor()
+//   Returns the constructor used to create rows when the outFormat is OBJECT.
+// The constructor is acquired from the JavaScript layer the first time rows
+// are fetched and is retained for the lifetime of the result set, along with
+// the array used to pass the column values of each row to it.
+//-----------------------------------------------------------------------------
+static bool njsResultSet_getRowConstructor(njsResultSet *rs,
+        napi_value rsObj, napi_env env, napi_value *constructor)
+{
+    napi_value names, name, fn;
+    njsVariable *var;
+    uint32_t col;
+
+    // if the constructor has already been acquired, nothing further to do
+    if (rs->jsRowConstructor) {
+        NJS_CHECK_NAPI(env, napi_get_reference_value(env,
+                rs->jsRowConstructor, constructor))
+        return true;
+    }
+
+    // allocate memory for the column values passed to the constructor
+    rs->rowValues = calloc(rs->numQueryVars, sizeof(napi_value));
+    if (!rs->rowValues)
+        return njsUtils_throwError(env, errInsufficientMemory);
+
+    // create an array containing the (unique) names of the columns
+    NJS_CHECK_NAPI(env, napi_create_array_with_length(env, rs->numQueryVars,
+            &names))
+    for (col = 0; col < rs->numQueryVars; col++) {
+        var = &rs->queryVars[col];
+        NJS_CHECK_NAPI(env, napi_create_string_utf8(env, var->name,
+                var->nameLength, &name))
+        NJS_CHECK_NAPI(env, napi_set_element(env, names, col, name))
+    }
+
+    // call into JavaScript to get the constructor (stored in a cache)
+    NJS_CHECK_NAPI(env, napi_get_named_property(env, rsObj,
+            "_getRowConstructor", &fn))
+    NJS_CHECK_NAPI(env, napi_call_function(env, rsObj, fn, 1, &names,
+            constructor))
+    NJS_CHECK_NAPI(env, napi_create_reference(env, *constructor, 1,
+            &rs->jsRowConstructor))
+
+    return true;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsResultSet_getRows()
 //   Get a number of rows from the result set.
@@ -268,7 +1173,18 @@ static bool njsResultSet_getRowsAsync(njsBaton *baton)
     //   (3) when a maximum number of rows has been specified and this fetch
     //       will either satisfy that request or not enough rows are available
     //       to satisfy that request
-    ok = njsResultSet_getRowsHelper(rs, baton, &moreRows);
+    ok = njsResultSet_fetchRows(rs->conn, rs->handle, rs->queryVars,
+            rs->numQueryVars, baton->fetchArraySize, &rs->varsDefined, baton,
+            &moreRows);
+
+    // if lazy rows were requested, the rows are copied out of the query
+    // variables so that they can be retained after the next fetch
+    if (ok && rs->lazyRows && rs->outFormat != NJS_ROWS_COLUMNS &&
+            njsResultSet_canBufferRows(rs)) {
+        ok = njsResultSet_bufferRows(rs, baton);
+        baton->bufferRowIndex = 0;
+    }
+
     if (baton->closeOnFetch ||
             ((!ok || !moreRows) && baton->closeOnAllRowsFetched)) {
         dpiStmt_release(rs->handle);
@@ -287,128 +1203,13 @@ static bool njsResultSet_getRowsPostAsync(njsBaton *baton, napi_env env,
         napi_value *result)
 {
     njsResultSet *rs = (njsResultSet*) baton->callingInstance;
-    napi_value rowObj, colObj;
-    uint32_t row, col, i;
-    njsVariable *var;
 
     // set JavaScript values to simplify creation of returned objects
     if (!njsBaton_setJsValues(baton, env))
         return false;
 
-    // if outFormat is OBJECT, create names for each of the variables
-    if (rs->outFormat == NJS_ROWS_OBJECT) {
-        for (col = 0; col < rs->numQueryVars; col++) {
-            var = &rs->queryVars[col];
-            NJS_CHECK_NAPI(env, napi_create_string_utf8(env, var->name,
-                    var->nameLength, &var->jsName))
-        }
-    }
-
-    // create array
-    NJS_CHECK_NAPI(env, napi_create_array_with_length(env, baton->rowsFetched,
-            result))
-
-    // process each row
-    for (row = 0; row < baton->rowsFetched; row++) {
-
-        // create row, either as an array or an object
-        if (rs->outFormat == NJS_ROWS_ARRAY) {
-            NJS_CHECK_NAPI(env, napi_create_array_with_length(env,
-                    rs->numQueryVars, &rowObj))
-        } else {
-            NJS_CHECK_NAPI(env, napi_create_object(env, &rowObj))
-        }
-
-        // process each column
-        for (col = 0; col < rs->numQueryVars; col++) {
-            var = &rs->queryVars[col];
-            if (!njsVariable_getScalarValue(var, rs->conn, var->buffer, row,
-                    baton, env, &colObj))
-                return false;
-            if (rs->outFormat == NJS_ROWS_ARRAY) {
-                NJS_CHECK_NAPI(env, napi_set_element(env, rowObj, col, colObj))
-            } else {
-                NJS_CHECK_NAPI(env, napi_set_property(env, rowObj, var->jsName,
-                        colObj))
-            }
-        }
-        NJS_CHECK_NAPI(env, napi_set_element(env, *result, row, rowObj))
-
-    }
-
-    // clear variables if result set was closed
-    if (!rs->handle && !rs->isNested) {
-        for (i = 0; i < rs->numQueryVars; i++)
-            njsVariable_free(&rs->queryVars[i]);
-        free(rs->queryVars);
-        rs->queryVars = NULL;
-        rs->numQueryVars = 0;
-    }
-
-    return true;
-}
-
-
-//-----------------------------------------------------------------------------
-// njsResultSet_getRowsHelper()
-//   Get rows from the result set and indicate if more rows are available to
-// fetch or not.
-//-----------------------------------------------------------------------------
-static bool njsResultSet_getRowsHelper(njsResultSet *rs, njsBaton *baton,
-        bool *moreRows)
-{
-    njsVariable *var;
-    int tempMoreRows;
-    uint32_t i;
-
-    // create ODPI-C variables, if necessary
-    for (i = 0; i < rs->numQueryVars; i++) {
-        var = &rs->queryVars[i];
-        if (var->dpiVarHandle && var->maxArraySize >= baton->fetchArraySize)
-            continue;
-        rs->varsDefined = false;
-        if (var->dpiVarHandle) {
-            if (dpiVar_release(var->dpiVarHandle) < 0)
-                return njsBaton_setErrorDPI(baton);
-            var->dpiVarHandle = NULL;
-        }
-        if (dpiConn_newVar(rs->conn->handle, var->varTypeNum,
-                var->nativeTypeNum, baton->fetchArraySize, var->maxSize, 1, 0,
-                var->dpiObjectTypeHandle, &var->dpiVarHandle,
-                &var->buffer->dpiVarData) < 0)
-            return njsBaton_setErrorDPI(baton);
-        var->maxArraySize = baton->fetchArraySize;
-    }
-
-    // perform define, if necessary
-    if (!rs->varsDefined) {
-        for (i = 0; i < rs->numQueryVars; i++) {
-            var = &rs->queryVars[i];
-            if (dpiStmt_define(rs->handle, i + 1, var->dpiVarHandle) < 0)
-                return njsBaton_setErrorDPI(baton);
-        }
-        rs->varsDefined = true;
-    }
-
-    // set fetch array size as requested
-    if (dpiStmt_setFetchArraySize(rs->handle, baton->fetchArraySize) < 0)
-        return njsBaton_setErrorDPI(baton);
-
-    // perform fetch
-    if (dpiStmt_fetchRows(rs->handle, baton->fetchArraySize,
-            &baton->bufferRowIndex, &baton->rowsFetched, &tempMoreRows) < 0)
-        return njsBaton_setErrorDPI(baton);
-    *moreRows = (bool) tempMoreRows;
-
-    // result sets that should be auto closed are closed if the result set
-    // is exhaused or the maximum number of rows has been fetched
-    if (*moreRows && baton->maxRows > 0) {
-        if (baton->rowsFetched == baton->maxRows) {
-            *moreRows = 0;
-        }
-    }
-    return njsVariable_process(rs->queryVars, rs->numQueryVars,
-            baton->rowsFetched, baton);
+    return njsResultSet_createRows(rs, baton->jsCallingObj,
+            baton->fetchBuffers, baton, env, result);
 }
 
 
@@ -444,6 +1245,8 @@ static bool njsResultSet_getRowsProcessArgs(njsBaton *baton, napi_env env,
         return false;
     baton->extendedMetaData = rs->extendedMetaData;
     baton->outFormat = rs->outFormat;
+    baton->fetchAhead = rs->fetchAhead;
+    baton->lazyRows = rs->lazyRows;
 
     return true;
 }
@@ -462,7 +1265,9 @@ bool njsResultSet_new(njsBaton *baton, napi_env env, njsConnection *conn,
     napi_value callingObj;
     njsResultSet *rs;
 
-    if (baton->outFormat == NJS_ROWS_OBJECT) {
+    if (baton->outFormat == NJS_ROWS_OBJECT ||
+            baton->outFormat == NJS_ROWS_JSON ||
+            baton->outFormat == NJS_ROWS_NDJSON) {
         if (!njsResultSet_makeUniqueColumnNames (env, baton, vars, numVars))
             return false;
     }
@@ -489,6 +1294,8 @@ bool njsResultSet_new(njsBaton *baton, napi_env env, njsConnection *conn,
     rs->outFormat = baton->outFormat;
     rs->extendedMetaData = baton->extendedMetaData;
     rs->fetchArraySize = baton->fetchArraySize;
+    rs->fetchAhead = baton->fetchAhead;
+    rs->lazyRows = baton->lazyRows;
     rs->outFormat = baton->outFormat;
     rs->isNested = (baton->callingInstance != (void*) conn);
 
@@ -567,3 +1374,275 @@ bool njsResultSet_makeUniqueColumnNames(napi_env env, njsBaton *baton,
     }
     return true;
 }
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_reserveJsonText()
+//   Ensures that the JSON text on the baton has space for at least the
+// specified number of bytes beyond its current length and returns a pointer
+// to where they are to be written. NULL is returned if the memory cannot be
+// allocated.
+//-----------------------------------------------------------------------------
+static char *njsResultSet_reserveJsonText(njsBaton *baton, size_t numBytes)
+{
+    size_t numAllocated;
+    char *temp;
+
+    if (baton->jsonTextLength + numBytes > baton->jsonTextAllocated) {
+        numAllocated = (baton->jsonTextAllocated == 0) ?
+                NJS_JSON_TEXT_INITIAL_SIZE : baton->jsonTextAllocated * 2;
+        if (numAllocated < baton->jsonTextLength + numBytes)
+            numAllocated = baton->jsonTextLength + numBytes;
+        temp = realloc(baton->jsonText, numAllocated);
+        if (!temp) {
+            njsBaton_setError(baton, errInsufficientMemory);
+            return NULL;
+        }
+        baton->jsonText = temp;
+        baton->jsonTextAllocated = numAllocated;
+    }
+
+    return baton->jsonText + baton->jsonTextLength;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_saveInternStats()
+//   Saves the statistics for the strings interned by the result set before its
+// variables are freed, so that they remain available once it is closed.
+//-----------------------------------------------------------------------------
+static bool njsResultSet_saveInternStats(njsResultSet *rs, napi_env env)
+{
+    napi_value stats;
+
+    if (!njsVariable_getInternStats(rs->queryVars, rs->numQueryVars, env,
+            &stats))
+        return false;
+    if (stats) {
+        NJS_DELETE_REF_AND_CLEAR(rs->jsInternStats);
+        NJS_CHECK_NAPI(env, napi_create_reference(env, stats, 1,
+                &rs->jsInternStats))
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_writeJsonBuffer()
+//   Writes a RAW value as JSON in the same way that JSON.stringify() writes a
+// Buffer and returns the number of bytes written.
+//-----------------------------------------------------------------------------
+static size_t njsResultSet_writeJsonBuffer(char *ptr, const char *value,
+        uint32_t valueLength)
+{
+    static const char prefix[] = "{\"type\":\"Buffer\",\"data\":[";
+    char *start = ptr;
+    uint8_t byte;
+    uint32_t i;
+
+    memcpy(ptr, prefix, sizeof(prefix) - 1);
+    ptr += sizeof(prefix) - 1;
+    for (i = 0; i < valueLength; i++) {
+        if (i > 0)
+            *ptr++ = ',';
+        byte = (uint8_t) value[i];
+        if (byte >= 100)
+            *ptr++ = (char) ('0' + byte / 100);
+        if (byte >= 10)
+            *ptr++ = (char) ('0' + byte / 10 % 10);
+        *ptr++ = (char) ('0' + byte % 10);
+    }
+    *ptr++ = ']';
+    *ptr++ = '}';
+
+    return (size_t) (ptr - start);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_writeJsonDate()
+//   Writes a date (in milliseconds since the epoch) as a JSON string in the
+// format used by Date.prototype.toJSON() and returns the number of bytes
+// written. The civil date is calculated from the number of days since the
+// epoch without using the C library, which is limited to the range of time_t.
+//-----------------------------------------------------------------------------
+static size_t njsResultSet_writeJsonDate(char *ptr, double value)
+{
+    int64_t time, days, era, dayOfEra, yearOfEra, dayOfYear, monthIndex;
+    int64_t msOfDay, year, month, day;
+
+    // dates outside of the range supported by JavaScript are invalid and are
+    // written as null, as is done by Date.prototype.toJSON()
+    if (!isfinite(value) || value > 8.64e15 || value < -8.64e15) {
+        memcpy(ptr, "null", 4);
+        return 4;
+    }
+
+    // split the value into days and milliseconds within the day
+    time = (int64_t) value;
+    days = time / 86400000;
+    msOfDay = time % 86400000;
+    if (msOfDay < 0) {
+        msOfDay += 86400000;
+        days--;
+    }
+
+    // determine the year, month and day from the number of days, using eras
+    // of 400 years that start on March 1
+    days += 719468;
+    era = ((days >= 0) ? days : days - 146096) / 146097;
+    dayOfEra = days - era * 146097;
+    yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 -
+            dayOfEra / 146096) / 365;
+    dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = (monthIndex < 10) ? monthIndex + 3 : monthIndex - 9;
+    year = yearOfEra + era * 400 + ((month <= 2) ? 1 : 0);
+
+    return (size_t) snprintf(ptr, NJS_JSON_TEXT_MAX_SCALAR_SIZE,
+            (year >= 0 && year <= 9999) ?
+            "\"%04d-%02d-%02dT%02d:%02d:%02d.%03dZ\"" :
+            "\"%+07d-%02d-%02dT%02d:%02d:%02d.%03dZ\"", (int) year,
+            (int) month, (int) day, (int) (msOfDay / 3600000),
+            (int) (msOfDay / 60000 % 60), (int) (msOfDay / 1000 % 60),
+            (int) (msOfDay % 1000));
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_writeJsonNumber()
+//   Writes a number as JSON in the same way that JSON.stringify() writes a
+// JavaScript number and returns the number of bytes written. The shortest
+// number of significant digits that reads back as the same value is used.
+//-----------------------------------------------------------------------------
+static size_t njsResultSet_writeJsonNumber(char *ptr, double value)
+{
+    int precision, exponent, numDigits, i;
+    char buffer[32], digits[20];
+    char *start = ptr;
+
+    // values that are not finite are written as null
+    if (!isfinite(value)) {
+        memcpy(ptr, "null", 4);
+        return 4;
+    }
+
+    // integers (including negative zero) are written directly
+    if (value > -1e15 && value < 1e15 && value == (double) (int64_t) value)
+        return (size_t) snprintf(ptr, NJS_JSON_TEXT_MAX_SCALAR_SIZE, "%lld",
+                (long long) value);
+
+    // any value with 15 or fewer significant digits reads back correctly
+    // with a precision of 15 once trailing zeros are removed; other values
+    // need 16 or 17 significant digits; subnormal values have less precision
+    // so all precisions are tried for them
+    if (value < 0) {
+        *ptr++ = '-';
+        value = -value;
+    }
+    for (precision = (value < 1e-307) ? 1 : 15; ; precision++) {
+        snprintf(buffer, sizeof(buffer), "%.*e", precision - 1, value);
+        if (precision == 17 || strtod(buffer, NULL) == value)
+            break;
+    }
+
+    // extract the significant digits and the exponent
+    numDigits = 0;
+    for (i = 0; buffer[i] != 'e'; i++) {
+        if (buffer[i] >= '0' && buffer[i] <= '9')
+            digits[numDigits++] = buffer[i];
+    }
+    exponent = atoi(&buffer[i + 1]) + 1;
+    while (numDigits > 1 && digits[numDigits - 1] == '0')
+        numDigits--;
+
+    // write the digits as done by Number.prototype.toString()
+    if (numDigits <= exponent && exponent <= 21) {
+        memcpy(ptr, digits, numDigits);
+        ptr += numDigits;
+        memset(ptr, '0', exponent - numDigits);
+        ptr += exponent - numDigits;
+    } else if (exponent > 0 && exponent <= 21) {
+        memcpy(ptr, digits, exponent);
+        ptr += exponent;
+        *ptr++ = '.';
+        memcpy(ptr, digits + exponent, numDigits - exponent);
+        ptr += numDigits - exponent;
+    } else if (exponent > -6 && exponent <= 0) {
+        *ptr++ = '0';
+        *ptr++ = '.';
+        memset(ptr, '0', -exponent);
+        ptr += -exponent;
+        memcpy(ptr, digits, numDigits);
+        ptr += numDigits;
+    } else {
+        *ptr++ = digits[0];
+        if (numDigits > 1) {
+            *ptr++ = '.';
+            memcpy(ptr, digits + 1, numDigits - 1);
+            ptr += numDigits - 1;
+        }
+        ptr += snprintf(ptr, 8, "e%+d", exponent - 1);
+    }
+
+    return (size_t) (ptr - start);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsResultSet_writeJsonString()
+//   Writes a string as JSON, escaping quotes, backslashes and control
+// characters as done by JSON.stringify(), and returns the number of bytes
+// written. At most 6 bytes are written for each byte of the string, plus the
+// enclosing quotes.
+//-----------------------------------------------------------------------------
+static size_t njsResultSet_writeJsonString(char *ptr, const char *value,
+        uint32_t valueLength)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    char *start = ptr;
+    uint8_t ch;
+    uint32_t i;
+
+    *ptr++ = '"';
+    for (i = 0; i < valueLength; i++) {
+        ch = (uint8_t) value[i];
+        if (ch == '"' || ch == '\\') {
+            *ptr++ = '\\';
+            *ptr++ = (char) ch;
+        } else if (ch >= 0x20) {
+            *ptr++ = (char) ch;
+        } else {
+            *ptr++ = '\\';
+            switch (ch) {
+                case '\b':
+                    *ptr++ = 'b';
+                    break;
+                case '\f':
+                    *ptr++ = 'f';
+                    break;
+                case '\n':
+                    *ptr++ = 'n';
+                    break;
+                case '\r':
+                    *ptr++ = 'r';
+                    break;
+                case '\t':
+                    *ptr++ = 't';
+                    break;
+                default:
+                    *ptr++ = 'u';
+                    *ptr++ = '0';
+                    *ptr++ = '0';
+                    *ptr++ = hexDigits[ch >> 4];
+                    *ptr++ = hexDigits[ch & 0x0f];
+                    break;
+            }
+        }
+    }
+    *ptr++ = '"';
+
+    return (size_t) (ptr - start);
+}
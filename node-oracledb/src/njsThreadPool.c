@@ -0,0 +1,267 @@
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+
+//-----------------------------------------------------------------------------
+//
+// You may not use the identified files except in compliance with the Apache
+// License, Version 2.0 (the "License.")
+//
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// NAME
+//   njsThreadPool.c
+//
+// DESCRIPTION
+//   Implementation of the thread pool used to perform database calls. The
+// threads are owned by node-oracledb so that database calls, which may block
+// for a long time, do not occupy the libuv thread pool used by Node.js for
+// file system, DNS and other work. The thread pool is shared by all Node.js
+// environments in the process. Threads are started when work is queued and
+// none are idle, up to the configured size plus the sum of the maximum sizes
+// of all open connection pools. Threads are never stopped, so the module is
+// pinned in memory when the thread pool is initialized; otherwise it would be
+// unloaded once the last environment that loaded it has been torn down while
+// the threads are still running its code. The number of
+// batons of each OracleDb instance that have been queued but not yet posted
+// back to the main thread is tracked so that the instance can wait for them
+// before it is freed when its environment is torn down.
+//
+//-----------------------------------------------------------------------------
+
+// for gcc, ensure that GNU extensions are enabled so that dladdr() is
+// available on platforms like Linux
+#if defined(__GNUC__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "njsModule.h"
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+// methods used internally
+static void njsThreadPool_init(void);
+static void njsThreadPool_main(void *arg);
+static void njsThreadPool_pinModule(void);
+
+// state of the thread pool; all values except the initialization flag are
+// protected by the mutex
+static uv_once_t njsThreadPoolInitOnce = UV_ONCE_INIT;
+static uv_mutex_t njsThreadPoolMutex;
+static uv_cond_t njsThreadPoolCond;
+static uv_cond_t njsThreadPoolWorkDoneCond;
+static njsBaton *njsThreadPoolQueueHead = NULL;
+static njsBaton *njsThreadPoolQueueTail = NULL;
+static uint32_t njsThreadPoolNumQueued = 0;
+static uint32_t njsThreadPoolNumThreads = 0;
+static uint32_t njsThreadPoolNumIdleThreads = 0;
+static uint32_t njsThreadPoolNumPoolThreads = 0;
+static uint32_t njsThreadPoolSize = NJS_DB_THREAD_POOL_SIZE;
+
+
+//-----------------------------------------------------------------------------
+// njsThreadPool_addPoolThreads()
+//   Adjusts the number of threads that may be started on behalf of connection
+// pools. This is called with the maximum size of a pool when it is created
+// and with the negated value when it is closed, so that each connection in a
+// pool can have a database call in progress without waiting for a thread.
+// This may be called from any thread.
+//-----------------------------------------------------------------------------
+void njsThreadPool_addPoolThreads(int32_t numThreads)
+{
+    uv_once(&njsThreadPoolInitOnce, njsThreadPool_init);
+    uv_mutex_lock(&njsThreadPoolMutex);
+    njsThreadPoolNumPoolThreads += numThreads;
+    uv_mutex_unlock(&njsThreadPoolMutex);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsThreadPool_getSize()
+//   Returns the configured size of the thread pool, not including the threads
+// that may be started on behalf of connection pools.
+//-----------------------------------------------------------------------------
+uint32_t njsThreadPool_getSize(void)
+{
+    uint32_t size;
+
+    uv_once(&njsThreadPoolInitOnce, njsThreadPool_init);
+    uv_mutex_lock(&njsThreadPoolMutex);
+    size = njsThreadPoolSize;
+    uv_mutex_unlock(&njsThreadPoolMutex);
+    return size;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsThreadPool_init()
+//   Initializes the synchronization primitives used by the thread pool and
+// pins the module in memory. This is called exactly once.
+//-----------------------------------------------------------------------------
+static void njsThreadPool_init(void)
+{
+    njsThreadPool_pinModule();
+    uv_mutex_init(&njsThreadPoolMutex);
+    uv_cond_init(&njsThreadPoolCond);
+    uv_cond_init(&njsThreadPoolWorkDoneCond);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsThreadPool_main()
+//   Main routine of each thread in the thread pool. Batons are removed from
+// the queue in the order in which they were added and the work callback is
+// invoked, exactly as is done for work queued on the libuv thread pool. The
+// baton is then posted back to the main thread of the environment that queued
+// it. The baton must not be referenced once it has been posted since the main
+// thread may already have freed or reused it.
+//-----------------------------------------------------------------------------
+static void njsThreadPool_main(void *arg)
+{
+    njsOracleDb *oracleDb;
+    njsBaton *baton;
+
+    while (1) {
+
+        // wait for work to be queued
+        uv_mutex_lock(&njsThreadPoolMutex);
+        while (!njsThreadPoolQueueHead) {
+            njsThreadPoolNumIdleThreads++;
+            uv_cond_wait(&njsThreadPoolCond, &njsThreadPoolMutex);
+            njsThreadPoolNumIdleThreads--;
+        }
+        baton = njsThreadPoolQueueHead;
+        njsThreadPoolQueueHead = baton->nextQueued;
+        if (!njsThreadPoolQueueHead)
+            njsThreadPoolQueueTail = NULL;
+        njsThreadPoolNumQueued--;
+        uv_mutex_unlock(&njsThreadPoolMutex);
+
+        // perform the work and post the baton back to the main thread
+        oracleDb = baton->oracleDb;
+        baton->nextQueued = NULL;
+        if (!baton->workCallback(baton))
+            baton->hasError = true;
+        njsBaton_postCompleted(baton);
+
+        // wake up the main thread if it is waiting for the work of the
+        // OracleDb instance to be done
+        uv_mutex_lock(&njsThreadPoolMutex);
+        if (--oracleDb->numThreadPoolWork == 0)
+            uv_cond_broadcast(&njsThreadPoolWorkDoneCond);
+        uv_mutex_unlock(&njsThreadPoolMutex);
+
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// njsThreadPool_pinModule()
+//   Ensures that the module containing the thread pool is never unloaded by
+// acquiring a reference to it which is never released. Node.js unloads an
+// add-on once all of the environments that loaded it have been torn down,
+// which can happen while threads in the pool are running or idle. Failures
+// are ignored since they only affect processes that tear down every
+// environment that loaded the add-on before exiting. This is platform
+// specific.
+//-----------------------------------------------------------------------------
+static void njsThreadPool_pinModule(void)
+{
+#if defined(_WIN32)
+    HMODULE module;
+
+    GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+            GET_MODULE_HANDLE_EX_FLAG_PIN, (LPCSTR) njsThreadPool_main,
+            &module);
+#elif !defined(_AIX)
+    Dl_info info;
+
+    if (dladdr((void*) njsThreadPool_main, &info) != 0)
+        dlopen(info.dli_fname, RTLD_NOW);
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// njsThreadPool_queueWork()
+//   Adds the baton to the queue of work to perform and starts a new thread if
+// none are available to perform it and the size of the thread pool permits.
+// False is returned if no thread could be started and there are no threads in
+// the pool at all; the caller is then expected to perform the work some other
+// way.
+//-----------------------------------------------------------------------------
+bool njsThreadPool_queueWork(njsBaton *baton)
+{
+    uv_thread_t thread;
+    bool ok = true;
+
+    uv_once(&njsThreadPoolInitOnce, njsThreadPool_init);
+    uv_mutex_lock(&njsThreadPoolMutex);
+
+    // start a new thread if the queued work exceeds the number of idle
+    // threads and the limit has not been reached
+    if (njsThreadPoolNumQueued >= njsThreadPoolNumIdleThreads &&
+            njsThreadPoolNumThreads <
+            njsThreadPoolSize + njsThreadPoolNumPoolThreads) {
+        if (uv_thread_create(&thread, njsThreadPool_main, NULL) == 0)
+            njsThreadPoolNumThreads++;
+    }
+
+    // add the baton to the end of the queue and wake up an idle thread
+    if (njsThreadPoolNumThreads == 0) {
+        ok = false;
+    } else {
+        baton->nextQueued = NULL;
+        if (njsThreadPoolQueueTail)
+            njsThreadPoolQueueTail->nextQueued = baton;
+        else njsThreadPoolQueueHead = baton;
+        njsThreadPoolQueueTail = baton;
+        njsThreadPoolNumQueued++;
+        baton->oracleDb->numThreadPoolWork++;
+        uv_cond_signal(&njsThreadPoolCond);
+    }
+
+    uv_mutex_unlock(&njsThreadPoolMutex);
+    return ok;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsThreadPool_setSize()
+//   Sets the size of the thread pool, not including the threads that may be
+// started on behalf of connection pools. A size of zero disables the thread
+// pool and work is queued on the libuv thread pool instead. Threads that have
+// already been started are not stopped if the size is reduced.
+//-----------------------------------------------------------------------------
+void njsThreadPool_setSize(uint32_t size)
+{
+    uv_once(&njsThreadPoolInitOnce, njsThreadPool_init);
+    uv_mutex_lock(&njsThreadPoolMutex);
+    njsThreadPoolSize = size;
+    uv_mutex_unlock(&njsThreadPoolMutex);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsThreadPool_waitForWork()
+//   Waits for the thread pool to finish all of the work queued for the given
+// OracleDb instance, including posting the batons back to the main thread.
+// This is called when the environment of the instance is being torn down, so
+// no further work can be queued for it in the meantime.
+//-----------------------------------------------------------------------------
+void njsThreadPool_waitForWork(njsOracleDb *oracleDb)
+{
+    uv_once(&njsThreadPoolInitOnce, njsThreadPool_init);
+    uv_mutex_lock(&njsThreadPoolMutex);
+    while (oracleDb->numThreadPoolWork > 0)
+        uv_cond_wait(&njsThreadPoolWorkDoneCond, &njsThreadPoolMutex);
+    uv_mutex_unlock(&njsThreadPoolMutex);
+}
@@ -25,6 +25,12 @@
 
 #include "njsModule.h"
 
+// finalizers for Buffers that refer to memory allocated by node-oracledb
+static void njsUtils_finalizeBlockBuffer(napi_env env, void *finalizeData,
+        void *finalizeHint);
+static void njsUtils_finalizeBuffer(napi_env env, void *finalizeData,
+        void *finalizeHint);
+
 //-----------------------------------------------------------------------------
 // njsUtils_addTypeProperties()
 //   Add type properties to the specified object given the ODPI-C Oracle type
@@ -323,6 +329,7 @@ bool njsUtils_copyStringFromJS(napi_env env, napi_value value, char **result,
 bool njsUtils_createBaton(napi_env env, napi_callback_info info,
         size_t numArgs, napi_value *args, njsBaton **baton)
 {
+    njsOracleDb *oracleDb;
     njsBaton *tempBaton;
     napi_value callback;
 
@@ -332,12 +339,27 @@ bool njsUtils_createBaton(napi_env env, napi_callback_info info,
     if (numArgs == 1 && !args)
         args = &callback;
 
-    // allocate and zero memory
-    tempBaton = calloc(1, sizeof(njsBaton));
-    if (!tempBaton) {
-        njsUtils_throwError(env, errInsufficientMemory);
-        return false;
+    // reuse a baton freed by an earlier call, if one is available; otherwise,
+    // allocate and zero memory; the OracleDb instance is stored on each of the
+    // methods of the classes that it prepares
+    NJS_CHECK_NAPI(env, napi_get_cb_info(env, info, NULL, NULL, NULL,
+            (void**) &oracleDb))
+    if (oracleDb && oracleDb->freeBatons) {
+        tempBaton = oracleDb->freeBatons;
+        oracleDb->freeBatons = tempBaton->nextQueued;
+        oracleDb->numFreeBatons--;
+        oracleDb->numBatonsReused++;
+        tempBaton->nextQueued = NULL;
+    } else {
+        tempBaton = calloc(1, sizeof(njsBaton));
+        if (!tempBaton) {
+            njsUtils_throwError(env, errInsufficientMemory);
+            return false;
+        }
+        if (oracleDb)
+            oracleDb->numBatonsAllocated++;
     }
+    tempBaton->oracleDb = oracleDb;
 
     // perform common checks and populate common attributes in the baton
     if (!njsBaton_create(tempBaton, env, info, numArgs, args)) {
@@ -350,6 +372,72 @@ bool njsUtils_createBaton(napi_env env, napi_callback_info info,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsUtils_createBlock()
+//   Create a block of memory of the specified size for holding byte strings.
+// The block is returned with a single reference held by the caller, or NULL
+// if the memory cannot be allocated. This may be called from a worker thread.
+//-----------------------------------------------------------------------------
+njsBlock *njsUtils_createBlock(size_t size)
+{
+    njsBlock *block;
+
+    block = malloc(sizeof(njsBlock) + size);
+    if (!block)
+        return NULL;
+    block->refCount = 1;
+    block->data = (char*) (block + 1);
+    return block;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsUtils_createBufferFromBlock()
+//   Create a Buffer containing the specified bytes. If the bytes are stored in
+// a block and are large enough, the Buffer refers to the memory in the block
+// directly and holds a reference to it; otherwise, the bytes are copied. The
+// bytes are also copied if the engine does not permit external Buffers.
+//-----------------------------------------------------------------------------
+bool njsUtils_createBufferFromBlock(napi_env env, njsBlock *block,
+        char *ptr, size_t length, napi_value *value)
+{
+    if (block && length >= NJS_EXTERNAL_BUFFER_MIN_SIZE) {
+        if (napi_create_external_buffer(env, length, ptr,
+                njsUtils_finalizeBlockBuffer, block, value) == napi_ok) {
+            block->refCount++;
+            return true;
+        }
+    }
+    NJS_CHECK_NAPI(env, napi_create_buffer_copy(env, length, ptr, NULL,
+            value))
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsUtils_finalizeBlockBuffer()
+//   Invoked when a Buffer referring to memory in a block is garbage collected.
+// The reference to the block held by the Buffer is released.
+//-----------------------------------------------------------------------------
+static void njsUtils_finalizeBlockBuffer(napi_env env, void *finalizeData,
+        void *finalizeHint)
+{
+    njsUtils_releaseBlock((njsBlock*) finalizeHint);
+}
+
+
+//-----------------------------------------------------------------------------
+// njsUtils_finalizeBuffer()
+//   Invoked when a Buffer that took ownership of memory allocated by
+// node-oracledb is garbage collected. The memory is freed.
+//-----------------------------------------------------------------------------
+static void njsUtils_finalizeBuffer(napi_env env, void *finalizeData,
+        void *finalizeHint)
+{
+    free(finalizeData);
+}
+
+
 //-----------------------------------------------------------------------------
 // njsUtils_genericNew()
 //   Generic method for creating a JS instance with the specified structure
@@ -682,6 +770,18 @@ bool njsUtils_isBuffer(napi_env env, napi_value value)
 }
 
 
+//-----------------------------------------------------------------------------
+// njsUtils_releaseBlock()
+//   Release a reference to a block, freeing it when no references remain.
+// References are only acquired and released on the main thread.
+//-----------------------------------------------------------------------------
+void njsUtils_releaseBlock(njsBlock *block)
+{
+    if (--block->refCount == 0)
+        free(block);
+}
+
+
 //-----------------------------------------------------------------------------
 // njsUtils_setPropBool()
 //   Sets a property to a boolean value. If the value is not a boolean, an
@@ -857,6 +957,30 @@ bool njsUtils_throwErrorDPI(napi_env env, njsOracleDb *oracleDb)
 }
 
 
+//-----------------------------------------------------------------------------
+// njsUtils_transferToBuffer()
+//   Create a Buffer containing the specified bytes, which were allocated with
+// malloc(). If the bytes are large enough, the Buffer takes ownership of the
+// memory and the pointer is cleared so that the caller does not free it;
+// otherwise, or if the engine does not permit external Buffers, the bytes are
+// copied and the memory remains owned by the caller.
+//-----------------------------------------------------------------------------
+bool njsUtils_transferToBuffer(napi_env env, char **ptr, size_t length,
+        napi_value *value)
+{
+    if (length >= NJS_EXTERNAL_BUFFER_MIN_SIZE) {
+        if (napi_create_external_buffer(env, length, *ptr,
+                njsUtils_finalizeBuffer, NULL, value) == napi_ok) {
+            *ptr = NULL;
+            return true;
+        }
+    }
+    NJS_CHECK_NAPI(env, napi_create_buffer_copy(env, length, *ptr, NULL,
+            value))
+    return true;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsUtils_validateArgs()
 //   Gets the instance associated with the object and gets the arguments as
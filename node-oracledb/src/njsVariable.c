@@ -27,6 +27,10 @@
 
 // forward declarations for functions only used in this file
 static void njsVariable_freeBuffer(njsVariableBuffer *buffer);
+static void njsVariable_freeStringCache(njsStringCache *cache);
+static bool njsVariable_getInternedString(njsVariable *var, const char *ptr,
+        uint32_t length, njsBaton *baton, napi_env env, napi_value *value);
+static bool njsVariable_growStringCache(njsStringCache *cache);
 static bool njsVariable_processBuffer(njsVariable *var,
         njsVariableBuffer *buffer, njsBaton *baton);
 static bool njsVariable_processBufferJS(njsVariable *var,
@@ -164,6 +168,10 @@ void njsVariable_free(njsVariable *var)
         free(var->dmlReturningBuffers);
         var->dmlReturningBuffers = NULL;
     }
+    if (var->stringCache) {
+        njsVariable_freeStringCache(var->stringCache);
+        var->stringCache = NULL;
+    }
 }
 
 
@@ -195,6 +203,29 @@ static void njsVariable_freeBuffer(njsVariableBuffer *buffer)
 }
 
 
+//-----------------------------------------------------------------------------
+// njsVariable_freeStringCache()
+//   Frees the strings interned for a column. The cache is only populated in
+// the main thread, which is also where the variables that own it are freed.
+//-----------------------------------------------------------------------------
+static void njsVariable_freeStringCache(njsStringCache *cache)
+{
+    uint32_t i;
+
+    if (cache->slots) {
+        for (i = 0; i < cache->numSlots; i++)
+            NJS_FREE_AND_CLEAR(cache->slots[i].data);
+        free(cache->slots);
+        cache->slots = NULL;
+    }
+    if (cache->jsValues) {
+        napi_delete_reference(cache->env, cache->jsValues);
+        cache->jsValues = NULL;
+    }
+    free(cache);
+}
+
+
 //-----------------------------------------------------------------------------
 // njsVariable_getArrayValue()
 //   Get the value from the variable as an array.
@@ -224,6 +255,198 @@ bool njsVariable_getArrayValue(njsVariable *var, njsConnection *conn,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsVariable_getBufferedValue()
+//   Get the value of a row that was copied into a buffer by a result set. Only
+// the types of values that can be buffered (see njsResultSet_canBufferRows())
+// are supported; unlike njsVariable_getScalarValue(), no baton is required
+// and any error is thrown directly.
+//-----------------------------------------------------------------------------
+bool njsVariable_getBufferedValue(njsVariable *var, njsVariableBuffer *buffer,
+        uint32_t pos, napi_value jsDateConstructor, napi_env env,
+        napi_value *value)
+{
+    dpiData *data = &buffer->dpiVarData[pos];
+    napi_value temp;
+
+    // handle null values
+    if (data->isNull) {
+        NJS_CHECK_NAPI(env, napi_get_null(env, value))
+        return true;
+    }
+
+    // handle all other values
+    switch (var->nativeTypeNum) {
+        case DPI_NATIVE_TYPE_INT64:
+            NJS_CHECK_NAPI(env, napi_create_int64(env, data->value.asInt64,
+                    value))
+            break;
+        case DPI_NATIVE_TYPE_FLOAT:
+            NJS_CHECK_NAPI(env, napi_create_double(env, data->value.asFloat,
+                    value))
+            break;
+        case DPI_NATIVE_TYPE_DOUBLE:
+            NJS_CHECK_NAPI(env, napi_create_double(env, data->value.asDouble,
+                    value))
+            if (var->varTypeNum == DPI_ORACLE_TYPE_TIMESTAMP_LTZ ||
+                    var->varTypeNum == DPI_ORACLE_TYPE_TIMESTAMP ||
+                    var->varTypeNum == DPI_ORACLE_TYPE_TIMESTAMP_TZ ||
+                    var->varTypeNum == DPI_ORACLE_TYPE_DATE) {
+                temp = *value;
+                NJS_CHECK_NAPI(env, napi_new_instance(env, jsDateConstructor,
+                        1, &temp, value))
+            }
+            break;
+        case DPI_NATIVE_TYPE_BYTES:
+            if (data->value.asBytes.length > var->maxSize)
+                return njsUtils_throwError(env, errInsufficientBufferForBinds);
+            if (data->value.asBytes.length == 0) {
+                NJS_CHECK_NAPI(env, napi_get_null(env, value))
+            } else if (var->varTypeNum == DPI_ORACLE_TYPE_RAW ||
+                    var->varTypeNum == DPI_ORACLE_TYPE_LONG_RAW) {
+                if (!njsUtils_createBufferFromBlock(env,
+                        (buffer->blocks) ? buffer->blocks[pos] : NULL,
+                        data->value.asBytes.ptr, data->value.asBytes.length,
+                        value))
+                    return false;
+            } else {
+                NJS_CHECK_NAPI(env, napi_create_string_utf8(env,
+                        data->value.asBytes.ptr, data->value.asBytes.length,
+                        value))
+            }
+            break;
+        case DPI_NATIVE_TYPE_BOOLEAN:
+            NJS_CHECK_NAPI(env, napi_get_boolean(env, data->value.asBoolean,
+                    value))
+            break;
+        default:
+            NJS_CHECK_NAPI(env, napi_get_undefined(env, value))
+            break;
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsVariable_getColumnValues()
+//   Get the values of the rows that were fetched as a single column object.
+// Numbers and dates are transferred into a Float64Array and strings and raw
+// values into a single Buffer with an array of offsets, directly from the
+// ODPI-C buffers; all other values are transferred into an array. A bitmap
+// with one bit set for each null value is also included.
+//-----------------------------------------------------------------------------
+bool njsVariable_getColumnValues(njsVariable *var, njsConnection *conn,
+        njsVariableBuffer *buffer, uint32_t numRows, njsBaton *baton,
+        napi_env env, napi_value *column)
+{
+    uint32_t row, numBytes, numBitmapBytes, *offsets;
+    napi_value arrayBuffer, values, temp;
+    uint8_t *nullBitmap;
+    double *doubles;
+    dpiData *data;
+    char *bytes;
+
+    // create the column object and populate the bitmap of null values; empty
+    // strings are also considered null, as is done when fetching rows
+    data = &buffer->dpiVarData[baton->bufferRowIndex];
+    numBitmapBytes = (numRows + 7) / 8;
+    NJS_CHECK_NAPI(env, napi_create_object(env, column))
+    NJS_CHECK_NAPI(env, napi_create_arraybuffer(env, numBitmapBytes,
+            (void**) &nullBitmap, &arrayBuffer))
+    if (numBitmapBytes > 0)
+        memset(nullBitmap, 0, numBitmapBytes);
+    for (row = 0; row < numRows; row++) {
+        if (data[row].isNull ||
+                (var->nativeTypeNum == DPI_NATIVE_TYPE_BYTES &&
+                data[row].value.asBytes.length == 0))
+            nullBitmap[row / 8] |= (uint8_t) (1 << (row % 8));
+    }
+    NJS_CHECK_NAPI(env, napi_create_typedarray(env, napi_uint8_array,
+            numBitmapBytes, arrayBuffer, 0, &temp))
+    NJS_CHECK_NAPI(env, napi_set_named_property(env, *column, "nulls", temp))
+
+    switch (var->nativeTypeNum) {
+
+        // numbers and dates are transferred to a Float64Array; dates are
+        // represented as the number of milliseconds since the epoch
+        case DPI_NATIVE_TYPE_INT64:
+        case DPI_NATIVE_TYPE_FLOAT:
+        case DPI_NATIVE_TYPE_DOUBLE:
+            NJS_CHECK_NAPI(env, napi_create_arraybuffer(env,
+                    numRows * sizeof(double), (void**) &doubles,
+                    &arrayBuffer))
+            for (row = 0; row < numRows; row++) {
+                if (data[row].isNull) {
+                    doubles[row] = 0;
+                } else if (var->nativeTypeNum == DPI_NATIVE_TYPE_INT64) {
+                    doubles[row] = (double) data[row].value.asInt64;
+                } else if (var->nativeTypeNum == DPI_NATIVE_TYPE_FLOAT) {
+                    doubles[row] = data[row].value.asFloat;
+                } else {
+                    doubles[row] = data[row].value.asDouble;
+                }
+            }
+            NJS_CHECK_NAPI(env, napi_create_typedarray(env,
+                    napi_float64_array, numRows, arrayBuffer, 0, &values))
+            NJS_CHECK_NAPI(env, napi_set_named_property(env, *column,
+                    "values", values))
+            break;
+
+        // strings and raw values are transferred one after the other to a
+        // single buffer; the value in row n is found between offsets[n] and
+        // offsets[n + 1]
+        case DPI_NATIVE_TYPE_BYTES:
+            numBytes = 0;
+            for (row = 0; row < numRows; row++) {
+                if (data[row].isNull)
+                    continue;
+                if (data[row].value.asBytes.length > var->maxSize)
+                    return njsBaton_setError(baton,
+                            errInsufficientBufferForBinds);
+                numBytes += data[row].value.asBytes.length;
+            }
+            NJS_CHECK_NAPI(env, napi_create_buffer(env, numBytes,
+                    (void**) &bytes, &values))
+            NJS_CHECK_NAPI(env, napi_create_arraybuffer(env,
+                    (numRows + 1) * sizeof(uint32_t), (void**) &offsets,
+                    &arrayBuffer))
+            offsets[0] = 0;
+            for (row = 0; row < numRows; row++) {
+                offsets[row + 1] = offsets[row];
+                if (data[row].isNull)
+                    continue;
+                memcpy(bytes + offsets[row], data[row].value.asBytes.ptr,
+                        data[row].value.asBytes.length);
+                offsets[row + 1] += data[row].value.asBytes.length;
+            }
+            NJS_CHECK_NAPI(env, napi_set_named_property(env, *column, "data",
+                    values))
+            NJS_CHECK_NAPI(env, napi_create_typedarray(env, napi_uint32_array,
+                    numRows + 1, arrayBuffer, 0, &temp))
+            NJS_CHECK_NAPI(env, napi_set_named_property(env, *column,
+                    "offsets", temp))
+            break;
+
+        // all other values are transferred to an array of values
+        default:
+            NJS_CHECK_NAPI(env, napi_create_array_with_length(env, numRows,
+                    &values))
+            for (row = 0; row < numRows; row++) {
+                if (!njsVariable_getScalarValue(var, conn, buffer, row,
+                        baton, env, &temp))
+                    return false;
+                NJS_CHECK_NAPI(env, napi_set_element(env, values, row, temp))
+            }
+            NJS_CHECK_NAPI(env, napi_set_named_property(env, *column,
+                    "values", values))
+            break;
+    }
+
+    return true;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsVariable_getDataType()
 //   Return the data type that is being used by the variable. This is an
@@ -411,6 +634,137 @@ bool njsVariable_getNestedCursorIndices(njsVariable *vars, uint32_t numVars,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsVariable_getInternedString()
+//   Returns the string for the given bytes fetched for a column with
+// interning enabled. If the same bytes have been seen before, the string
+// created at that time is returned; otherwise, a new string is created and
+// added to the cache (as long as the cache is not full).
+//-----------------------------------------------------------------------------
+static bool njsVariable_getInternedString(njsVariable *var, const char *ptr,
+        uint32_t length, njsBaton *baton, napi_env env, napi_value *value)
+{
+    njsStringCache *cache = var->stringCache;
+    njsStringCacheEntry *entry;
+    napi_value jsValues;
+    uint32_t hash, i;
+
+    // values that are too long are not interned
+    if (length > NJS_STRING_CACHE_MAX_VALUE_SIZE) {
+        cache->numMisses++;
+        NJS_CHECK_NAPI(env, napi_create_string_utf8(env, ptr, length, value))
+        return true;
+    }
+
+    // calculate the hash of the bytes (FNV-1a)
+    hash = 2166136261u;
+    for (i = 0; i < length; i++)
+        hash = (hash ^ (uint8_t) ptr[i]) * 16777619u;
+
+    // look for the bytes in the cache; if found, return the existing string
+    if (cache->slots) {
+        i = hash & (cache->numSlots - 1);
+        while (cache->slots[i].data) {
+            entry = &cache->slots[i];
+            if (entry->hash == hash && entry->length == length &&
+                    memcmp(entry->data, ptr, length) == 0) {
+                cache->numHits++;
+                NJS_CHECK_NAPI(env, napi_get_reference_value(env,
+                        cache->jsValues, &jsValues))
+                NJS_CHECK_NAPI(env, napi_get_element(env, jsValues,
+                        entry->index, value))
+                return true;
+            }
+            i = (i + 1) & (cache->numSlots - 1);
+        }
+    }
+
+    // create a new string; once the cache is full it is not retained
+    cache->numMisses++;
+    NJS_CHECK_NAPI(env, napi_create_string_utf8(env, ptr, length, value))
+    if (cache->numEntries >= NJS_STRING_CACHE_MAX_ENTRIES)
+        return true;
+
+    // acquire the array holding the interned strings, creating it if needed;
+    // references to strings are not supported by all Node-API versions so the
+    // strings are held by the array instead
+    if (cache->jsValues) {
+        NJS_CHECK_NAPI(env, napi_get_reference_value(env, cache->jsValues,
+                &jsValues))
+    } else {
+        NJS_CHECK_NAPI(env, napi_create_array(env, &jsValues))
+        NJS_CHECK_NAPI(env, napi_create_reference(env, jsValues, 1,
+                &cache->jsValues))
+        cache->env = env;
+    }
+
+    // keep the hash table no more than half full
+    if ((cache->numEntries + 1) * 2 > cache->numSlots &&
+            !njsVariable_growStringCache(cache))
+        return njsBaton_setError(baton, errInsufficientMemory);
+
+    // add the entry to the cache
+    i = hash & (cache->numSlots - 1);
+    while (cache->slots[i].data)
+        i = (i + 1) & (cache->numSlots - 1);
+    entry = &cache->slots[i];
+    entry->data = malloc(length);
+    if (!entry->data)
+        return njsBaton_setError(baton, errInsufficientMemory);
+    memcpy(entry->data, ptr, length);
+    entry->hash = hash;
+    entry->length = length;
+    entry->index = cache->numEntries;
+    NJS_CHECK_NAPI(env, napi_set_element(env, jsValues, entry->index, *value))
+    cache->numEntries++;
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// njsVariable_getInternStats()
+//   Returns an object containing the number of cache hits, cache misses and
+// interned strings for each column with interning enabled, keyed by column
+// name. If no column has interning enabled, the value is left as NULL.
+//-----------------------------------------------------------------------------
+bool njsVariable_getInternStats(njsVariable *vars, uint32_t numVars,
+        napi_env env, napi_value *stats)
+{
+    napi_value name, columnStats, temp;
+    njsStringCache *cache;
+    uint32_t i;
+
+    *stats = NULL;
+    for (i = 0; i < numVars; i++) {
+        cache = vars[i].stringCache;
+        if (!cache)
+            continue;
+        if (!*stats) {
+            NJS_CHECK_NAPI(env, napi_create_object(env, stats))
+        }
+        NJS_CHECK_NAPI(env, napi_create_object(env, &columnStats))
+        NJS_CHECK_NAPI(env, napi_create_double(env, (double) cache->numHits,
+                &temp))
+        NJS_CHECK_NAPI(env, napi_set_named_property(env, columnStats, "hits",
+                temp))
+        NJS_CHECK_NAPI(env, napi_create_double(env,
+                (double) cache->numMisses, &temp))
+        NJS_CHECK_NAPI(env, napi_set_named_property(env, columnStats,
+                "misses", temp))
+        NJS_CHECK_NAPI(env, napi_create_uint32(env, cache->numEntries, &temp))
+        NJS_CHECK_NAPI(env, napi_set_named_property(env, columnStats,
+                "entries", temp))
+        NJS_CHECK_NAPI(env, napi_create_string_utf8(env, vars[i].name,
+                vars[i].nameLength, &name))
+        NJS_CHECK_NAPI(env, napi_set_property(env, *stats, name,
+                columnStats))
+    }
+
+    return true;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsVariable_getJsonNodeValue()
 //   Return an appropriate JavaScript value for the JSON node.
@@ -536,9 +890,16 @@ bool njsVariable_getScalarValue(njsVariable *var, njsConnection *conn,
                 NJS_CHECK_NAPI(env, napi_get_null(env, value))
             } else if (var->varTypeNum == DPI_ORACLE_TYPE_RAW ||
                     var->varTypeNum == DPI_ORACLE_TYPE_LONG_RAW) {
-                NJS_CHECK_NAPI(env, napi_create_buffer_copy(env,
-                        data->value.asBytes.length, data->value.asBytes.ptr,
-                        NULL, value))
+                if (!njsUtils_createBufferFromBlock(env,
+                        (buffer->blocks) ? buffer->blocks[bufferRowIndex] :
+                        NULL, data->value.asBytes.ptr,
+                        data->value.asBytes.length, value))
+                    return false;
+            } else if (var->stringCache) {
+                if (!njsVariable_getInternedString(var,
+                        data->value.asBytes.ptr, data->value.asBytes.length,
+                        baton, env, value))
+                    return false;
             } else {
                 NJS_CHECK_NAPI(env, napi_create_string_utf8(env,
                         data->value.asBytes.ptr, data->value.asBytes.length,
@@ -595,6 +956,37 @@ bool njsVariable_getScalarValue(njsVariable *var, njsConnection *conn,
 }
 
 
+//-----------------------------------------------------------------------------
+// njsVariable_growStringCache()
+//   Doubles the number of slots in the hash table of the string cache and
+// reinserts the existing entries.
+//-----------------------------------------------------------------------------
+static bool njsVariable_growStringCache(njsStringCache *cache)
+{
+    njsStringCacheEntry *slots;
+    uint32_t numSlots, i, j;
+
+    numSlots = (cache->numSlots == 0) ? NJS_STRING_CACHE_INITIAL_SLOTS :
+            cache->numSlots * 2;
+    slots = calloc(numSlots, sizeof(njsStringCacheEntry));
+    if (!slots)
+        return false;
+    for (i = 0; i < cache->numSlots; i++) {
+        if (!cache->slots[i].data)
+            continue;
+        j = cache->slots[i].hash & (numSlots - 1);
+        while (slots[j].data)
+            j = (j + 1) & (numSlots - 1);
+        slots[j] = cache->slots[i];
+    }
+    free(cache->slots);
+    cache->slots = slots;
+    cache->numSlots = numSlots;
+
+    return true;
+}
+
+
 //-----------------------------------------------------------------------------
 // njsVariable_initForQuery()
 //   Initialize query variables using the metadata from the query as a
@@ -604,7 +996,7 @@ bool njsVariable_initForQuery(njsVariable *vars, uint32_t numVars,
         dpiStmt *handle, njsBaton *baton)
 {
     dpiQueryInfo queryInfo;
-    uint32_t i;
+    uint32_t i, j;
 
     // populate variables with query metadata
     for (i = 0; i < numVars; i++) {
@@ -708,6 +1100,24 @@ bool njsVariable_initForQuery(njsVariable *vars, uint32_t numVars,
                         queryInfo.typeInfo.oracleTypeNum, i + 1);
         }
 
+        // create a cache for interning the strings fetched for the column, if
+        // requested by fetchInfo
+        if (vars[i].nativeTypeNum != DPI_NATIVE_TYPE_BYTES ||
+                vars[i].varTypeNum == DPI_ORACLE_TYPE_RAW ||
+                vars[i].varTypeNum == DPI_ORACLE_TYPE_LONG_RAW)
+            continue;
+        for (j = 0; j < baton->numFetchInfo; j++) {
+            if (!baton->fetchInfo[j].intern ||
+                    queryInfo.nameLength != baton->fetchInfo[j].nameLength ||
+                    strncmp(queryInfo.name, baton->fetchInfo[j].name,
+                            queryInfo.nameLength) != 0)
+                continue;
+            vars[i].stringCache = calloc(1, sizeof(njsStringCache));
+            if (!vars[i].stringCache)
+                return njsBaton_setError(baton, errInsufficientMemory);
+            break;
+        }
+
     }
 
     return true;
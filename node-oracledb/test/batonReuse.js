@@ -0,0 +1,87 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   267. batonReuse.js
+ *
+ * DESCRIPTION
+ *   Test cases for the reuse of the memory that holds the state of each
+ *   asynchronous call.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('267. batonReuse.js', function() {
+  let conn;
+
+  before(async function() {
+    conn = await oracledb.getConnection(dbconfig);
+  });
+
+  after(async function() {
+    await conn.close();
+  });
+
+  it('267.1 steady state calls do not allocate batons', async function() {
+    await conn.execute("SELECT 1 FROM dual");
+    await conn.ping();
+    await conn.commit();
+    const before = oracledb._batonStatistics;
+    for (let i = 0; i < 100; i++) {
+      await conn.execute("SELECT :1 FROM dual", [i]);
+      await conn.ping();
+      await conn.commit();
+    }
+    const after = oracledb._batonStatistics;
+    should.strictEqual(after.allocated, before.allocated);
+    should.ok(after.reused - before.reused >= 300);
+  });
+
+  it('267.2 concurrent calls allocate only what is in use', async function() {
+    const before = oracledb._batonStatistics;
+    const conns = [];
+    for (let i = 0; i < 4; i++)
+      conns.push(await oracledb.getConnection(dbconfig));
+    for (let i = 0; i < 10; i++) {
+      await Promise.all(conns.map(c => c.execute("SELECT 1 FROM dual")));
+    }
+    for (const c of conns)
+      await c.close();
+    const after = oracledb._batonStatistics;
+    should.ok(after.allocated - before.allocated <= 4);
+    should.ok(after.free >= 4);
+  });
+
+  it('267.3 state of a failed call is not seen by the next call', async function() {
+    await should(conn.execute("SELECT * FROM nodb_no_such_table")).
+      be.rejectedWith(/^ORA-00942:/);
+    const result = await conn.execute("SELECT 'x' FROM dual");
+    should.deepEqual(result.rows, [["x"]]);
+    await should(conn.execute("SELECT :1 FROM dual", [])).
+      be.rejectedWith(/^ORA-01008:/);
+    const result2 = await conn.execute("SELECT 2 FROM dual");
+    should.deepEqual(result2.rows, [[2]]);
+  });
+
+});
@@ -0,0 +1,105 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * NAME
+ *   completions.js
+ *
+ * DESCRIPTION
+ *   Measures the number of small queries per second whose completions can be
+ *   handled by the main thread when many connections of a pool execute them
+ *   concurrently, for example:
+ *
+ *     node test/benchmarks/completions.js [numConnections] [numQueries]
+ *         [iterations]
+ *
+ *   Each configuration is run with the thread pool used for database calls,
+ *   which completes many calls for each wakeup of the main thread, and with
+ *   oracledb.dbThreadPoolSize set to 0, which uses the Node.js worker thread
+ *   pool and completes each call separately. The event loop utilization is
+ *   also reported; the lower it is, the less time the main thread spent on
+ *   each completion. The best rate of all of the iterations is reported in
+ *   order to reduce the effect of noise.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const dbconfig = require('../dbconfig.js');
+const { performance } = require('perf_hooks');
+
+const numConnections = Number(process.argv[2]) || 16;
+const numQueries = Number(process.argv[3]) || 50000;
+const iterations = Number(process.argv[4]) || 3;
+
+const configurations = [
+  [ "dbThreadPoolSize 4", 4 ],
+  [ "dbThreadPoolSize 0", 0 ]
+];
+
+// executes the queries on all of the connections until the requested number
+// have been completed
+async function runQueries(conns) {
+  let numStarted = 0;
+  const work = async function(conn) {
+    while (numStarted < numQueries) {
+      numStarted++;
+      await conn.execute("select 1 from dual");
+    }
+  };
+  await Promise.all(conns.map(work));
+}
+
+async function run() {
+  for (const [name, size] of configurations) {
+    let pool;
+    oracledb.dbThreadPoolSize = size;
+    try {
+      pool = await oracledb.createPool({...dbconfig, poolMin: numConnections,
+        poolMax: numConnections, poolIncrement: 0});
+      const conns = [];
+      for (let i = 0; i < numConnections; i++)
+        conns.push(await pool.getConnection());
+      await Promise.all(conns.map(conn => conn.execute("select 1 from dual")));
+      let bestRate = 0, bestUtilization = 0;
+      for (let i = 0; i < iterations; i++) {
+        const startUtilization = performance.eventLoopUtilization();
+        const start = process.hrtime();
+        await runQueries(conns);
+        const [seconds, nanoseconds] = process.hrtime(start);
+        const utilization =
+            performance.eventLoopUtilization(startUtilization).utilization;
+        const rate = numQueries / (seconds + nanoseconds / 1e9);
+        if (rate > bestRate) {
+          bestRate = rate;
+          bestUtilization = utilization;
+        }
+      }
+      console.log(`${name.padEnd(20)} ${Math.round(bestRate)} completions/sec,`,
+        `event loop utilization ${bestUtilization.toFixed(2)}`);
+      for (const conn of conns)
+        await conn.close();
+    } catch (err) {
+      console.error(err);
+    } finally {
+      if (pool) {
+        await pool.close(0);
+      }
+    }
+  }
+}
+
+run();
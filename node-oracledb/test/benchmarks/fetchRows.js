@@ -0,0 +1,88 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * NAME
+ *   fetchRows.js
+ *
+ * DESCRIPTION
+ *   Measures the number of rows per second that can be fetched for each
+ *   outFormat. Run it against builds with and without a change to compare
+ *   them, for example:
+ *
+ *     node test/benchmarks/fetchRows.js [numRows] [numColumns] [iterations]
+ *
+ *   The query is generated from DUAL so no tables are created. The rows are
+ *   fetched in full by each execution and the best rate of all of the
+ *   iterations is reported in order to reduce the effect of noise.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const dbconfig = require('../dbconfig.js');
+
+const numRows = Number(process.argv[2]) || 100000;
+const numColumns = Number(process.argv[3]) || 8;
+const iterations = Number(process.argv[4]) || 5;
+
+const outFormats = [
+  [ "OUT_FORMAT_ARRAY", oracledb.OUT_FORMAT_ARRAY ],
+  [ "OUT_FORMAT_OBJECT", oracledb.OUT_FORMAT_OBJECT ]
+];
+
+// build a query returning a mix of numbers and strings
+function getSql() {
+  const columns = [];
+  for (let i = 0; i < numColumns; i++) {
+    if (i % 2 === 0) {
+      columns.push(`level + ${i} as column_${i}`);
+    } else {
+      columns.push(`'Value ' || level as column_${i}`);
+    }
+  }
+  return `select ${columns.join(", ")} from dual connect by level <= :n`;
+}
+
+async function run() {
+  let conn;
+  try {
+    conn = await oracledb.getConnection(dbconfig);
+    const sql = getSql();
+    for (const [name, outFormat] of outFormats) {
+      const options = { outFormat: outFormat, fetchArraySize: 1000,
+        maxRows: 0 };
+      await conn.execute(sql, [100], options);        // warm up
+      let bestRate = 0;
+      for (let i = 0; i < iterations; i++) {
+        const start = process.hrtime();
+        const result = await conn.execute(sql, [numRows], options);
+        const [seconds, nanoseconds] = process.hrtime(start);
+        const rate = result.rows.length / (seconds + nanoseconds / 1e9);
+        bestRate = Math.max(bestRate, rate);
+      }
+      console.log(`${name.padEnd(20)} ${Math.round(bestRate)} rows/sec`);
+    }
+  } catch (err) {
+    console.error(err);
+  } finally {
+    if (conn) {
+      await conn.close();
+    }
+  }
+}
+
+run();
@@ -0,0 +1,94 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * NAME
+ *   queryStream.js
+ *
+ * DESCRIPTION
+ *   Measures the number of rows per second that can be piped from a
+ *   QueryStream into a writable stream that discards them, streaming rows
+ *   one at a time and in batches, with and without fetching ahead, for
+ *   example:
+ *
+ *     node test/benchmarks/queryStream.js [numRows] [iterations]
+ *
+ *   The best rate of all of the iterations is reported in order to reduce
+ *   the effect of noise.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const dbconfig = require('../dbconfig.js');
+const { pipeline, Writable } = require('stream');
+const { promisify } = require('util');
+
+const numRows = Number(process.argv[2]) || 1000000;
+const iterations = Number(process.argv[3]) || 3;
+
+const sql = `select level, 'Value ' || level, sysdate + level
+             from dual connect by level <= :n`;
+
+const modes = [
+  [ "rows", {} ],
+  [ "rows, fetchAhead: 2", { fetchAhead: 2 } ],
+  [ "batches", { emitBatches: true } ],
+  [ "batches, fetchAhead: 2", { emitBatches: true, fetchAhead: 2 } ]
+];
+
+// pipes all of the rows of the query into a stream that discards them and
+// returns the number of rows streamed
+async function streamRows(conn, n, options) {
+  let rowsStreamed = 0;
+  const sink = new Writable({
+    objectMode: true,
+    write(chunk, encoding, callback) {
+      rowsStreamed += (options.emitBatches) ? chunk.length : 1;
+      callback();
+    }
+  });
+  await promisify(pipeline)(conn.queryStream(sql, [n], options), sink);
+  return rowsStreamed;
+}
+
+async function run() {
+  let conn;
+  try {
+    conn = await oracledb.getConnection(dbconfig);
+    for (const [name, modeOptions] of modes) {
+      const options = Object.assign({ fetchArraySize: 1000 }, modeOptions);
+      await streamRows(conn, 100, options);             // warm up
+      let bestRate = 0;
+      for (let i = 0; i < iterations; i++) {
+        const start = process.hrtime();
+        const rowsStreamed = await streamRows(conn, numRows, options);
+        const [seconds, nanoseconds] = process.hrtime(start);
+        const rate = rowsStreamed / (seconds + nanoseconds / 1e9);
+        bestRate = Math.max(bestRate, rate);
+      }
+      console.log(`${name.padEnd(24)} ${Math.round(bestRate)} rows/sec`);
+    }
+  } catch (err) {
+    console.error(err);
+  } finally {
+    if (conn) {
+      await conn.close();
+    }
+  }
+}
+
+run();
@@ -35,6 +35,9 @@ describe('18. constants.js', function() {
   it('18.1 Query outFormat Constants', () => {
     should.strictEqual(4001, oracledb.OUT_FORMAT_ARRAY);
     should.strictEqual(4002, oracledb.OUT_FORMAT_OBJECT);
+    should.strictEqual(4003, oracledb.OUT_FORMAT_COLUMNS);
+    should.strictEqual(4004, oracledb.OUT_FORMAT_JSON);
+    should.strictEqual(4005, oracledb.OUT_FORMAT_NDJSON);
   });
 
   it('18.2 Node-oracledb Type Constants', () => {
@@ -0,0 +1,113 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   266. dbThreadPool.js
+ *
+ * DESCRIPTION
+ *   Test cases for the thread pool used to perform database calls.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb  = require('oracledb');
+const should    = require('should');
+const crypto    = require('crypto');
+const util      = require('util');
+const dbconfig  = require('./dbconfig.js');
+const testsUtil = require('./testsUtil.js');
+
+describe('266. dbThreadPool.js', function() {
+  const sleepSql = "BEGIN DBMS_SESSION.SLEEP(:sleepsec); END;";
+  let defaultSize;
+  let isRunnable = true;
+
+  before(async function() {
+    defaultSize = oracledb.dbThreadPoolSize;
+    isRunnable = await testsUtil.checkPrerequisites();
+  });
+
+  afterEach(function() {
+    oracledb.dbThreadPoolSize = defaultSize;
+  });
+
+  it('266.1 has the expected default value and can be changed', function() {
+    should.strictEqual(defaultSize, 4);
+    oracledb.dbThreadPoolSize = 10;
+    should.strictEqual(oracledb.dbThreadPoolSize, 10);
+    oracledb.dbThreadPoolSize = 0;
+    should.strictEqual(oracledb.dbThreadPoolSize, 0);
+  });
+
+  it('266.2 negative - invalid values are rejected', function() {
+    should.throws(() => { oracledb.dbThreadPoolSize = -1; }, /^NJS-004:/);
+    should.throws(() => { oracledb.dbThreadPoolSize = 1.5; }, /^NJS-004:/);
+    should.throws(() => { oracledb.dbThreadPoolSize = "4"; }, /^NJS-004:/);
+    should.strictEqual(oracledb.dbThreadPoolSize, defaultSize);
+  });
+
+  it('266.3 database calls do not hold Node.js worker threads', async function() {
+    if (!isRunnable) this.skip();
+    const conns = [];
+    for (let i = 0; i < 4; i++)
+      conns.push(await oracledb.getConnection(dbconfig));
+    try {
+      const sleeps = conns.map(conn => conn.execute(sleepSql, [3]));
+      const start = Date.now();
+      await util.promisify(crypto.pbkdf2)("pw", "salt", 1, 32, "sha256");
+      should.ok(Date.now() - start < 2000);
+      await Promise.all(sleeps);
+    } finally {
+      for (const conn of conns)
+        await conn.close();
+    }
+  });
+
+  it('266.4 each pool adds a thread for each connection', async function() {
+    if (!isRunnable) this.skip();
+    oracledb.dbThreadPoolSize = 1;
+    const pool = await oracledb.createPool({...dbconfig, poolMin: 6,
+      poolMax: 6});
+    try {
+      const conns = [];
+      for (let i = 0; i < 6; i++)
+        conns.push(await pool.getConnection());
+      const start = Date.now();
+      await Promise.all(conns.map(conn => conn.execute(sleepSql, [2])));
+      should.ok(Date.now() - start < 4000);
+      for (const conn of conns)
+        await conn.close();
+    } finally {
+      await pool.close(0);
+    }
+  });
+
+  it('266.5 uses the Node.js worker threads when the size is 0', async function() {
+    oracledb.dbThreadPoolSize = 0;
+    const conn = await oracledb.getConnection(dbconfig);
+    try {
+      const result = await conn.execute("SELECT 1 FROM dual");
+      should.deepEqual(result.rows, [[1]]);
+    } finally {
+      await conn.close();
+    }
+  });
+
+});
@@ -1038,6 +1038,21 @@ describe('246. dupColNames1.js', function() {
       should.equal(row_data[0].abc, "X");
       should.equal(row_data[0].ABC, "X");
     });
+
+    it('246.2.18 Column names with special characters create plain objects', async function() {
+      let result = await connection.execute(
+        `SELECT dummy "it's", dummy "c\\d", dummy "this", dummy "a b"
+         FROM dual CONNECT BY LEVEL <= 2`, [], { resultSet: true });
+      let row_data = await traverse_results(result.resultSet);
+      should.equal(row_data.length, 2);
+      for (const row of row_data) {
+        should.deepEqual(Object.keys(row), ["it's", 'c\\d', 'this', 'a b']);
+        should.equal(row["it's"], "X");
+        should.equal(row['c\\d'], "X");
+        should.equal(row.this, "X");
+        should.strictEqual(Object.getPrototypeOf(row), Object.prototype);
+      }
+    });
   });
 
 });
@@ -0,0 +1,158 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   260. fetchAhead.js
+ *
+ * DESCRIPTION
+ *   Test cases for fetching rows of a ResultSet ahead of time with
+ *   oracledb.fetchAhead and the execute() option fetchAhead.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('260. fetchAhead.js', function() {
+  let conn = null;
+  const defaultFetchAhead = oracledb.fetchAhead;
+  const numRows = 1234;
+  const sql = "SELECT level FROM dual CONNECT BY level <= " + numRows;
+
+  // verifies the rows have the ids from firstId to lastId
+  function checkRows(rows, firstId, lastId) {
+    should.equal(rows.length, lastId - firstId + 1);
+    for (let i = 0; i < rows.length; i++) {
+      should.strictEqual(rows[i][0], firstId + i);
+    }
+  }
+
+  before(async function() {
+    conn = await oracledb.getConnection(dbconfig);
+  });
+
+  after(async function() {
+    oracledb.fetchAhead = defaultFetchAhead;
+    await conn.close();
+  });
+
+  afterEach(function() {
+    oracledb.fetchAhead = defaultFetchAhead;
+  });
+
+  it('260.1 has the expected default value', function() {
+    should.strictEqual(oracledb.fetchAhead, 0);
+  });
+
+  it('260.2 negative - rejects invalid values', async function() {
+    should.throws(() => { oracledb.fetchAhead = -1; }, /^NJS-004:/);
+    should.throws(() => { oracledb.fetchAhead = "2"; }, /^NJS-004:/);
+    await should(conn.execute(sql, [], { fetchAhead: -1, resultSet: true }))
+      .be.rejectedWith(/^NJS-007:/);
+  });
+
+  it('260.3 fetches all rows with getRow()', async function() {
+    const result = await conn.execute(sql, [],
+      { fetchAhead: 2, fetchArraySize: 50, resultSet: true });
+    const rs = result.resultSet;
+    const rows = [];
+    let row;
+    while ((row = await rs.getRow())) {
+      rows.push(row);
+    }
+    checkRows(rows, 1, numRows);
+    await rs.close();
+  });
+
+  it('260.4 fetches all rows with getRows()', async function() {
+    for (const fetchAhead of [1, 3, 100]) {
+      oracledb.fetchAhead = fetchAhead;
+      const result = await conn.execute(sql, [],
+        { fetchArraySize: 70, resultSet: true });
+      const rs = result.resultSet;
+      checkRows(await rs.getRows(1), 1, 1);
+      checkRows(await rs.getRows(150), 2, 151);
+      checkRows(await rs.getRows(70), 152, 221);
+      should.deepEqual(await rs.getRow(), [222]);
+      checkRows(await rs.getRows(), 223, numRows);
+      should.deepEqual(await rs.getRows(10), []);
+      should.strictEqual(await rs.getRow(), undefined);
+      await rs.close();
+    }
+  });
+
+  it('260.5 closes a ResultSet while rows are being fetched ahead', async function() {
+    const result = await conn.execute(sql, [],
+      { fetchAhead: 5, fetchArraySize: 10, resultSet: true });
+    const rs = result.resultSet;
+    checkRows(await rs.getRows(10), 1, 10);
+    await rs.close();
+    await should(rs.getRow()).be.rejectedWith(/^NJS-018:/);
+  });
+
+  it('260.6 fetches all rows with queryStream()', async function() {
+    const stream = conn.queryStream(sql, [],
+      { fetchAhead: 2, fetchArraySize: 25 });
+    const rows = [];
+    await new Promise((resolve, reject) => {
+      stream.on('data', row => rows.push(row));
+      stream.on('error', reject);
+      stream.on('close', resolve);
+    });
+    checkRows(rows, 1, numRows);
+  });
+
+  it('260.7 destroys a queryStream while rows are being fetched ahead', async function() {
+    const stream = conn.queryStream(sql, [],
+      { fetchAhead: 3, fetchArraySize: 20 });
+    let numRowsRead = 0;
+    await new Promise((resolve, reject) => {
+      stream.on('data', () => {
+        if (++numRowsRead == 30)
+          stream.destroy();
+      });
+      stream.on('error', reject);
+      stream.on('close', resolve);
+    });
+    should.equal(numRowsRead, 30);
+    const result = await conn.execute("SELECT 1 FROM dual");
+    should.deepEqual(result.rows, [[1]]);
+  });
+
+  it('260.8 is ignored for direct fetches', async function() {
+    const result = await conn.execute(sql, [],
+      { fetchAhead: 2, fetchArraySize: 100 });
+    checkRows(result.rows, 1, numRows);
+  });
+
+  it('260.9 executes on the connection while rows are being fetched ahead', async function() {
+    const result = await conn.execute(sql, [],
+      { fetchAhead: 4, fetchArraySize: 30, resultSet: true });
+    const rs = result.resultSet;
+    checkRows(await rs.getRows(30), 1, 30);
+    const result2 = await conn.execute("SELECT 2 FROM dual");
+    should.deepEqual(result2.rows, [[2]]);
+    checkRows(await rs.getRows(), 31, numRows);
+    await rs.close();
+  });
+
+});
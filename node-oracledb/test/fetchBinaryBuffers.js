@@ -0,0 +1,153 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   262. fetchBinaryBuffers.js
+ *
+ * DESCRIPTION
+ *   Test cases for fetching RAW values and BLOBs as Buffers, both small values
+ *   (which are copied) and large values (which refer to memory allocated by
+ *   node-oracledb directly). The Buffers must remain valid after the rows that
+ *   share their memory have been garbage collected.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('262. fetchBinaryBuffers.js', function() {
+  let conn = null;
+  const tableName = "nodb_fetchBinaryBuffers";
+  const numRows = 300;
+  const create_table_sql =
+    `BEGIN
+      DECLARE
+        e_table_missing EXCEPTION;
+        PRAGMA EXCEPTION_INIT(e_table_missing, -00942);
+      BEGIN
+        EXECUTE IMMEDIATE ('DROP TABLE ` + tableName + ` PURGE');
+      EXCEPTION
+        WHEN e_table_missing
+        THEN NULL;
+      END;
+      EXECUTE IMMEDIATE ('
+        CREATE TABLE ` + tableName + ` (
+          id NUMBER,
+          small_raw RAW(16),
+          large_raw RAW(2000),
+          blob_col BLOB
+        )
+      ');
+    END;`;
+
+  // returns the bytes expected for the given id and length
+  function getBytes(id, length) {
+    const buf = Buffer.alloc(length);
+    for (let i = 0; i < length; i++) {
+      buf[i] = (id * 7 + i) % 256;
+    }
+    return buf;
+  }
+
+  // verifies the rows have the expected values
+  function checkRows(rows) {
+    should.equal(rows.length, numRows);
+    for (let i = 0; i < numRows; i++) {
+      const id = i + 1;
+      should.deepEqual(rows[i][0], getBytes(id, 16));
+      should.deepEqual(rows[i][1], getBytes(id, 1000 + id));
+      should.deepEqual(rows[i][2], getBytes(id, 5000 + id));
+    }
+  }
+
+  before(async function() {
+    conn = await oracledb.getConnection(dbconfig);
+    await conn.execute(create_table_sql);
+    const binds = [];
+    for (let id = 1; id <= numRows; id++) {
+      binds.push([id, getBytes(id, 16), getBytes(id, 1000 + id),
+        getBytes(id, 5000 + id)]);
+    }
+    await conn.executeMany(
+      "INSERT INTO " + tableName + " VALUES (:1, :2, :3, :4)", binds);
+    await conn.commit();
+  });
+
+  after(async function() {
+    await conn.execute("DROP TABLE " + tableName + " PURGE");
+    await conn.close();
+  });
+
+  const sql = "SELECT small_raw, large_raw, blob_col FROM " + tableName +
+      " ORDER BY id";
+
+  it('262.1 fetches RAW and BLOB values as Buffers', async function() {
+    const result = await conn.execute(sql, [],
+      { fetchArraySize: 25, fetchInfo: { BLOB_COL: { type: oracledb.BUFFER } } });
+    checkRows(result.rows);
+  });
+
+  it('262.2 Buffers remain valid when other rows are collected', async function() {
+    const result = await conn.execute(sql, [],
+      { fetchArraySize: 25, fetchInfo: { BLOB_COL: { type: oracledb.BUFFER } } });
+    const kept = result.rows.filter((row, i) => i % 50 === 0);
+    result.rows = null;
+    if (global.gc) {
+      global.gc();
+    }
+    await new Promise(resolve => setTimeout(resolve, 100));
+    for (let i = 0; i < kept.length; i++) {
+      const id = i * 50 + 1;
+      should.deepEqual(kept[i][1], getBytes(id, 1000 + id));
+      should.deepEqual(kept[i][2], getBytes(id, 5000 + id));
+    }
+  });
+
+  it('262.3 Buffers can be modified independently', async function() {
+    const result = await conn.execute(sql, [],
+      { maxRows: 2, fetchInfo: { BLOB_COL: { type: oracledb.BUFFER } } });
+    result.rows[0][1].fill(0);
+    should.deepEqual(result.rows[1][1], getBytes(2, 1002));
+  });
+
+  it('262.4 reads BLOBs with getData() and streams', async function() {
+    const result = await conn.execute(
+      "SELECT blob_col FROM " + tableName + " WHERE id = 300");
+    const lob = result.rows[0][0];
+    should.deepEqual(await lob.getData(), getBytes(300, 5300));
+    await lob.close();
+    const result2 = await conn.execute(
+      "SELECT blob_col FROM " + tableName + " WHERE id = 300");
+    const lob2 = result2.rows[0][0];
+    lob2.pieceSize = 1500;
+    const chunks = [];
+    await new Promise((resolve, reject) => {
+      lob2.on('data', chunk => chunks.push(chunk));
+      lob2.on('error', reject);
+      lob2.on('end', resolve);
+    });
+    should.deepEqual(chunks.map(chunk => chunk.length), [1500, 1500, 1500, 800]);
+    should.deepEqual(Buffer.concat(chunks), getBytes(300, 5300));
+    lob2.destroy();
+  });
+
+});
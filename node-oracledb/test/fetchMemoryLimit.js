@@ -0,0 +1,146 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   259. fetchMemoryLimit.js
+ *
+ * DESCRIPTION
+ *   Test cases for fetching all rows of a query in the worker thread, limited
+ *   by oracledb.fetchMemoryLimit.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('259. fetchMemoryLimit.js', function() {
+  let conn = null;
+  const defaultLimit = oracledb.fetchMemoryLimit;
+  const numRows = 2500;
+  const sql =
+    `SELECT level AS id,
+            CASE WHEN MOD(level, 7) = 0 THEN NULL
+                 ELSE RPAD('x', MOD(level, 50) + 1, 'y') END AS name,
+            DATE '2021-01-01' + level AS created,
+            HEXTORAW(CASE WHEN MOD(level, 5) = 0 THEN NULL ELSE '0A0B' END)
+              AS payload
+     FROM dual CONNECT BY level <= ` + numRows;
+
+  // verifies the rows have the ids from 1 to the given number of rows
+  function checkRows(rows, expectedRows) {
+    should.equal(rows.length, expectedRows);
+    for (let i = 0; i < expectedRows; i++) {
+      const id = i + 1;
+      const row = rows[i];
+      should.strictEqual(row[0], id);
+      if (id % 7 === 0) {
+        should.strictEqual(row[1], null);
+      } else {
+        should.strictEqual(row[1], 'x' + 'y'.repeat(id % 50));
+      }
+      should.equal(row[2].getTime(), new Date(2021, 0, 1 + id).getTime());
+      if (id % 5 === 0) {
+        should.strictEqual(row[3], null);
+      } else {
+        should.deepEqual(row[3], Buffer.from([10, 11]));
+      }
+    }
+  }
+
+  before(async function() {
+    conn = await oracledb.getConnection(dbconfig);
+  });
+
+  after(async function() {
+    oracledb.fetchMemoryLimit = defaultLimit;
+    await conn.close();
+  });
+
+  afterEach(function() {
+    oracledb.fetchMemoryLimit = defaultLimit;
+  });
+
+  it('259.1 has the expected default value', function() {
+    should.strictEqual(oracledb.fetchMemoryLimit, 64 * 1024 * 1024);
+  });
+
+  it('259.2 fetches all rows with different limits', async function() {
+    for (const limit of [0, 1, 4096, 65536, defaultLimit]) {
+      oracledb.fetchMemoryLimit = limit;
+      const result = await conn.execute(sql, [], { fetchArraySize: 97 });
+      checkRows(result.rows, numRows);
+    }
+  });
+
+  it('259.3 honors maxRows', async function() {
+    for (const limit of [0, 4096, defaultLimit]) {
+      oracledb.fetchMemoryLimit = limit;
+      for (const maxRows of [1, 96, 97, 98, 1000, numRows, numRows + 1]) {
+        const result = await conn.execute(sql, [],
+          { fetchArraySize: 97, maxRows: maxRows });
+        checkRows(result.rows, Math.min(maxRows, numRows));
+      }
+    }
+  });
+
+  it('259.4 fetches all remaining rows with getRows()', async function() {
+    oracledb.fetchMemoryLimit = 4096;
+    const result = await conn.execute(sql, [],
+      { fetchArraySize: 100, resultSet: true });
+    const rs = result.resultSet;
+    const firstRow = await rs.getRow();
+    should.strictEqual(firstRow[0], 1);
+    const rows = await rs.getRows();
+    should.equal(rows.length, numRows - 1);
+    should.strictEqual(rows[0][0], 2);
+    should.strictEqual(rows[99][0], 101);
+    should.strictEqual(rows[numRows - 2][0], numRows);
+    await rs.close();
+  });
+
+  it('259.5 fetches all rows as columns', async function() {
+    oracledb.fetchMemoryLimit = 4096;
+    const result = await conn.execute(sql, [],
+      { fetchArraySize: 97, outFormat: oracledb.OUT_FORMAT_COLUMNS });
+    const ids = result.rows[0].values;
+    should.equal(ids.length, numRows);
+    for (let i = 0; i < numRows; i++) {
+      should.strictEqual(ids[i], i + 1);
+    }
+    const names = result.rows[1];
+    should.equal(names.data.toString('utf8', names.offsets[0],
+      names.offsets[1]), 'xy');
+  });
+
+  it('259.6 fetches LOBs one batch at a time', async function() {
+    oracledb.fetchMemoryLimit = defaultLimit;
+    const result = await conn.execute(
+      `SELECT level, TO_CLOB('clob ' || level) FROM dual
+       CONNECT BY level <= 250`, [], { fetchArraySize: 40 });
+    should.equal(result.rows.length, 250);
+    should.equal(await result.rows[249][1].getData(), 'clob 250');
+    for (const row of result.rows) {
+      await row[1].close();
+    }
+  });
+
+});
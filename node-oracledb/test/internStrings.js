@@ -0,0 +1,183 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   263. internStrings.js
+ *
+ * DESCRIPTION
+ *   Test cases for interning the strings fetched for columns with the
+ *   fetchInfo property "intern".
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('263. internStrings.js', function() {
+  let conn = null;
+  const tableName = "nodb_internStrings";
+  const numRows = 500;
+  const statuses = ["OPEN", "CLOSED", "PENDING"];
+  const create_table_sql =
+    `BEGIN
+      DECLARE
+        e_table_missing EXCEPTION;
+        PRAGMA EXCEPTION_INIT(e_table_missing, -00942);
+      BEGIN
+        EXECUTE IMMEDIATE ('DROP TABLE ` + tableName + ` PURGE');
+      EXCEPTION
+        WHEN e_table_missing
+        THEN NULL;
+      END;
+      EXECUTE IMMEDIATE ('
+        CREATE TABLE ` + tableName + ` (
+          id NUMBER,
+          status VARCHAR2(10),
+          description VARCHAR2(400)
+        )
+      ');
+    END;`;
+  const insertSql =
+    `DECLARE
+       i NUMBER;
+     BEGIN
+       FOR i IN 1..` + numRows + ` LOOP
+         INSERT INTO ` + tableName + ` VALUES (i,
+           CASE MOD(i, 4) WHEN 0 THEN NULL WHEN 1 THEN 'OPEN'
+             WHEN 2 THEN 'CLOSED' ELSE 'PENDING' END,
+           CASE WHEN MOD(i, 2) = 0 THEN RPAD('x', 300, 'x')
+             ELSE 'Row ' || i END);
+       END LOOP;
+     END;`;
+  const sql = "SELECT id, status, description FROM " + tableName +
+      " ORDER BY id";
+
+  // returns the status expected for the given id
+  function getStatus(id) {
+    return (id % 4 === 0) ? null : statuses[(id % 4) - 1];
+  }
+
+  // verifies the rows have the expected values
+  function checkRows(rows, firstId) {
+    for (let i = 0; i < rows.length; i++) {
+      const id = firstId + i;
+      should.equal(rows[i][0], id);
+      should.strictEqual(rows[i][1], getStatus(id));
+      should.equal(rows[i][2],
+        (id % 2 === 0) ? "x".repeat(300) : "Row " + id);
+    }
+  }
+
+  before(async function() {
+    conn = await oracledb.getConnection(dbconfig);
+    await conn.execute(create_table_sql);
+    await conn.execute(insertSql);
+    await conn.commit();
+  });
+
+  after(async function() {
+    await conn.execute("DROP TABLE " + tableName + " PURGE");
+    await conn.close();
+  });
+
+  it('263.1 interns the strings of a column', async function() {
+    const result = await conn.execute(sql, [],
+      { fetchArraySize: 37, fetchInfo: { STATUS: { intern: true } } });
+    should.equal(result.rows.length, numRows);
+    checkRows(result.rows, 1);
+    const stats = result.internStatistics.STATUS;
+    should.equal(stats.entries, 3);
+    should.equal(stats.misses, 3);
+    should.equal(stats.hits, numRows - numRows / 4 - 3);
+  });
+
+  it('263.2 returns no statistics if interning is not used', async function() {
+    const result = await conn.execute(sql);
+    checkRows(result.rows, 1);
+    should.not.exist(result.internStatistics);
+  });
+
+  it('263.3 does not intern values that are too long', async function() {
+    const result = await conn.execute(sql, [],
+      { fetchInfo: { DESCRIPTION: { type: oracledb.STRING, intern: true } } });
+    checkRows(result.rows, 1);
+    const stats = result.internStatistics.DESCRIPTION;
+    should.equal(stats.hits, 0);
+    should.equal(stats.misses, numRows);
+    should.equal(stats.entries, numRows / 2);
+  });
+
+  it('263.4 interns strings across ResultSet fetches', async function() {
+    const result = await conn.execute(sql, [],
+      { resultSet: true, fetchInfo: { STATUS: { intern: true } } });
+    const rs = result.resultSet;
+    checkRows(await rs.getRows(100), 1);
+    should.equal(rs.internStatistics.STATUS.entries, 3);
+    checkRows(await rs.getRows(100), 101);
+    should.equal(rs.internStatistics.STATUS.misses, 3);
+    await rs.close();
+    should.equal(rs.internStatistics.STATUS.hits, 150 - 3);
+  });
+
+  it('263.5 interns strings with OUT_FORMAT_OBJECT', async function() {
+    const result = await conn.execute(sql, [],
+      { outFormat: oracledb.OUT_FORMAT_OBJECT,
+        fetchInfo: { STATUS: { intern: true } } });
+    for (let i = 0; i < result.rows.length; i++) {
+      should.strictEqual(result.rows[i].STATUS, getStatus(i + 1));
+    }
+    should.equal(result.internStatistics.STATUS.entries, 3);
+  });
+
+  it('263.6 negative - invalid value for intern', async function() {
+    await should(conn.execute(sql, [],
+      { fetchInfo: { STATUS: { intern: 1 } } })).be.rejectedWith(/^NJS-007:/);
+  });
+
+  it('263.7 returns statistics when all rows fit in the first fetch', async function() {
+    const smallSql = "SELECT id, status, description FROM " + tableName +
+        " WHERE id <= 20 ORDER BY id";
+    const result = await conn.execute(smallSql, [],
+      { fetchArraySize: 100, fetchInfo: { STATUS: { intern: true } } });
+    should.equal(result.rows.length, 20);
+    checkRows(result.rows, 1);
+    should.not.exist(result.resultSet);
+    const stats = result.internStatistics.STATUS;
+    should.equal(stats.entries, 3);
+    should.equal(stats.misses, 3);
+    should.equal(stats.hits, 20 - 5 - 3);
+  });
+
+  it('263.8 returns statistics when maxRows is within the first fetch', async function() {
+    const result = await conn.execute(sql, [],
+      { maxRows: 10, fetchArraySize: 50,
+        fetchInfo: { STATUS: { intern: true } } });
+    should.equal(result.rows.length, 10);
+    checkRows(result.rows, 1);
+    should.not.exist(result.resultSet);
+    const stats = result.internStatistics.STATUS;
+    should.equal(stats.entries, 3);
+    should.equal(stats.misses, 3);
+    should.equal(stats.hits, 10 - 2 - 3);
+  });
+
+});
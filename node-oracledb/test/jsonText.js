@@ -0,0 +1,190 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   265. jsonText.js
+ *
+ * DESCRIPTION
+ *   Test cases for fetching rows as JSON text with outFormat OUT_FORMAT_JSON
+ *   and OUT_FORMAT_NDJSON.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('265. jsonText.js', function() {
+  let conn = null;
+  const tableName = "nodb_jsonText";
+  const numRows = 120;
+  const create_table_sql =
+    `BEGIN
+      DECLARE
+        e_table_missing EXCEPTION;
+        PRAGMA EXCEPTION_INIT(e_table_missing, -00942);
+      BEGIN
+        EXECUTE IMMEDIATE ('DROP TABLE ` + tableName + ` PURGE');
+      EXCEPTION
+        WHEN e_table_missing
+        THEN NULL;
+      END;
+      EXECUTE IMMEDIATE ('
+        CREATE TABLE ` + tableName + ` (
+          id NUMBER,
+          name VARCHAR2(40),
+          amount NUMBER,
+          created DATE,
+          payload RAW(10)
+        )
+      ');
+    END;`;
+  const insertSql =
+    `DECLARE
+       i NUMBER;
+     BEGIN
+       FOR i IN 1..` + numRows + ` LOOP
+         INSERT INTO ` + tableName + ` VALUES (i,
+           CASE WHEN MOD(i, 3) = 0 THEN NULL
+                ELSE 'Name "' || i || '"' || CHR(10) || CHR(9) END,
+           i / 8, DATE '2021-01-01' + i, HEXTORAW('0A0B'));
+       END LOOP;
+     END;`;
+  const sql = "SELECT id, name, amount, created, payload FROM " + tableName +
+      " ORDER BY id";
+
+  // returns the JSON text of the rows fetched with OUT_FORMAT_OBJECT
+  async function getExpectedText(query, options) {
+    const result = await conn.execute(query, [],
+      Object.assign({ outFormat: oracledb.OUT_FORMAT_OBJECT }, options));
+    return JSON.stringify(result.rows);
+  }
+
+  // returns the given rows as newline-delimited JSON text
+  function toNdjson(text) {
+    return JSON.parse(text).map(row => JSON.stringify(row) + "\n").join("");
+  }
+
+  before(async function() {
+    conn = await oracledb.getConnection(dbconfig);
+    await conn.execute(create_table_sql);
+    await conn.execute(insertSql);
+    await conn.commit();
+  });
+
+  after(async function() {
+    await conn.execute("DROP TABLE " + tableName + " PURGE");
+    await conn.close();
+  });
+
+  it('265.1 fetches all rows as a JSON array', async function() {
+    const expected = await getExpectedText(sql);
+    const result = await conn.execute(sql, [],
+      { outFormat: oracledb.OUT_FORMAT_JSON, fetchArraySize: 25 });
+    should.ok(Buffer.isBuffer(result.rows));
+    should.strictEqual(result.rows.toString(), expected);
+    should.equal(result.metaData.length, 5);
+  });
+
+  it('265.2 fetches all rows as newline-delimited JSON', async function() {
+    const expected = await getExpectedText(sql);
+    const result = await conn.execute(sql, [],
+      { outFormat: oracledb.OUT_FORMAT_NDJSON });
+    should.ok(Buffer.isBuffer(result.rows));
+    should.strictEqual(result.rows.toString(), toNdjson(expected));
+  });
+
+  it('265.3 writes numbers, dates and booleans as JSON.stringify() does', async function() {
+    const query = `SELECT 0.1 AS a, -1.5e-7 AS b, 1e21 AS c,
+        12345678901234567890 AS d, 1/3 AS e,
+        TIMESTAMP '1999-12-31 23:59:59.123' AS f,
+        TO_BINARY_DOUBLE('NaN') AS g FROM dual`;
+    const expected = await getExpectedText(query);
+    const result = await conn.execute(query, [],
+      { outFormat: oracledb.OUT_FORMAT_JSON });
+    should.strictEqual(result.rows.toString(), expected);
+  });
+
+  it('265.4 honors maxRows and empty results', async function() {
+    let result = await conn.execute(sql, [],
+      { outFormat: oracledb.OUT_FORMAT_JSON, fetchArraySize: 20,
+        maxRows: 45 });
+    should.equal(JSON.parse(result.rows.toString()).length, 45);
+    result = await conn.execute(sql.replace("ORDER BY",
+      "WHERE id < 0 ORDER BY"), [], { outFormat: oracledb.OUT_FORMAT_JSON });
+    should.strictEqual(result.rows.toString(), "[]");
+    result = await conn.execute(sql.replace("ORDER BY",
+      "WHERE id < 0 ORDER BY"), [], { outFormat: oracledb.OUT_FORMAT_NDJSON });
+    should.equal(result.rows.length, 0);
+  });
+
+  it('265.5 fetches batches of JSON text from a ResultSet', async function() {
+    const expected = JSON.parse(await getExpectedText(sql));
+    const result = await conn.execute(sql, [],
+      { outFormat: oracledb.OUT_FORMAT_JSON, resultSet: true });
+    const rs = result.resultSet;
+    should.deepEqual(JSON.parse((await rs.getRows(50)).toString()),
+      expected.slice(0, 50));
+    await should(rs.getRow()).be.rejectedWith(/^NJS-084:/);
+    should.deepEqual(JSON.parse((await rs.getRows()).toString()),
+      expected.slice(50));
+    should.strictEqual((await rs.getRows(10)).toString(), "[]");
+    await rs.close();
+  });
+
+  it('265.6 streams JSON text as Buffers', async function() {
+    for (const outFormat of [oracledb.OUT_FORMAT_JSON,
+      oracledb.OUT_FORMAT_NDJSON]) {
+      const expected = await getExpectedText(sql);
+      const stream = conn.queryStream(sql, [],
+        { outFormat: outFormat, fetchArraySize: 32 });
+      const chunks = [];
+      await new Promise((resolve, reject) => {
+        stream.on('data', chunk => chunks.push(chunk));
+        stream.on('error', reject);
+        stream.on('close', resolve);
+      });
+      should.ok(chunks.every(chunk => Buffer.isBuffer(chunk)));
+      const text = Buffer.concat(chunks).toString();
+      if (outFormat === oracledb.OUT_FORMAT_JSON) {
+        should.strictEqual(text, expected);
+      } else {
+        should.strictEqual(text, toNdjson(expected));
+      }
+    }
+  });
+
+  it('265.7 makes duplicate column names unique', async function() {
+    const result = await conn.execute(
+      "SELECT 1 AS x, 2 AS x FROM dual", [],
+      { outFormat: oracledb.OUT_FORMAT_JSON });
+    should.strictEqual(result.rows.toString(), '[{"X":1,"X_1":2}]');
+  });
+
+  it('265.8 negative - columns that cannot be written as JSON text', async function() {
+    await should(conn.execute("SELECT TO_CLOB('x') FROM dual", [],
+      { outFormat: oracledb.OUT_FORMAT_JSON })).be.rejectedWith(/^NJS-085:/);
+    await should(conn.execute(
+      "SELECT id, CURSOR(SELECT 1 FROM dual) FROM " + tableName, [],
+      { outFormat: oracledb.OUT_FORMAT_NDJSON })).be.rejectedWith(/^NJS-085:/);
+  });
+
+});
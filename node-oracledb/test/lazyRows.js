@@ -0,0 +1,196 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   264. lazyRows.js
+ *
+ * DESCRIPTION
+ *   Test cases for the execute() option lazyRows.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('264. lazyRows.js', function() {
+  let conn = null;
+  const tableName = "nodb_lazyRows";
+  const numRows = 120;
+  const create_table_sql =
+    `BEGIN
+      DECLARE
+        e_table_missing EXCEPTION;
+        PRAGMA EXCEPTION_INIT(e_table_missing, -00942);
+      BEGIN
+        EXECUTE IMMEDIATE ('DROP TABLE ` + tableName + ` PURGE');
+      EXCEPTION
+        WHEN e_table_missing
+        THEN NULL;
+      END;
+      EXECUTE IMMEDIATE ('
+        CREATE TABLE ` + tableName + ` (
+          id NUMBER,
+          name VARCHAR2(20),
+          created DATE,
+          payload RAW(10)
+        )
+      ');
+    END;`;
+  const insertSql =
+    `DECLARE
+       i NUMBER;
+     BEGIN
+       FOR i IN 1..` + numRows + ` LOOP
+         INSERT INTO ` + tableName + ` VALUES (i,
+           CASE WHEN MOD(i, 3) = 0 THEN NULL ELSE 'Name ' || i END,
+           DATE '2021-01-01' + i, HEXTORAW('0A0B'));
+       END LOOP;
+     END;`;
+  const sql = "SELECT id, name, created, payload FROM " + tableName +
+      " ORDER BY id";
+
+  // verifies the row has the expected values
+  function checkRow(row, id, isObject) {
+    const values = (isObject) ?
+      [row.ID, row.NAME, row.CREATED, row.PAYLOAD] :
+      [row[0], row[1], row[2], row[3]];
+    should.equal(values[0], id);
+    should.strictEqual(values[1], (id % 3 === 0) ? null : "Name " + id);
+    should.equal(values[2].getTime(), new Date(2021, 0, 1 + id).getTime());
+    should.deepEqual(values[3], Buffer.from([10, 11]));
+  }
+
+  before(async function() {
+    conn = await oracledb.getConnection(dbconfig);
+    await conn.execute(create_table_sql);
+    await conn.execute(insertSql);
+    await conn.commit();
+  });
+
+  after(async function() {
+    await conn.execute("DROP TABLE " + tableName + " PURGE");
+    await conn.close();
+  });
+
+  it('264.1 returns lazy rows with OUT_FORMAT_ARRAY', async function() {
+    const result = await conn.execute(sql, [],
+      { lazyRows: true, fetchArraySize: 25 });
+    should.equal(result.rows.length, numRows);
+    should.equal(Array.isArray(result.rows[0]), false);
+    should.equal(result.rows[0].length, 4);
+    for (let i = 0; i < numRows; i++) {
+      checkRow(result.rows[i], i + 1, false);
+    }
+  });
+
+  it('264.2 returns lazy rows with OUT_FORMAT_OBJECT', async function() {
+    const result = await conn.execute(sql, [],
+      { lazyRows: true, outFormat: oracledb.OUT_FORMAT_OBJECT });
+    should.equal(result.rows.length, numRows);
+    for (let i = 0; i < numRows; i++) {
+      checkRow(result.rows[i], i + 1, true);
+    }
+  });
+
+  it('264.3 converts lazy rows with toObject() and JSON', async function() {
+    const result = await conn.execute(sql + " FETCH FIRST 2 ROWS ONLY", [],
+      { lazyRows: true, outFormat: oracledb.OUT_FORMAT_OBJECT });
+    const obj = result.rows[1].toObject();
+    should.deepEqual(Object.keys(obj), ["ID", "NAME", "CREATED", "PAYLOAD"]);
+    should.equal(obj.ID, 2);
+    const parsed = JSON.parse(JSON.stringify(result.rows));
+    should.equal(parsed.length, 2);
+    should.equal(parsed[0].NAME, "Name 1");
+    const arrayResult = await conn.execute(sql + " FETCH FIRST 1 ROWS ONLY",
+      [], { lazyRows: true });
+    const values = arrayResult.rows[0].toObject();
+    should.ok(Array.isArray(values));
+    should.equal(values.length, 4);
+  });
+
+  it('264.4 returns lazy rows from a ResultSet', async function() {
+    const result = await conn.execute(sql, [],
+      { lazyRows: true, resultSet: true, outFormat: oracledb.OUT_FORMAT_OBJECT });
+    const rs = result.resultSet;
+    const rows1 = await rs.getRows(50);
+    const row = await rs.getRow();
+    const rows2 = await rs.getRows(30);
+    await rs.close();
+    should.equal(rows1.length, 50);
+    should.equal(rows2.length, 30);
+    for (let i = 0; i < rows1.length; i++) {
+      checkRow(rows1[i], i + 1, true);
+    }
+    checkRow(row, 51, true);
+    for (let i = 0; i < rows2.length; i++) {
+      checkRow(rows2[i], i + 52, true);
+    }
+  });
+
+  it('264.5 values remain available after the connection is closed', async function() {
+    const conn2 = await oracledb.getConnection(dbconfig);
+    const result = await conn2.execute(sql, [], { lazyRows: true });
+    await conn2.close();
+    checkRow(result.rows[numRows - 1], numRows, false);
+  });
+
+  it('264.6 returns regular rows when values cannot be buffered', async function() {
+    const result = await conn.execute(
+      "SELECT id, TO_CLOB(name) FROM " + tableName + " WHERE id = 1", [],
+      { lazyRows: true });
+    should.ok(Array.isArray(result.rows[0]));
+    should.equal(await result.rows[0][1].getData(), "Name 1");
+    await result.rows[0][1].close();
+  });
+
+  it('264.7 streams lazy rows', async function() {
+    const stream = conn.queryStream(sql, [],
+      { lazyRows: true, outFormat: oracledb.OUT_FORMAT_OBJECT });
+    let id = 0;
+    await new Promise((resolve, reject) => {
+      stream.on('data', row => checkRow(row, ++id, true));
+      stream.on('error', reject);
+      stream.on('close', resolve);
+    });
+    should.equal(id, numRows);
+  });
+
+  it('264.8 negative - invalid value for lazyRows', async function() {
+    await should(conn.execute(sql, [], { lazyRows: 1 }))
+      .be.rejectedWith(/^NJS-007:/);
+  });
+
+  it('264.9 lazy rows do not expose internal properties', async function() {
+    const result = await conn.execute(sql + " FETCH FIRST 1 ROWS ONLY", [],
+      { lazyRows: true, outFormat: oracledb.OUT_FORMAT_OBJECT });
+    const row = result.rows[0];
+    should.deepEqual(Object.keys(row), []);
+    should.deepEqual({...row}, {});
+    const keys = [];
+    for (const key in row) {
+      keys.push(key);
+    }
+    should.deepEqual(keys, ["ID", "NAME", "CREATED", "PAYLOAD"]);
+    should.deepEqual(Object.keys(row.toObject()), keys);
+  });
+
+});
@@ -268,4 +268,19 @@ describe('157. maxRows.js', function() {
     );
   }); // 157.8
 
+  it('157.9 maxRows and fetchArraySize around the number of rows', async function() {
+    const values = [1, 50, totalAmount - 1, totalAmount, totalAmount + 1];
+    for (const fetchArraySize of values) {
+      for (const maxRows of [0].concat(values)) {
+        const result = await connection.execute(sqlQuery, [],
+          { fetchArraySize: fetchArraySize, maxRows: maxRows });
+        const expectedAmount = (maxRows > 0) ?
+          Math.min(maxRows, totalAmount) : totalAmount;
+        should.strictEqual(result.rows.length, expectedAmount);
+        should.not.exist(result.resultSet);
+        verifyRows(result.rows, expectedAmount);
+      }
+    }
+  }); // 157.9
+
 });
@@ -0,0 +1,187 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   258. outFormatColumns.js
+ *
+ * DESCRIPTION
+ *   Test cases for fetching rows with outFormat OUT_FORMAT_COLUMNS.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('258. outFormatColumns.js', function() {
+  let conn = null;
+  const tableName = "nodb_outFormatColumns";
+  const numRows = 150;
+  const create_table_sql =
+    `BEGIN
+      DECLARE
+        e_table_missing EXCEPTION;
+        PRAGMA EXCEPTION_INIT(e_table_missing, -00942);
+      BEGIN
+        EXECUTE IMMEDIATE ('DROP TABLE ` + tableName + ` ');
+      EXCEPTION
+        WHEN e_table_missing
+        THEN NULL;
+      END;
+      EXECUTE IMMEDIATE ('
+        CREATE TABLE ` + tableName + ` (
+          id NUMBER,
+          name VARCHAR2(20),
+          created DATE,
+          payload RAW(10)
+        )
+      ');
+    END;`;
+  const insertSql =
+    `DECLARE
+       i NUMBER;
+     BEGIN
+       FOR i IN 1..` + numRows + ` LOOP
+         INSERT INTO ` + tableName + ` VALUES (i,
+           CASE WHEN MOD(i, 3) = 0 THEN NULL ELSE 'Name ' || i END,
+           DATE '2021-01-01' + i, HEXTORAW('0A0B'));
+       END LOOP;
+     END;`;
+  const selectSql = "SELECT id, name, created, payload FROM " + tableName +
+      " ORDER BY id";
+
+  // returns true if the value in the given row of the column is null
+  function isNull(column, row) {
+    return (column.nulls[row >> 3] & (1 << (row & 7))) !== 0;
+  }
+
+  // returns the string value in the given row of the column
+  function getString(column, row) {
+    return column.data.toString('utf8', column.offsets[row],
+      column.offsets[row + 1]);
+  }
+
+  // verifies the columns contain the rows with ids from firstId to lastId
+  function checkColumns(columns, firstId, lastId) {
+    const numColumnRows = lastId - firstId + 1;
+    should.equal(columns.length, 4);
+    should.ok(columns[0].values instanceof Float64Array);
+    should.equal(columns[0].values.length, numColumnRows);
+    should.ok(columns[1].offsets instanceof Uint32Array);
+    should.equal(columns[1].offsets.length, numColumnRows + 1);
+    should.ok(columns[2].values instanceof Float64Array);
+    should.ok(Buffer.isBuffer(columns[3].data));
+    for (let row = 0; row < numColumnRows; row++) {
+      const id = firstId + row;
+      should.equal(columns[0].values[row], id);
+      should.equal(isNull(columns[0], row), false);
+      if (id % 3 === 0) {
+        should.equal(isNull(columns[1], row), true);
+        should.equal(getString(columns[1], row), "");
+      } else {
+        should.equal(isNull(columns[1], row), false);
+        should.equal(getString(columns[1], row), "Name " + id);
+      }
+      should.equal(new Date(columns[2].values[row]).getTime(),
+        new Date(2021, 0, 1 + id).getTime());
+      should.deepEqual(columns[3].data.slice(columns[3].offsets[row],
+        columns[3].offsets[row + 1]), Buffer.from([10, 11]));
+    }
+  }
+
+  before(async function() {
+    conn = await oracledb.getConnection(dbconfig);
+    await conn.execute(create_table_sql);
+    await conn.execute(insertSql);
+    await conn.commit();
+  });
+
+  after(async function() {
+    await conn.execute("DROP TABLE " + tableName + " PURGE");
+    await conn.close();
+  });
+
+  it('258.1 has the expected constant value', function() {
+    should.strictEqual(oracledb.OUT_FORMAT_COLUMNS, 4003);
+  });
+
+  it('258.2 fetches all rows as columns without a ResultSet', async function() {
+    const result = await conn.execute(selectSql, [],
+      { outFormat: oracledb.OUT_FORMAT_COLUMNS });
+    should.equal(result.metaData.length, 4);
+    checkColumns(result.rows, 1, numRows);
+  });
+
+  it('258.3 concatenates batches that are not a multiple of 8 rows', async function() {
+    const result = await conn.execute(selectSql, [],
+      { outFormat: oracledb.OUT_FORMAT_COLUMNS, fetchArraySize: 13 });
+    checkColumns(result.rows, 1, numRows);
+  });
+
+  it('258.4 honors maxRows', async function() {
+    const result = await conn.execute(selectSql, [],
+      { outFormat: oracledb.OUT_FORMAT_COLUMNS, fetchArraySize: 20,
+        maxRows: 45 });
+    checkColumns(result.rows, 1, 45);
+  });
+
+  it('258.5 returns empty columns when no rows are fetched', async function() {
+    const result = await conn.execute(selectSql.replace("ORDER BY",
+      "WHERE id < 0 ORDER BY"), [],
+    { outFormat: oracledb.OUT_FORMAT_COLUMNS });
+    should.equal(result.rows.length, 4);
+    should.equal(result.rows[0].values.length, 0);
+    should.equal(result.rows[1].offsets.length, 1);
+  });
+
+  it('258.6 fetches batches of columns from a ResultSet', async function() {
+    const result = await conn.execute(selectSql, [],
+      { outFormat: oracledb.OUT_FORMAT_COLUMNS, resultSet: true });
+    const rs = result.resultSet;
+    checkColumns(await rs.getRows(50), 1, 50);
+    checkColumns(await rs.getRows(), 51, numRows);
+    await rs.close();
+  });
+
+  it('258.7 returns other types as arrays of values', async function() {
+    const result = await conn.execute(
+      `SELECT TO_CLOB('clob ' || id), CURSOR(SELECT id FROM dual)
+       FROM ` + tableName + ` WHERE id <= 10 ORDER BY id`, [],
+      { outFormat: oracledb.OUT_FORMAT_COLUMNS });
+    should.ok(Array.isArray(result.rows[0].values));
+    should.equal(result.rows[0].values.length, 10);
+    should.equal(await result.rows[0].values[4].getData(), "clob 5");
+    for (const lob of result.rows[0].values)
+      await lob.close();
+    should.equal(result.rows[1].values.length, 10);
+    should.deepEqual(result.rows[1].values[2][0].values,
+      new Float64Array([3]));
+  });
+
+  it('258.8 getRow() is not allowed', async function() {
+    const result = await conn.execute(selectSql, [],
+      { outFormat: oracledb.OUT_FORMAT_COLUMNS, resultSet: true });
+    await should(result.resultSet.getRow()).be.rejectedWith(/^NJS-084:/);
+    should.throws(() => result.resultSet.toQueryStream(), /^NJS-084:/);
+    await result.resultSet.close();
+  });
+
+});
@@ -0,0 +1,131 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   269. poolPriority.js
+ *
+ * DESCRIPTION
+ *   Test cases for the priority and deadline of pool connection requests.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('269. poolPriority.js', function() {
+
+  let pool;
+
+  afterEach(async function() {
+    if (pool) {
+      await pool.close(0);
+      pool = null;
+    }
+  });
+
+  it('269.1 serves higher priorities first and earlier deadlines within a priority', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 1, poolMax: 1,
+      poolIncrement: 0, queueTimeout: 0});
+    const conn = await pool.getConnection();
+    const now = Date.now();
+    const requests = [
+      ["batch1", {}],
+      ["low", {priority: -1}],
+      ["urgentLate", {priority: 5, deadline: now + 20000}],
+      ["urgentEarly", {priority: 5, deadline: new Date(now + 10000)}],
+      ["urgent", {priority: 5}],
+      ["batch2", {}],
+      ["batchDeadline", {deadline: now + 15000}]
+    ];
+    const order = [];
+    const waiters = requests.map(([name, options]) =>
+      pool.getConnection(options).then(async (c) => {
+        order.push(name);
+        await c.close();
+      }));
+    await conn.close();
+    await Promise.all(waiters);
+    should.deepEqual(order, ["urgentEarly", "urgentLate", "urgent",
+      "batchDeadline", "batch1", "batch2", "low"]);
+  });
+
+  it('269.2 rejects a request whose deadline has already passed', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 1, poolMax: 1,
+      poolIncrement: 0, enableStatistics: true});
+    await should(pool.getConnection({deadline: Date.now() - 1000}))
+      .be.rejectedWith(/^NJS-086:/);
+    should.strictEqual(pool.connectionsInUse, 0);
+    should.strictEqual(pool.getStatistics().requestsExpired, 1);
+  });
+
+  it('269.3 drops queued requests when their deadline passes', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 1, poolMax: 1,
+      poolIncrement: 0, queueTimeout: 0, enableStatistics: true});
+    const conn = await pool.getConnection();
+    const expiring = pool.getConnection({priority: 1,
+      deadline: Date.now() + 200});
+    const waiting = pool.getConnection();
+    await should(expiring).be.rejectedWith(/^NJS-086:/);
+    should.strictEqual(pool._connRequestQueue.length, 1);
+    await conn.close();
+    const c = await waiting;
+    await c.close();
+    const stats = pool.getStatistics();
+    should.strictEqual(stats.requestsExpired, 1);
+    should.strictEqual(stats.requestTimeouts, 0);
+  });
+
+  it('269.4 breaks down the statistics by priority', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 1, poolMax: 1,
+      poolIncrement: 0, queueTimeout: 0, enableStatistics: true});
+    const conn = await pool.getConnection();
+    const waiters = [
+      pool.getConnection({priority: 2}),
+      pool.getConnection({priority: 2}),
+      pool.getConnection()
+    ].map(p => p.then(c => c.close()));
+    await conn.close();
+    await Promise.all(waiters);
+    const classes = pool.getStatistics().priorityClasses;
+    should.deepEqual(classes.map(c => c.priority), [2, 0]);
+    should.strictEqual(classes[0].connectionRequests, 2);
+    should.strictEqual(classes[0].requestsEnqueued, 2);
+    should.strictEqual(classes[0].requestsDequeued, 2);
+    should.strictEqual(classes[1].connectionRequests, 2);
+    should.strictEqual(classes[1].requestsEnqueued, 1);
+    should.strictEqual(classes[1].requestsDequeued, 1);
+  });
+
+  it('269.5 negative - invalid priority and deadline values', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 0, poolMax: 1,
+      poolIncrement: 1});
+    await should(pool.getConnection({priority: 1.5}))
+      .be.rejectedWith(/^NJS-007:/);
+    await should(pool.getConnection({priority: "high"}))
+      .be.rejectedWith(/^NJS-007:/);
+    await should(pool.getConnection({deadline: "soon"}))
+      .be.rejectedWith(/^NJS-007:/);
+    await should(pool.getConnection({deadline: new Date("x")}))
+      .be.rejectedWith(/^NJS-007:/);
+  });
+
+});
@@ -0,0 +1,147 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   268. poolRequestQueue.js
+ *
+ * DESCRIPTION
+ *   Test cases for the queue of requests waiting for a pooled connection.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('268. poolRequestQueue.js', function() {
+
+  let pool;
+
+  afterEach(async function() {
+    if (pool) {
+      await pool.close(0);
+      pool = null;
+    }
+  });
+
+  it('268.1 serves waiting requests in order', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 1, poolMax: 1,
+      poolIncrement: 0, queueTimeout: 0});
+    const conn = await pool.getConnection();
+    const order = [];
+    const waiters = [];
+    for (let i = 0; i < 5; i++) {
+      waiters.push(pool.getConnection().then(async (c) => {
+        order.push(i);
+        await c.close();
+      }));
+    }
+    should.strictEqual(pool._connRequestQueue.length, 5);
+    await conn.close();
+    await Promise.all(waiters);
+    should.deepEqual(order, [0, 1, 2, 3, 4]);
+  });
+
+  it('268.2 a released connection is handed to the waiting request', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 1, poolMax: 1,
+      poolIncrement: 0, queueTimeout: 0});
+    const conn = await pool.getConnection();
+    const order = [];
+    const waiter = pool.getConnection().then(async (c) => {
+      order.push("waiter");
+      await c.close();
+    });
+    await conn.close();
+    const late = pool.getConnection().then(async (c) => {
+      order.push("late");
+      await c.close();
+    });
+    await Promise.all([waiter, late]);
+    should.deepEqual(order, ["waiter", "late"]);
+  });
+
+  it('268.3 expires many waiting requests', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 1, poolMax: 1,
+      poolIncrement: 0, queueTimeout: 200, queueMax: -1,
+      enableStatistics: true});
+    const conn = await pool.getConnection();
+    const results = await Promise.allSettled(Array.from({length: 2000},
+      () => pool.getConnection()));
+    for (const result of results) {
+      should.strictEqual(result.status, "rejected");
+      should(result.reason.message).startWith("NJS-040:");
+    }
+    should.strictEqual(pool._connRequestQueue.length, 0);
+    should.strictEqual(pool.getStatistics().requestTimeouts, 2000);
+    await conn.close();
+  });
+
+  it('268.4 requests queued before reconfigure() keep their timeout', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 1, poolMax: 1,
+      poolIncrement: 0, queueTimeout: 3000});
+    const conn = await pool.getConnection();
+    const start = Date.now();
+    const first = pool.getConnection().catch(() => Date.now() - start);
+    await pool.reconfigure({queueTimeout: 100});
+    const second = pool.getConnection().catch(() => Date.now() - start);
+    should.ok(await second < 2000);
+    await conn.close();
+    const c = await first;
+    await c.close();
+  });
+
+  it('268.5 close() with a drain time rejects waiting requests', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 1, poolMax: 1,
+      poolIncrement: 0, queueTimeout: 0});
+    const conn = await pool.getConnection();
+    const waiters = Array.from({length: 3}, () => pool.getConnection());
+    const closing = pool.close(5);
+    const results = await Promise.allSettled(waiters);
+    for (const result of results) {
+      should.strictEqual(result.status, "rejected");
+      should(result.reason.message).startWith("NJS-064:");
+    }
+    should.strictEqual(pool._connRequestQueue.length, 0);
+    const start = Date.now();
+    await conn.close();
+    await closing;
+    should.ok(Date.now() - start < 2000);
+    pool = null;
+  });
+
+  it('268.6 a connection handed to a request is returned when draining', async function() {
+    pool = await oracledb.createPool({...dbconfig, poolMin: 1, poolMax: 1,
+      poolIncrement: 0, queueTimeout: 0});
+    const conn = await pool.getConnection();
+    const waiter = pool.getConnection();
+    let closing;
+    conn.on('_afterConnClose', () => {
+      closing = pool.close(5);
+    });
+    const start = Date.now();
+    await conn.close();
+    await should(waiter).be.rejectedWith(/^NJS-064:/);
+    await closing;
+    should.ok(Date.now() - start < 2000);
+    pool = null;
+  });
+
+});
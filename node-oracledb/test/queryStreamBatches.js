@@ -0,0 +1,131 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved. */
+
+/******************************************************************************
+ *
+ * You may not use the identified files except in compliance with the Apache
+ * License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The node-oracledb test suite uses 'mocha', 'should' and 'async'.
+ * See LICENSE.md for relevant licenses.
+ *
+ * NAME
+ *   261. queryStreamBatches.js
+ *
+ * DESCRIPTION
+ *   Test cases for the QueryStream options emitBatches and highWaterMark.
+ *
+ *****************************************************************************/
+'use strict';
+
+const oracledb = require('oracledb');
+const should   = require('should');
+const dbconfig = require('./dbconfig.js');
+
+describe('261. queryStreamBatches.js', function() {
+  let conn = null;
+  const numRows = 1050;
+  const sql = "SELECT level FROM dual CONNECT BY level <= :n";
+
+  // consumes the stream and returns the chunks that were emitted
+  function getChunks(stream) {
+    return new Promise((resolve, reject) => {
+      const chunks = [];
+      stream.on('data', chunk => chunks.push(chunk));
+      stream.on('error', reject);
+      stream.on('end', () => resolve(chunks));
+    });
+  }
+
+  before(async function() {
+    conn = await oracledb.getConnection(dbconfig);
+  });
+
+  after(async function() {
+    await conn.close();
+  });
+
+  it('261.1 streams rows one at a time by default', async function() {
+    const stream = conn.queryStream(sql, [numRows], { fetchArraySize: 100 });
+    const chunks = await getChunks(stream);
+    should.equal(chunks.length, numRows);
+    for (let i = 0; i < numRows; i++) {
+      should.deepEqual(chunks[i], [i + 1]);
+    }
+  });
+
+  it('261.2 streams arrays of rows with emitBatches', async function() {
+    const stream = conn.queryStream(sql, [numRows],
+      { fetchArraySize: 100, emitBatches: true });
+    const chunks = await getChunks(stream);
+    should.equal(chunks.length, 11);
+    for (let i = 0; i < chunks.length; i++) {
+      should.equal(chunks[i].length, (i < 10) ? 100 : 50);
+      should.deepEqual(chunks[i][0], [i * 100 + 1]);
+    }
+  });
+
+  it('261.3 streams no chunks for a query without rows', async function() {
+    const stream = conn.queryStream(sql, [0], { emitBatches: true });
+    const chunks = await getChunks(stream);
+    should.equal(chunks.length, 0);
+  });
+
+  it('261.4 counts batches with highWaterMark', async function() {
+    const stream = conn.queryStream(sql, [numRows],
+      { fetchArraySize: 50, emitBatches: true, highWaterMark: 3 });
+    await new Promise(resolve => stream.once('readable', resolve));
+    await new Promise(resolve => setTimeout(resolve, 500));
+    should.equal(stream.readableHighWaterMark, 3);
+    should.equal(stream.readableLength, 3);
+    const chunks = await getChunks(stream);
+    should.equal(chunks.length, 21);
+  });
+
+  it('261.5 supports options with toQueryStream()', async function() {
+    const result = await conn.execute(sql, [numRows],
+      { fetchArraySize: 300, resultSet: true });
+    const stream = result.resultSet.toQueryStream({ emitBatches: true });
+    const chunks = await getChunks(stream);
+    should.deepEqual(chunks.map(chunk => chunk.length), [300, 300, 300, 150]);
+  });
+
+  it('261.6 negative - invalid options', function() {
+    should.throws(() => conn.queryStream(sql, [1], { emitBatches: 1 }),
+      /^NJS-007: invalid value for "emitBatches" in parameter 3$/);
+    should.throws(() => conn.queryStream(sql, [1], { highWaterMark: -1 }),
+      /^NJS-007: invalid value for "highWaterMark" in parameter 3$/);
+  });
+
+  it('261.7 negative - invalid options with toQueryStream()', async function() {
+    const result = await conn.execute(sql, [1], { resultSet: true });
+    const rs = result.resultSet;
+    should.throws(() => rs.toQueryStream({ highWaterMark: "1" }),
+      /^NJS-007: invalid value for "highWaterMark" in parameter 1$/);
+    should.throws(() => rs.toQueryStream(1), /^NJS-005:/);
+    await rs.close();
+  });
+
+  it('261.8 buffers no more rows than highWaterMark', async function() {
+    const stream = conn.queryStream(sql, [numRows],
+      { fetchArraySize: 100, highWaterMark: 10 });
+    await new Promise(resolve => stream.once('readable', resolve));
+    await new Promise(resolve => setTimeout(resolve, 500));
+    should.equal(stream.readableLength, 10);
+    const chunks = await getChunks(stream);
+    should.equal(chunks.length, numRows);
+    for (let i = 0; i < numRows; i++) {
+      should.deepEqual(chunks[i], [i + 1]);
+    }
+  });
+
+});